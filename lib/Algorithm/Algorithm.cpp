@@ -1,236 +1,975 @@
-
-#include <Ticker.h>  //https://github.com/sstaub/Ticker  (version 3.1.5 was used)
-#include <EEPROM.h> 
-#include "Algorithm.h"
-#include "LimitSwitch.h"
-#include "StepperControl.h"
-#include "ServoControl.h"
-#include "Common.h"
-
-bool Algorithm::_isServoUpTimeLimitReached;  //this is a static variable (Ticker needs this variable to be static)
-bool Algorithm::_isServoDownTimeLimitReached;  //this is a static variable (Ticker needs this variable to be static)
-
-LimitSwitch limitSwitch; 
-Ticker servoUpTimer(Algorithm::handleServoUpTimeLimit, SERVO_UP_WAIT_TIME_MS, 1, MILLIS); 
-Ticker servoDownTimer(Algorithm::handleServoDownTimeLimit, SERVO_DOWN_WAIT_TIME_MS, 1, MILLIS); 
-
-/*****************************************************************************/
-/**
- * @brief   Initializations are done here. This function should only be called
- *          once when the microcontroller boots (call in setup). Gives class
- *          scope to the first, second, and third position variables. 
- * @param pFirstPosition  Points to the firstPosition (in main file)
- * @param pSecondPosition Points to the secondPosition (in main file)
- * @param pThirdPosition  Points to the thirdPosition (in main file)
- */
-/*****************************************************************************/
-void Algorithm::init(char* pFirstPosition, char* pSecondPosition, char* pThirdPosition) {  
-  _pFirstPosition = pFirstPosition;
-  _pSecondPosition = pSecondPosition;
-  _pThirdPosition = pThirdPosition;  
-  limitSwitch.init();     
-  reconfig(); 
-}
-
-/*****************************************************************************/
-/**
- * @brief   Similar to init(), but only reconfigures variables and/or states 
- *          that need to be. This function can be used any time after the 
- *          program has been initialized with the init() function. This
- *          function is intended to be used when retarting the program 
- *          without power-cycling.  
- */
-/*****************************************************************************/
-void Algorithm::reconfig() {
-    _currentCommand = AlgorithmCommand::setNextValidCombination;
-    _previousCommand = AlgorithmCommand::none; 
-    Algorithm::_isServoUpTimeLimitReached = false;
-    Algorithm::_isServoDownTimeLimitReached = false; 
-    _firstZone = EEPROM.read(FIRST_ZONE_EEPROM_ADDRESS);  
-    servoUpTimer.stop(); 
-    servoDownTimer.stop();     
-}
-
-/*****************************************************************************/
-/**
- * @brief   This is a callback function for the servoUpTimer object. When this
- *          function is called, _isServoDownTimeLimitReached is assigned true.   
- */
-/*****************************************************************************/
-void Algorithm::handleServoUpTimeLimit() {
-  Algorithm::_isServoUpTimeLimitReached = true;    
-}
-
-/*****************************************************************************/
-/**
- * @brief   This is a callback function for the servoDownTimer object. When 
- *          this function is called, _isServoDownTimeLimitReached is assigned
- *          true.   
- */
-/*****************************************************************************/
-void Algorithm::handleServoDownTimeLimit() {
-  Algorithm::_isServoDownTimeLimitReached = true;    
-}
-
-/*****************************************************************************/
-/**
- * @brief   Runs an algorithm that tries to open a combination lock by trying
- *          every possible combination until it finds the correct one. The
- *          servo motor and the stepper motor are controlled here. The
- *          limit switch is used to detect when the lock is opened. 
- * @note    The algorithm should only be run if the limit switch is released. 
- * @param   ptrFirstPos The first position is passed in so that it can be
- *          assigned a new value and updated to the main file when necessary. 
- * @param   ptrSecondPos    The second position is passed in so that it can
- *          be assigned a new value and updated to the main file when 
- *          necessary. 
- * @param   ptrThirdPos The third position is passed in so that it can be
- *          assigned a new value and updated to the main file when necessary.  
- * @param   ptrAttemptsCounter  The attempts counter is passed in so that it
- *          can be assigned a new value and updated to the main file when 
- *          necessary. 
- * @returns Returns the current state of the algorithm. 
- *          Options: 
- *          AlgorithmState::running -> the algorithm is still running 
- *          AlgorithmState::error -> all combinations have been tried
- *              without successfully opening the combination lock
- *          AlgorithmState::complete -> the combination lock has been
- *              opened (limit swith activated). 
- */
-/*****************************************************************************/
-AlgorithmState Algorithm::run(unsigned int* pAttemptsCounter) {   
-  switch(_currentCommand) {
-    case AlgorithmCommand::setNextValidCombination:   
-      if(setNextValidCombination() == ALL_COMBINATIONS_TRIED) {
-        return AlgorithmState::error; 
-      }
-      else {
-        //Detects when the dial needs to be reset (rotateClockwiseTwice). This will happen when the program has just started and when the third position rolls over to _firstZone value.
-        //The reason there is an OR condition is because when *_pSecondPosition is equal to _firstZone, *_pThirdPosition will skip _firstZone. The OR condition makes sure that the 
-        //rollover is still detected. 
-        if((*_pThirdPosition == _firstZone) || (*_pSecondPosition == _firstZone && *_pThirdPosition == (_firstZone + ZONE_OFFSET))) {   
-          _currentCommand = AlgorithmCommand::rotateClockwiseTwice; 
-        }
-        else {
-          _currentCommand = AlgorithmCommand::goToThirdPosition; 
-        }
-      }
-      _previousCommand = AlgorithmCommand::setNextValidCombination;  
-      break;
-
-    case AlgorithmCommand::rotateClockwiseTwice:    
-      if(stepperControl.rotateClockwiseTwice() == StepperState::complete) {    
-        _currentCommand = AlgorithmCommand::goToFirstPosition;  
-      }
-      _previousCommand = AlgorithmCommand::rotateClockwiseTwice;
-      break;
-
-    case AlgorithmCommand::goToFirstPosition:           
-      if(stepperControl.goToFirstPosition(*_pFirstPosition) == StepperState::complete) {
-        _currentCommand = AlgorithmCommand::rotateCounterclockwiseOnce;   
-      }
-      _previousCommand = AlgorithmCommand::goToFirstPosition; 
-      break;
-
-    case AlgorithmCommand::rotateCounterclockwiseOnce:    
-      if(stepperControl.rotateCounterclockwiseOnce() == StepperState::complete) {
-        _currentCommand = AlgorithmCommand::goToSecondPosition;   
-      }
-      _previousCommand = AlgorithmCommand::rotateCounterclockwiseOnce; 
-      break;
-
-    case AlgorithmCommand::goToSecondPosition:
-      if(stepperControl.goToSecondPosition(*_pSecondPosition) == StepperState::complete) {
-        _currentCommand = AlgorithmCommand::goToThirdPosition;   
-      }
-      _previousCommand = AlgorithmCommand::goToSecondPosition;  
-      break;
-      
-    case AlgorithmCommand::goToThirdPosition:         
-      if(stepperControl.goToThirdPosition(*_pThirdPosition) == StepperState::complete) {
-        _currentCommand = AlgorithmCommand::servoUp;      
-      }
-      _previousCommand = AlgorithmCommand::goToThirdPosition; 
-      break;
-
-    case AlgorithmCommand::servoUp:
-      servoUpTimer.update(); 
-      if(_previousCommand == AlgorithmCommand::goToThirdPosition) {
-        (*pAttemptsCounter)++; 
-        servoUpTimer.start(); 
-        servoControl.moveTopPosition(); 
-      }
-      else if(Algorithm::_isServoUpTimeLimitReached == true && _previousCommand == AlgorithmCommand::servoUp) {
-        Algorithm::_isServoUpTimeLimitReached = false; 
-        servoUpTimer.stop(); 
-        _currentCommand = AlgorithmCommand::servoDown; 
-      }       
-      if(limitSwitch.getState() == LIMIT_SWITCH_ACTIVATED) {
-        servoUpTimer.stop(); 
-        return AlgorithmState::complete; 
-      } 
-      _previousCommand = AlgorithmCommand::servoUp; 
-      break;
-
-    case AlgorithmCommand::servoDown: 
-      servoDownTimer.update(); 
-      if(_previousCommand == AlgorithmCommand::servoUp) {
-        servoDownTimer.start(); 
-        servoControl.moveBottomPosition(); 
-      }
-      else if(Algorithm::_isServoDownTimeLimitReached == true && _previousCommand == AlgorithmCommand::servoDown) {
-        Algorithm::_isServoDownTimeLimitReached = false;
-        servoDownTimer.stop(); 
-        _currentCommand = AlgorithmCommand::setNextValidCombination; 
-      }
-      _previousCommand = AlgorithmCommand::servoDown; 
-      break; 
-  }    
-  return AlgorithmState::running;  
-}
-
-/*****************************************************************************/
-/**
- * @brief Sets the next valid combination sequence. If all combinations have 
- *        been tried, do not increment anymore and keep the values for the 
- *        first, second and third positions set to the last valid combination
- *        sequence.
- * @note  This function uses *_pFirstPosition, *_pSecondPosition, and
- *        *_pThirdPosition to modify first, second, and third position
- *        variables found in the main file. 
- * @returns   Returns ALL_COMBINATIONS_TRIED or NEW_COMBINATION_SET 
- */
-/*****************************************************************************/
-bool Algorithm::setNextValidCombination() {
-  while(1) {
-    if(*_pFirstPosition == NO_POSITION_ASSIGNED) {
-      *_pFirstPosition = _firstZone;  
-      *_pSecondPosition = _firstZone; 
-      *_pThirdPosition = _firstZone; 
-    }
-    else {
-      *_pThirdPosition += ZONE_OFFSET; 
-      if(*_pThirdPosition >= NUMBER_OF_POSITIONS) {
-        *_pThirdPosition = _firstZone; 
-        *_pSecondPosition += ZONE_OFFSET;
-        if(*_pSecondPosition >= NUMBER_OF_POSITIONS) {
-          *_pSecondPosition = _firstZone; 
-          *_pFirstPosition += ZONE_OFFSET; 
-          if(*_pFirstPosition >= NUMBER_OF_POSITIONS) {
-            //assigns the last valid combination (remember that first/third positions cannot be the same as the second position) so that values don't keep incrementing
-            *_pFirstPosition = _firstZone + ((NUMBER_OF_ZONES - 1)*(ZONE_OFFSET));    
-            *_pSecondPosition = _firstZone + ((NUMBER_OF_ZONES - 2)*(ZONE_OFFSET));  
-            *_pThirdPosition = _firstZone + ((NUMBER_OF_ZONES - 1)*(ZONE_OFFSET));
-            return ALL_COMBINATIONS_TRIED; 
-          }
-        }
-      }
-      if(*_pFirstPosition != *_pSecondPosition && *_pSecondPosition != *_pThirdPosition) {
-        return NEW_COMBINATION_SET;
-      }  
-    } 
-  } 
-}
-
-
-
+
+#include <Arduino.h>
+#include <EEPROM.h> 
+#include "Algorithm.h"
+#include "LimitSwitch.h"
+#include "StepperControl.h"
+#include "ServoControl.h"
+#include "Telemetry.h"
+#include "Profiler.h"
+#include "FlightRecorder.h"
+#include "Common.h"
+
+//the zone-center pass comes first, then the zones are shifted by half a zone, then the zone width is halved
+const SearchPass searchPasses[NUMBER_OF_SEARCH_PASSES] = {
+  {0, ZONE_OFFSET}, 
+  {ZONE_OFFSET / 2, ZONE_OFFSET}, 
+  {0, ZONE_OFFSET / 2}
+}; 
+
+/*****************************************************************************/
+/**
+ * @brief   Initializations are done here. This function should only be called
+ *          once when the microcontroller boots (call in setup). Gives class
+ *          scope to the motors of this channel and to the first, second, and 
+ *          third position variables. 
+ * @param channel         The channel that this algorithm runs (see ChannelPins.h)
+ * @param pStepperControl Points to the channel's stepper motor (in main file)
+ * @param pServoControl   Points to the channel's servo motor (in main file)
+ * @param limitSwitchPin  The channel's limit switch pin (see ChannelPins.h)
+ * @param pFirstPosition  Points to the firstPosition (in main file)
+ * @param pSecondPosition Points to the secondPosition (in main file)
+ * @param pThirdPosition  Points to the thirdPosition (in main file)
+ */
+/*****************************************************************************/
+void Algorithm::init(unsigned char channel, StepperControl* pStepperControl, ServoControl* pServoControl, uint8_t limitSwitchPin, char* pFirstPosition, char* pSecondPosition, char* pThirdPosition) {  
+  _channel = channel; 
+  _pStepperControl = pStepperControl; 
+  _pServoControl = pServoControl; 
+  _pFirstPosition = pFirstPosition;
+  _pSecondPosition = pSecondPosition;
+  _pThirdPosition = pThirdPosition;  
+  _dialSequenceMode = DEFAULT_DIAL_SEQUENCE_MODE; 
+  _isProgressiveSearchEnabled = DEFAULT_PROGRESSIVE_SEARCH; 
+  _isRefinementEnabled = DEFAULT_COMBINATION_REFINEMENT; 
+  _limitSwitch.init(limitSwitchPin);     
+  reconfig(); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Similar to init(), but only reconfigures variables and/or states 
+ *          that need to be. This function can be used any time after the 
+ *          program has been initialized with the init() function. This
+ *          function is intended to be used when retarting the program 
+ *          without power-cycling.  
+ */
+/*****************************************************************************/
+void Algorithm::reconfig() {
+#ifdef INDEX_SENSOR
+    _currentCommand = AlgorithmCommand::homeToIndex;   //the dial is homed before the first combination is set
+#else
+    _currentCommand = AlgorithmCommand::setNextValidCombination;
+#endif
+    _previousCommand = AlgorithmCommand::none; 
+    _isServoMoving = false; 
+    _isHolding = false; 
+    _savedFirstZone = EEPROM.read(FIRST_ZONE_EEPROM_ADDRESS);  
+    _firstZone = _savedFirstZone; 
+    _zoneWidth = ZONE_OFFSET; 
+    _searchPass = 0; 
+    _plannedAttempts = countSearchPassCombinations(); 
+    startCountingNextPass(); 
+    _averageTravelMs = 0; 
+    _averageDwellMs = 0; 
+    _dialModel.reset(); 
+    _combinationOrder = CombinationOrder::odometer; 
+    _priorHistogram.load(NO_LOCK_PROFILE); 
+    memset(_triedCombinations, 0, sizeof(_triedCombinations)); 
+    _expectedAttempts = 0; 
+    _isExpectedAttemptsDone = true; 
+    _lockId = NO_LOCK_ID; 
+    _isFastOpenPending = false; 
+    _isFastOpenAttempt = false; 
+    _isRefining = false; 
+    _isProbePending = false; 
+    _seekAttemptNumber = 0; 
+    _isDialResetNeeded = false; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Runs an algorithm that tries to open a combination lock by trying
+ *          every possible combination until it finds the correct one. The
+ *          servo motor and the stepper motor are controlled here. The
+ *          limit switch is used to detect when the lock is opened. 
+ * @note    The algorithm should only be run if the limit switch is released. 
+ * @param   ptrFirstPos The first position is passed in so that it can be
+ *          assigned a new value and updated to the main file when necessary. 
+ * @param   ptrSecondPos    The second position is passed in so that it can
+ *          be assigned a new value and updated to the main file when 
+ *          necessary. 
+ * @param   ptrThirdPos The third position is passed in so that it can be
+ *          assigned a new value and updated to the main file when necessary.  
+ * @param   ptrAttemptsCounter  The attempts counter is passed in so that it
+ *          can be assigned a new value and updated to the main file when 
+ *          necessary. 
+ * @returns Returns the current state of the algorithm. 
+ *          Options: 
+ *          AlgorithmState::running -> the algorithm is still running 
+ *          AlgorithmState::error -> all combinations have been tried
+ *              without successfully opening the combination lock
+ *          AlgorithmState::complete -> the combination lock has been
+ *              opened (limit swith activated). 
+ */
+/*****************************************************************************/
+AlgorithmState Algorithm::run(unsigned int* pAttemptsCounter) {   
+  PROFILE_SCOPE(ProfileSection::algorithmRun); 
+  if(isDwelling()) {
+    calculateExpectedAttempts();   //a part of each, while the dial isn't moving
+    countNextPassCombinations(); 
+  }
+  AlgorithmCommand startCommand = _currentCommand;   //the flight recorder only records the changes
+  switch(_currentCommand) {
+#ifdef INDEX_SENSOR
+    case AlgorithmCommand::homeToIndex:   //only channel 0 has a sensor, the other channels don't find the index and start right away
+      if(_pStepperControl->homeToIndex() != StepperState::incomplete) {   //if the index isn't found, the dial is assumed to be at zero (as without the sensor)
+        _dialModel.setCamStep(_pStepperControl->getCurrentStep()); 
+        _currentCommand = AlgorithmCommand::setNextValidCombination; 
+      }
+      _previousCommand = AlgorithmCommand::homeToIndex; 
+      break; 
+#endif
+
+    case AlgorithmCommand::setNextValidCombination: {  
+      _attemptStartMs = millis(); 
+      if(_isRefining) {
+        //the refinement stops early if the shackle didn't close again (the positions that have been refined so far are kept) 
+        bool limitSwitchState = _limitSwitch.getState(); 
+        telemetry.updateLimitSwitch(_channel, limitSwitchState); 
+        flightRecorder.updateLimitSwitch(_channel, limitSwitchState); 
+        if(limitSwitchState == LIMIT_SWITCH_ACTIVATED || !setNextRefinementProbe()) {
+          _isRefining = false; 
+          *_pFirstPosition = _refinedPositions[0]; 
+          *_pSecondPosition = _refinedPositions[1]; 
+          *_pThirdPosition = _refinedPositions[2]; 
+          saveOpenedCombination(); 
+          flightRecorder.record(FlightEventSource::result, (unsigned char)AlgorithmState::complete, _channel, _pStepperControl->getCurrentStep()); 
+          return AlgorithmState::complete; 
+        }
+        if(_dialSequenceMode == DialSequenceMode::shortestManeuver && _dialModel.planManeuver(*_pFirstPosition, *_pSecondPosition, *_pThirdPosition, &_maneuver)) {
+          _maneuverMoveIndex = 0; 
+          _currentCommand = AlgorithmCommand::followManeuver; 
+        }
+        else {
+          _currentCommand = AlgorithmCommand::rotateClockwiseTwice; 
+        }
+        telemetry.sendAttemptStart(_channel, *pAttemptsCounter, *_pFirstPosition, *_pSecondPosition, *_pThirdPosition, TelemetryAttemptKind::refinementProbe, _pStepperControl->getStepCount()); 
+        _previousCommand = AlgorithmCommand::setNextValidCombination; 
+        break; 
+      }
+      if(_isFastOpenPending) {   //the cached combination is tried first. The dial is reset because the wheel pack state is unknown. 
+        _isFastOpenPending = false; 
+        _isFastOpenAttempt = true; 
+        *_pFirstPosition = _cachedFirstPosition; 
+        *_pSecondPosition = _cachedSecondPosition; 
+        *_pThirdPosition = _cachedThirdPosition; 
+        _currentCommand = AlgorithmCommand::rotateClockwiseTwice; 
+        telemetry.sendAttemptStart(_channel, *pAttemptsCounter, *_pFirstPosition, *_pSecondPosition, *_pThirdPosition, TelemetryAttemptKind::fastOpen, _pStepperControl->getStepCount()); 
+        _previousCommand = AlgorithmCommand::setNextValidCombination; 
+        break; 
+      }
+      if(_isFastOpenAttempt) {   //the cached combination didn't open the lock, so the full search starts from the beginning
+        _isFastOpenAttempt = false; 
+        *_pFirstPosition = NO_POSITION_ASSIGNED; 
+        *_pSecondPosition = NO_POSITION_ASSIGNED; 
+        *_pThirdPosition = NO_POSITION_ASSIGNED; 
+      }
+      char previousFirstPosition = *_pFirstPosition; 
+      char previousSecondPosition = *_pSecondPosition; 
+      bool isCombinationSet = (setNextValidCombination() == NEW_COMBINATION_SET); 
+      while(!isCombinationSet && startNextSearchPass()) {
+        isCombinationSet = (setNextValidCombination() == NEW_COMBINATION_SET); 
+      }
+      if(!isCombinationSet) {
+        flightRecorder.record(FlightEventSource::result, (unsigned char)AlgorithmState::error, _channel, _pStepperControl->getCurrentStep()); 
+        flightRecorder.save();   //so that the events can still be read after a reset
+        return AlgorithmState::error; 
+      }
+      else if(*pAttemptsCounter + 1 < _seekAttemptNumber) {   //skipped (see seekAttempt()), one combination per call so that the main loop isn't held up
+        (*pAttemptsCounter)++; 
+        _isDialResetNeeded = true;   //the dial is still at the last combination that was dialed
+        break; 
+      }
+      _seekAttemptNumber = 0; 
+      if(_dialSequenceMode == DialSequenceMode::shortestManeuver && _dialModel.planManeuver(*_pFirstPosition, *_pSecondPosition, *_pThirdPosition, &_maneuver)) {
+        _maneuverMoveIndex = 0; 
+        _currentCommand = AlgorithmCommand::followManeuver; 
+        _isDialResetNeeded = false;   //the dial model knows where the wheels are
+      }
+      else {
+        //Detects when the dial needs to be reset (rotateClockwiseTwice). This will happen when the program has just started and whenever the first or second position changes 
+        //(in odometer order, this is when the third position rolls over). Comparing with the previous combination still works when combinations are skipped because an 
+        //earlier search pass already covered them. 
+        if(*_pFirstPosition != previousFirstPosition || *_pSecondPosition != previousSecondPosition || _isDialResetNeeded) {   
+          _currentCommand = AlgorithmCommand::rotateClockwiseTwice; 
+          _isDialResetNeeded = false; 
+        }
+        else {
+          _currentCommand = AlgorithmCommand::goToThirdPosition; 
+        }
+      }
+      telemetry.sendAttemptStart(_channel, *pAttemptsCounter, *_pFirstPosition, *_pSecondPosition, *_pThirdPosition, TelemetryAttemptKind::search, _pStepperControl->getStepCount()); 
+      _previousCommand = AlgorithmCommand::setNextValidCombination;  
+      break;
+    }
+
+    case AlgorithmCommand::rotateClockwiseTwice:    
+      if(_pStepperControl->rotateClockwiseTwice() == StepperState::complete) {    
+        _dialModel.rotate(StepperDirection::clockwise, 2*NUMBER_OF_STEPS); 
+#ifdef INDEX_SENSOR
+        _dialModel.setCamStep(_pStepperControl->getCurrentStep());   //the drift may have been corrected when the flag passed the sensor
+#endif
+        _currentCommand = AlgorithmCommand::goToFirstPosition;  
+      }
+      _previousCommand = AlgorithmCommand::rotateClockwiseTwice;
+      break;
+
+    case AlgorithmCommand::goToFirstPosition:           
+      if(_pStepperControl->goToFirstPosition(*_pFirstPosition) == StepperState::complete) {
+        _dialModel.rotateTo(StepperDirection::clockwise, DialModel::positionToStep(*_pFirstPosition)); 
+        _currentCommand = AlgorithmCommand::rotateCounterclockwiseOnce;   
+      }
+      _previousCommand = AlgorithmCommand::goToFirstPosition; 
+      break;
+
+    case AlgorithmCommand::rotateCounterclockwiseOnce:    
+      if(_pStepperControl->rotateCounterclockwiseOnce() == StepperState::complete) {
+        _dialModel.rotate(StepperDirection::counterclockwise, NUMBER_OF_STEPS); 
+        _currentCommand = AlgorithmCommand::goToSecondPosition;   
+      }
+      _previousCommand = AlgorithmCommand::rotateCounterclockwiseOnce; 
+      break;
+
+    case AlgorithmCommand::goToSecondPosition:
+      if(_pStepperControl->goToSecondPosition(*_pSecondPosition) == StepperState::complete) {
+        _dialModel.rotateTo(StepperDirection::counterclockwise, DialModel::positionToStep(*_pSecondPosition)); 
+        _currentCommand = AlgorithmCommand::goToThirdPosition;   
+      }
+      _previousCommand = AlgorithmCommand::goToSecondPosition;  
+      break;
+      
+    case AlgorithmCommand::goToThirdPosition:         
+      if(_pStepperControl->goToThirdPosition(*_pThirdPosition) == StepperState::complete) {
+        _dialModel.rotateTo(StepperDirection::clockwise, DialModel::positionToStep(*_pThirdPosition)); 
+        _currentCommand = AlgorithmCommand::servoUp;      
+      }
+      _previousCommand = AlgorithmCommand::goToThirdPosition; 
+      break;
+
+    case AlgorithmCommand::followManeuver:   //planned by the dial model, replaces the goTo sequence when only the second and/or third positions change
+      if(_maneuverMoveIndex >= _maneuver.numberOfMoves) {
+        _currentCommand = AlgorithmCommand::servoUp; 
+      }
+      else if(_pStepperControl->rotateSteps(_maneuver.moves[_maneuverMoveIndex].direction, _maneuver.moves[_maneuverMoveIndex].steps) == StepperState::complete) {
+        _dialModel.rotate(_maneuver.moves[_maneuverMoveIndex].direction, _maneuver.moves[_maneuverMoveIndex].steps); 
+        _maneuverMoveIndex++; 
+        if(_maneuverMoveIndex >= _maneuver.numberOfMoves) {
+          _currentCommand = AlgorithmCommand::servoUp; 
+        }
+      }
+      _previousCommand = AlgorithmCommand::followManeuver; 
+      break;
+
+    case AlgorithmCommand::servoUp: {
+      if(_previousCommand == AlgorithmCommand::goToThirdPosition || _previousCommand == AlgorithmCommand::followManeuver) {
+        if(!_isRefining) {   //refinement probes aren't counted as attempts
+          (*pAttemptsCounter)++; 
+        }
+        _dwellStartMs = millis(); 
+        updateAverage(&_averageTravelMs, _dwellStartMs - _attemptStartMs); 
+        telemetry.sendDialed(_channel, _pStepperControl->getStepCount()); 
+        _pServoControl->moveTopPosition(); 
+        _isServoMoving = true; 
+      }
+      else if(_isServoMoving && _pServoControl->hasArrived()) {   //the hold time is counted from when the shackle-puller is up
+        _isServoMoving = false; 
+        _isHolding = true; 
+        _holdStartMs = millis(); 
+      }
+      else if(_isHolding && millis() - _holdStartMs >= SERVO_UP_HOLD_TIME_MS) {
+        _isHolding = false; 
+        _currentCommand = AlgorithmCommand::servoDown; 
+      }       
+      bool limitSwitchState = _limitSwitch.getState(); 
+      telemetry.updateLimitSwitch(_channel, limitSwitchState); 
+      flightRecorder.updateLimitSwitch(_channel, limitSwitchState); 
+      if(limitSwitchState == LIMIT_SWITCH_ACTIVATED) {
+        _isHolding = false; 
+        if(_isRefining) {
+          _isProbeOpened = true; 
+          _currentCommand = AlgorithmCommand::servoDown;   //the shackle is pushed closed again before the next probe
+        }
+        else {
+          if(_isRefinementEnabled && !_isFastOpenAttempt) {   //a cached combination has already been refined
+            startRefinement(); 
+            _currentCommand = AlgorithmCommand::servoDown; 
+          }
+          else {
+            saveOpenedCombination(); 
+            telemetry.sendAttemptEnd(_channel); 
+            flightRecorder.record(FlightEventSource::result, (unsigned char)AlgorithmState::complete, _channel, _pStepperControl->getCurrentStep()); 
+            return AlgorithmState::complete; 
+          }
+        }
+      } 
+      _previousCommand = AlgorithmCommand::servoUp; 
+      break;
+    }
+
+    case AlgorithmCommand::servoDown: 
+      if(_previousCommand == AlgorithmCommand::servoUp) {
+        _pServoControl->moveBottomPosition(); 
+        _isServoMoving = true; 
+        _isHolding = false; 
+      }
+      else if(_isServoMoving && _pServoControl->hasArrived()) {   //the hold time is counted from when the shackle-puller is down
+        _isServoMoving = false; 
+        _isHolding = true; 
+        _holdStartMs = millis(); 
+      }
+      else if(_isHolding && millis() - _holdStartMs >= SERVO_DOWN_HOLD_TIME_MS) {
+        _isHolding = false; 
+        updateAverage(&_averageDwellMs, millis() - _dwellStartMs); 
+        telemetry.sendAttemptEnd(_channel); 
+        _currentCommand = AlgorithmCommand::setNextValidCombination; 
+      }
+      _previousCommand = AlgorithmCommand::servoDown; 
+      break; 
+  }    
+  if(_currentCommand != startCommand) {
+    flightRecorder.record(FlightEventSource::algorithm, (unsigned char)_currentCommand, _channel, _pStepperControl->getCurrentStep()); 
+  }
+  return AlgorithmState::running;  
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Skips ahead in the search, so that the next combination that is 
+ *          dialed is the given attempt (for example to continue a search 
+ *          that was interrupted by a power cut). The skipped combinations 
+ *          are counted as attempts, but aren't dialed. 
+ * @note    The combinations are skipped by run(), one per call, before the
+ *          next combination is dialed. 
+ * @param   attemptNumber   The attempt to continue from (counted from 1). 
+ *          Attempts that have already been made can't be sought, and it 
+ *          can't be larger than getPlannedAttempts() (the search would skip
+ *          every remaining combination and end in an error). 
+ */
+/*****************************************************************************/
+void Algorithm::seekAttempt(unsigned int attemptNumber) {
+  _seekAttemptNumber = attemptNumber; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Selects how the dial is moved between combinations. This setting is
+ *          kept when the program is restarted with reconfig(). 
+ * @param   mode    DialSequenceMode::fullReset resets the dial every time the
+ *          second position changes. DialSequenceMode::shortestManeuver uses
+ *          the dial model to re-pick only the wheels that need to change. 
+ */
+/*****************************************************************************/
+void Algorithm::setDialSequenceMode(DialSequenceMode mode) {
+  _dialSequenceMode = mode; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Selects what happens when every combination of the zone-center 
+ *          pass has been tried. This setting is kept when the program is
+ *          restarted with reconfig(). 
+ * @param   isEnabled   If true, the search continues with the next pass of 
+ *          searchPasses (shifted zones, then finer zones), and only stops
+ *          when the last pass has been tried. If false, the algorithm 
+ *          stops after the zone-center pass (error page). 
+ */
+/*****************************************************************************/
+void Algorithm::setProgressiveSearch(bool isEnabled) {
+  _isProgressiveSearchEnabled = isEnabled; 
+  startCountingNextPass(); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the search pass that the current combination belongs to. 
+ * @returns Returns the index in searchPasses (0 is the zone-center pass). 
+ */
+/*****************************************************************************/
+unsigned char Algorithm::getSearchPass() {
+  return _searchPass; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Selects if the exact positions are searched for once a combination 
+ *          has opened the lock. This setting is kept when the program is 
+ *          restarted with reconfig(). 
+ * @param   isEnabled   If true, each position is refined within its zone 
+ *          before the algorithm completes (see startRefinement()). If false,
+ *          the zone positions that opened the lock are kept. 
+ */
+/*****************************************************************************/
+void Algorithm::setCombinationRefinement(bool isEnabled) {
+  _isRefinementEnabled = isEnabled; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Loads the lock profile that was selected on the lock profile page
+ *          (saved in the EEPROM). If a lock profile is selected, the
+ *          combinations are tried in prior-weighted order, and the
+ *          combination that opens the lock is added to the profile's 
+ *          histogram. 
+ * @note    This function should be called after reconfig(), before the 
+ *          algorithm starts running. 
+ */
+/*****************************************************************************/
+void Algorithm::loadLockProfile() {
+  _priorHistogram.load(EEPROM.read(LOCK_PROFILE_EEPROM_ADDRESS)); 
+  if(_priorHistogram.getLockProfile() == NO_LOCK_PROFILE) {
+    _combinationOrder = CombinationOrder::odometer; 
+  }
+  else {
+    _combinationOrder = CombinationOrder::priorWeighted; 
+    _isExpectedAttemptsDone = false;   //calculated from the histogram that is used for this run (see calculateExpectedAttempts())
+    _expectedIndex = 0; 
+    _expectedPreviousWeight = 0xFFFFFFFF; 
+    _expectedGroupWeight = 0; 
+    _expectedGroupCount = 0; 
+    _expectedRank = 0; 
+    _expectedTotalWeight = 0; 
+    _expectedWeightedAttempts = 0; 
+  }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Loads the lock ID that was selected on the lock ID page (saved in
+ *          the EEPROM). If a combination is cached for this lock ID, it is 
+ *          tried first (fast-open) before falling back to the full search. 
+ *          The combination that opens the lock is saved in the cache.
+ * @note    This function should be called after reconfig(), before the 
+ *          algorithm starts running. 
+ */
+/*****************************************************************************/
+void Algorithm::loadLockId() {
+  _lockId = EEPROM.read(LOCK_ID_EEPROM_ADDRESS); 
+  if(_lockId > MAX_LOCK_ID) {
+    _lockId = NO_LOCK_ID; 
+  }
+  _isFastOpenPending = _combinationCache.find(_lockId, &_cachedFirstPosition, &_cachedSecondPosition, &_cachedThirdPosition); 
+  _isFastOpenAttempt = false; 
+  _plannedAttempts = countSearchPassCombinations(); 
+  if(_isFastOpenPending) {
+    _plannedAttempts++; 
+  }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the expected number of attempts (see 
+ *          calculateExpectedAttempts()). 
+ * @returns Returns the expected number of attempts, or 0 if no lock profile
+ *          was selected, or if the calculation hadn't finished when the lock
+ *          was opened. 
+ */
+/*****************************************************************************/
+unsigned int Algorithm::getExpectedAttempts() {
+  return _expectedAttempts; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Calculates the expected number of attempts needed to open the
+ *          lock if the combination is drawn from the prior and the 
+ *          combinations are tried in prior-weighted order. 
+ * @note    Combinations with the same weight are grouped together, and each
+ *          pass over the combinations counts the next lower weight, so it 
+ *          takes as many passes as there are different weights (one with an
+ *          empty histogram). Each call only looks at EXPECTED_ATTEMPTS_CHUNK
+ *          combinations, and run() calls it while the servo pulls and 
+ *          releases the shackle (the dial isn't moving), so the search isn't
+ *          slowed down. The result is ready in getExpectedAttempts() once 
+ *          the last pass is done. 
+ */
+/*****************************************************************************/
+void Algorithm::calculateExpectedAttempts() {
+  if(_isExpectedAttemptsDone) {
+    return; 
+  }
+  for(unsigned int n = 0; n < EXPECTED_ATTEMPTS_CHUNK; n++) {
+    if(_expectedIndex == NUMBER_OF_ZONES*NUMBER_OF_ZONES*NUMBER_OF_ZONES) {   //end of a pass
+      if(_expectedGroupCount == 0) {   //every weight has been counted
+        _expectedAttempts = (unsigned int)(_expectedWeightedAttempts / _expectedTotalWeight + 0.5); 
+        _isExpectedAttemptsDone = true; 
+        return; 
+      }
+      //the combinations in this group are tried at attempts rank+1 to rank+count
+      _expectedWeightedAttempts += (float)_expectedGroupWeight * ((float)_expectedGroupCount * _expectedRank + (float)_expectedGroupCount * (_expectedGroupCount + 1) / 2); 
+      _expectedRank += _expectedGroupCount; 
+      _expectedPreviousWeight = _expectedGroupWeight; 
+      _expectedGroupWeight = 0; 
+      _expectedGroupCount = 0; 
+      _expectedIndex = 0; 
+    }
+    unsigned int index = _expectedIndex++; 
+    unsigned char firstZoneIndex = index / (NUMBER_OF_ZONES*NUMBER_OF_ZONES); 
+    unsigned char secondZoneIndex = (index / NUMBER_OF_ZONES) % NUMBER_OF_ZONES; 
+    unsigned char thirdZoneIndex = index % NUMBER_OF_ZONES; 
+    if(firstZoneIndex == secondZoneIndex || secondZoneIndex == thirdZoneIndex) {
+      continue; 
+    }
+    unsigned long combinationWeight = _priorHistogram.getWeight(firstZoneIndex, secondZoneIndex, thirdZoneIndex); 
+    if(_expectedPreviousWeight == 0xFFFFFFFF) {   //first pass
+      _expectedTotalWeight += combinationWeight; 
+    }
+    if(combinationWeight < _expectedPreviousWeight) {
+      if(combinationWeight > _expectedGroupWeight) {
+        _expectedGroupWeight = combinationWeight; 
+        _expectedGroupCount = 1; 
+      }
+      else if(combinationWeight == _expectedGroupWeight) {
+        _expectedGroupCount++; 
+      }
+    }
+  }
+}
+
+/*****************************************************************************/
+/**
+ * @brief Sets the next valid combination sequence. If all combinations have 
+ *        been tried, do not increment anymore and keep the values for the 
+ *        first, second and third positions set to the last valid combination
+ *        sequence.
+ * @note  This function uses *_pFirstPosition, *_pSecondPosition, and
+ *        *_pThirdPosition to modify first, second, and third position
+ *        variables found in the main file. 
+ * @returns   Returns ALL_COMBINATIONS_TRIED or NEW_COMBINATION_SET 
+ */
+/*****************************************************************************/
+bool Algorithm::setNextValidCombination() {
+  if(_combinationOrder == CombinationOrder::priorWeighted) {
+    return setNextPriorWeightedCombination(); 
+  }
+  while(1) {
+    if(*_pFirstPosition == NO_POSITION_ASSIGNED) {
+      *_pFirstPosition = _firstZone;  
+      *_pSecondPosition = _firstZone; 
+      *_pThirdPosition = _firstZone; 
+    }
+    else {
+      *_pThirdPosition += _zoneWidth; 
+      if(*_pThirdPosition >= NUMBER_OF_POSITIONS) {
+        *_pThirdPosition = _firstZone; 
+        *_pSecondPosition += _zoneWidth;
+        if(*_pSecondPosition >= NUMBER_OF_POSITIONS) {
+          *_pSecondPosition = _firstZone; 
+          *_pFirstPosition += _zoneWidth; 
+          if(*_pFirstPosition >= NUMBER_OF_POSITIONS) {
+            //assigns the last valid combination (remember that first/third positions cannot be the same as the second position) so that values don't keep incrementing
+            char numberOfZones = NUMBER_OF_POSITIONS / _zoneWidth; 
+            *_pFirstPosition = _firstZone + ((numberOfZones - 1)*(_zoneWidth));    
+            *_pSecondPosition = _firstZone + ((numberOfZones - 2)*(_zoneWidth));  
+            *_pThirdPosition = _firstZone + ((numberOfZones - 1)*(_zoneWidth));
+            return ALL_COMBINATIONS_TRIED; 
+          }
+        }
+      }
+    } 
+    if(*_pFirstPosition != *_pSecondPosition && *_pSecondPosition != *_pThirdPosition && !isCoveredByEarlierPass(*_pFirstPosition, *_pSecondPosition, *_pThirdPosition, _searchPass)) {
+      return NEW_COMBINATION_SET;
+    }  
+  } 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Moves on to the next pass of searchPasses once every combination of
+ *          the current pass has been tried. The next pass either shifts the 
+ *          zones or makes them narrower, and is always tried in odometer 
+ *          order.  
+ * @note    The positions are set to NO_POSITION_ASSIGNED, so the next call to
+ *          setNextValidCombination() starts the new pass from the beginning. 
+ * @returns Returns true if a new pass was started, or false if progressive 
+ *          search is disabled or the last pass has been tried. 
+ */
+/*****************************************************************************/
+bool Algorithm::startNextSearchPass() {
+  if(!_isProgressiveSearchEnabled || _searchPass + 1 >= NUMBER_OF_SEARCH_PASSES) {
+    return false; 
+  }
+  while(!_isNextPassCounted) {   //only if the pass was skipped through before it was counted (see seekAttempt())
+    countNextPassCombinations(); 
+  }
+  _searchPass++; 
+  _zoneWidth = searchPasses[_searchPass].zoneWidth; 
+  _firstZone = (_savedFirstZone + searchPasses[_searchPass].zoneOffset) % _zoneWidth; 
+  _combinationOrder = CombinationOrder::odometer; 
+  _plannedAttempts += _nextPassCombinations; 
+  startCountingNextPass(); 
+  *_pFirstPosition = NO_POSITION_ASSIGNED; 
+  *_pSecondPosition = NO_POSITION_ASSIGNED; 
+  *_pThirdPosition = NO_POSITION_ASSIGNED; 
+  return true; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if a combination was already covered by an earlier search
+ *          pass. A combination is covered when every position is within 
+ *          SEARCH_PASS_TOLERANCE of a position of the same earlier pass, and
+ *          that earlier combination was actually tried (the first and third
+ *          positions cannot be the same as the second position). 
+ * @param   firstPos    The first position of the combination. 
+ * @param   secondPos   The second position of the combination. 
+ * @param   thirdPos    The third position of the combination. 
+ * @param   searchPass  The pass that the combination belongs to, the passes
+ *          before it are checked. 
+ * @returns Returns true if the combination can be skipped. 
+ */
+/*****************************************************************************/
+bool Algorithm::isCoveredByEarlierPass(char firstPos, char secondPos, char thirdPos, unsigned char searchPass) {
+  const char positions[3] = {firstPos, secondPos, thirdPos}; 
+  for(unsigned char pass = 0; pass < searchPass; pass++) {
+    char zoneWidth = searchPasses[pass].zoneWidth; 
+    char firstZone = (_savedFirstZone + searchPasses[pass].zoneOffset) % zoneWidth; 
+    char nearestPositions[3]; 
+    bool isWithinTolerance = true; 
+    for(unsigned char i = 0; i < 3 && isWithinTolerance; i++) {
+      char distance = ((positions[i] - firstZone) % zoneWidth + zoneWidth) % zoneWidth;   //distance to the tried position below
+      if(distance <= SEARCH_PASS_TOLERANCE) {
+        nearestPositions[i] = (positions[i] - distance + NUMBER_OF_POSITIONS) % NUMBER_OF_POSITIONS;   //the tried position below 0 is the one below NUMBER_OF_POSITIONS 
+      }
+      else if(zoneWidth - distance <= SEARCH_PASS_TOLERANCE) {
+        nearestPositions[i] = (positions[i] + zoneWidth - distance) % NUMBER_OF_POSITIONS; 
+      }
+      else {
+        isWithinTolerance = false; 
+      }
+    }
+    if(isWithinTolerance && nearestPositions[0] != nearestPositions[1] && nearestPositions[1] != nearestPositions[2]) {
+      return true; 
+    }
+  }
+  return false; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sets the untried combination with the highest prior weight. Ties
+ *          are broken in odometer order, so an empty histogram gives the same
+ *          order as setNextValidCombination(). Every combination is tried
+ *          exactly once. 
+ * @note    This function uses *_pFirstPosition, *_pSecondPosition, and
+ *          *_pThirdPosition to modify first, second, and third position
+ *          variables found in the main file. 
+ * @returns Returns ALL_COMBINATIONS_TRIED or NEW_COMBINATION_SET 
+ */
+/*****************************************************************************/
+bool Algorithm::setNextPriorWeightedCombination() {
+  bool isCombinationFound = false; 
+  unsigned long bestWeight = 0; 
+  unsigned int bestIndex = 0; 
+  for(unsigned int index = 0; index < NUMBER_OF_ZONES*NUMBER_OF_ZONES*NUMBER_OF_ZONES; index++) {
+    unsigned char firstZoneIndex = index / (NUMBER_OF_ZONES*NUMBER_OF_ZONES); 
+    unsigned char secondZoneIndex = (index / NUMBER_OF_ZONES) % NUMBER_OF_ZONES; 
+    unsigned char thirdZoneIndex = index % NUMBER_OF_ZONES; 
+    if(firstZoneIndex == secondZoneIndex || secondZoneIndex == thirdZoneIndex || isCombinationTried(index)) {   //remember that first/third positions cannot be the same as the second position
+      continue; 
+    }
+    unsigned long weight = _priorHistogram.getWeight(firstZoneIndex, secondZoneIndex, thirdZoneIndex); 
+    if(weight > bestWeight) {
+      bestWeight = weight; 
+      bestIndex = index; 
+      isCombinationFound = true; 
+    }
+  }
+  if(!isCombinationFound) {
+    return ALL_COMBINATIONS_TRIED; 
+  }
+  _triedCombinations[bestIndex / 8] |= (1 << (bestIndex % 8)); 
+  *_pFirstPosition = _firstZone + (bestIndex / (NUMBER_OF_ZONES*NUMBER_OF_ZONES))*ZONE_OFFSET; 
+  *_pSecondPosition = _firstZone + ((bestIndex / NUMBER_OF_ZONES) % NUMBER_OF_ZONES)*ZONE_OFFSET; 
+  *_pThirdPosition = _firstZone + (bestIndex % NUMBER_OF_ZONES)*ZONE_OFFSET; 
+  return NEW_COMBINATION_SET; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if a combination has already been tried in prior-weighted
+ *          order. 
+ * @param   combinationIndex    The zone indexes of the combination, packed as
+ *          first*NUMBER_OF_ZONES^2 + second*NUMBER_OF_ZONES + third. 
+ * @returns Returns true if the combination has been tried. 
+ */
+/*****************************************************************************/
+bool Algorithm::isCombinationTried(unsigned int combinationIndex) {
+  return _triedCombinations[combinationIndex / 8] & (1 << (combinationIndex % 8)); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Counts the combinations that the current search pass will try. 
+ * @note    Only used for the zone-center pass, which has no earlier passes
+ *          to check the combinations against. The later passes are counted
+ *          in the background (see countNextPassCombinations()). 
+ * @returns Returns the number of combinations. 
+ */
+/*****************************************************************************/
+unsigned int Algorithm::countSearchPassCombinations() {
+  unsigned int count = 0; 
+  for(char first = _firstZone; first < NUMBER_OF_POSITIONS; first += _zoneWidth) {
+    for(char second = _firstZone; second < NUMBER_OF_POSITIONS; second += _zoneWidth) {
+      if(second == first) {
+        continue; 
+      }
+      for(char third = _firstZone; third < NUMBER_OF_POSITIONS; third += _zoneWidth) {
+        if(third != second && !isCoveredByEarlierPass(first, second, third, _searchPass)) {
+          count++; 
+        }
+      }
+    }
+  }
+  return count; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Starts counting the combinations of the search pass after the 
+ *          current one (see countNextPassCombinations()). 
+ */
+/*****************************************************************************/
+void Algorithm::startCountingNextPass() {
+  _nextPassCombinations = 0; 
+  _isNextPassCounted = (!_isProgressiveSearchEnabled || _searchPass + 1 >= NUMBER_OF_SEARCH_PASSES); 
+  if(!_isNextPassCounted) {
+    char zoneWidth = searchPasses[_searchPass + 1].zoneWidth; 
+    _nextPassFirst = (_savedFirstZone + searchPasses[_searchPass + 1].zoneOffset) % zoneWidth; 
+    _nextPassSecond = _nextPassFirst; 
+  }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Counts the combinations of the next search pass for one first 
+ *          and second position (a row of third positions) per call. 
+ * @note    The finer passes check every combination against the earlier 
+ *          passes, which would hold up the main loop if the whole pass was
+ *          counted when it starts. run() calls this while the servo pulls 
+ *          and releases the shackle, so the next pass has been counted long
+ *          before the current one ends. 
+ */
+/*****************************************************************************/
+void Algorithm::countNextPassCombinations() {
+  if(_isNextPassCounted) {
+    return; 
+  }
+  unsigned char nextPass = _searchPass + 1; 
+  char zoneWidth = searchPasses[nextPass].zoneWidth; 
+  char firstZone = (_savedFirstZone + searchPasses[nextPass].zoneOffset) % zoneWidth; 
+  if(_nextPassSecond != _nextPassFirst) {
+    for(char third = firstZone; third < NUMBER_OF_POSITIONS; third += zoneWidth) {
+      if(third != _nextPassSecond && !isCoveredByEarlierPass(_nextPassFirst, _nextPassSecond, third, nextPass)) {
+        _nextPassCombinations++; 
+      }
+    }
+  }
+  _nextPassSecond += zoneWidth; 
+  if(_nextPassSecond >= NUMBER_OF_POSITIONS) {
+    _nextPassSecond = firstZone; 
+    _nextPassFirst += zoneWidth; 
+    _isNextPassCounted = (_nextPassFirst >= NUMBER_OF_POSITIONS); 
+  }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the number of attempts that the search can take, counting the
+ *          fast-open attempt and every search pass that has been started so
+ *          far. 
+ * @returns Returns the number of planned attempts. 
+ */
+/*****************************************************************************/
+unsigned int Algorithm::getPlannedAttempts() {
+  return _plannedAttempts; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Estimates how long it will take to try the remaining planned
+ *          attempts, from the measured average attempt duration. 
+ * @param   attemptNumber   The number of attempts made so far. 
+ * @returns Returns the estimated time (milliseconds), or 0 if no attempt has
+ *          been measured yet. 
+ */
+/*****************************************************************************/
+unsigned long Algorithm::getEstimatedRemainingMs(unsigned int attemptNumber) {
+  if(attemptNumber >= _plannedAttempts) {
+    return 0; 
+  }
+  return (unsigned long)(_plannedAttempts - attemptNumber) * (_averageTravelMs + _averageDwellMs); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the average time spent dialing a combination (from the 
+ *          moment a new combination is set until the servo starts pulling). 
+ * @returns Returns the moving average (milliseconds), or 0 if no attempt has
+ *          been measured yet. 
+ */
+/*****************************************************************************/
+unsigned long Algorithm::getAverageTravelMs() {
+  return _averageTravelMs; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the average time spent pulling and releasing the shackle. 
+ * @returns Returns the moving average (milliseconds), or 0 if no attempt has
+ *          been measured yet. 
+ */
+/*****************************************************************************/
+unsigned long Algorithm::getAverageDwellMs() {
+  return _averageDwellMs; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if the algorithm is waiting for the servo (the stepper 
+ *          motor isn't moving). Slow work like redrawing the display can be
+ *          done now without delaying the dial. 
+ * @returns Returns true while the servo is pulling or releasing the shackle.
+ */
+/*****************************************************************************/
+bool Algorithm::isDwelling() {
+  return (_currentCommand == AlgorithmCommand::servoUp || _currentCommand == AlgorithmCommand::servoDown); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Adds a measured duration to an exponential moving average. The
+ *          first measurement is used as is. 
+ * @param   pAverageMs  The moving average (milliseconds) that is updated.
+ *          0 means that nothing has been measured yet. 
+ * @param   sampleMs    The measured duration (milliseconds). 
+ */
+/*****************************************************************************/
+void Algorithm::updateAverage(unsigned long* pAverageMs, unsigned long sampleMs) {
+  if(*pAverageMs == 0) {
+    *pAverageMs = sampleMs; 
+  }
+  else {
+    *pAverageMs = *pAverageMs + ((long)sampleMs - (long)*pAverageMs) / ATTEMPT_AVERAGE_WEIGHT; 
+  }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Starts searching for the exact positions of the combination that
+ *          just opened the lock. The range of positions that opens the lock
+ *          is found for one position at a time (the other two positions stay
+ *          where they opened the lock), and the middle of that range is kept.
+ *          The lower and upper edges of the range are each found with a 
+ *          binary search within one zone width of the zone position, using
+ *          the limit switch to tell if a probe opened the lock. 
+ * @note    The shackle-puller moving to the bottom position is expected to
+ *          push the shackle closed again between probes. If the limit switch
+ *          is still activated before a probe, the refinement stops. 
+ */
+/*****************************************************************************/
+void Algorithm::startRefinement() {
+  _isRefining = true; 
+  _isProbePending = false; 
+  _refinementDigit = 0; 
+  _refinedPositions[0] = *_pFirstPosition; 
+  _refinedPositions[1] = *_pSecondPosition; 
+  _refinedPositions[2] = *_pThirdPosition; 
+  startEdgeSearch(false); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Starts the binary search for one edge of the range of positions 
+ *          that opens the lock. 
+ * @param   isUpperEdge If true, the search goes up to one zone width above 
+ *          the refined position. If false, it goes down to one zone width
+ *          below. 
+ */
+/*****************************************************************************/
+void Algorithm::startEdgeSearch(bool isUpperEdge) {
+  _isUpperEdgeSearch = isUpperEdge; 
+  _openOffset = 0; 
+  if(isUpperEdge) {
+    _closedOffset = _zoneWidth; 
+  }
+  else {
+    _closedOffset = -_zoneWidth; 
+  }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Uses the result of the last probe and sets the next probe 
+ *          combination. When both edges of a position have been found, the
+ *          position is moved to the middle of its range and the next position
+ *          is refined. 
+ * @note    This function uses *_pFirstPosition, *_pSecondPosition, and
+ *          *_pThirdPosition to modify first, second, and third position
+ *          variables found in the main file. 
+ * @returns Returns true if a probe combination was set, or false if every 
+ *          position has been refined (the exact positions are in 
+ *          _refinedPositions). 
+ */
+/*****************************************************************************/
+bool Algorithm::setNextRefinementProbe() {
+  if(_isProbePending) {
+    _isProbePending = false; 
+    if(_isProbeOpened) {
+      _openOffset = _probeOffset; 
+    }
+    else {
+      _closedOffset = _probeOffset; 
+    }
+  }
+  while(1) {
+    if(abs(_closedOffset - _openOffset) > 1) {
+      _probeOffset = _openOffset + (_closedOffset - _openOffset) / 2; 
+      _isProbePending = true; 
+      _isProbeOpened = false; 
+      char probePositions[3] = {_refinedPositions[0], _refinedPositions[1], _refinedPositions[2]}; 
+      probePositions[_refinementDigit] = (probePositions[_refinementDigit] + _probeOffset + NUMBER_OF_POSITIONS) % NUMBER_OF_POSITIONS; 
+      *_pFirstPosition = probePositions[0]; 
+      *_pSecondPosition = probePositions[1]; 
+      *_pThirdPosition = probePositions[2]; 
+      return true; 
+    }
+    if(!_isUpperEdgeSearch) {
+      _lowerEdgeOffset = _openOffset; 
+      startEdgeSearch(true); 
+    }
+    else {
+      char middleOffset = (_lowerEdgeOffset + _openOffset) / 2; 
+      _refinedPositions[_refinementDigit] = (_refinedPositions[_refinementDigit] + middleOffset + NUMBER_OF_POSITIONS) % NUMBER_OF_POSITIONS; 
+      _refinementDigit++; 
+      if(_refinementDigit >= 3) {
+        return false; 
+      }
+      startEdgeSearch(false); 
+    }
+  }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Saves the combination that opened the lock to the prior histogram
+ *          (if a lock profile is selected) and to the combination cache (if
+ *          a lock ID is selected). 
+ */
+/*****************************************************************************/
+void Algorithm::saveOpenedCombination() {
+  _isExpectedAttemptsDone = true;   //the histogram changes, so a calculation that hasn't finished yet is dropped
+  _priorHistogram.recordSuccess(*_pFirstPosition, *_pSecondPosition, *_pThirdPosition); 
+  _combinationCache.store(_lockId, *_pFirstPosition, *_pSecondPosition, *_pThirdPosition); 
+}
+
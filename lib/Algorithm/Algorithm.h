@@ -1,51 +1,184 @@
-
-#ifndef ALGORITHM_H
-#define ALGORITHM_H
-
-#define SERVO_UP_WAIT_TIME_MS 500  
-#define SERVO_DOWN_WAIT_TIME_MS 300  
-
-#define NO_POSITION_ASSIGNED -1
-
-#define ALL_COMBINATIONS_TRIED 0
-#define NEW_COMBINATION_SET 1
-
-enum class AlgorithmState { 
-    running, 
-    error, 
-    complete 
-};
-
-enum class AlgorithmCommand {
-    none, 
-    setNextValidCombination,
-    rotateClockwiseTwice,
-    goToThirdPosition,
-    rotateCounterclockwiseOnce,
-    goToSecondPosition,
-    goToFirstPosition,
-    servoUp,
-    servoDown
-};
-
-class Algorithm {
-public:
-    void init(char* pFirstPosition, char* pSecondPosition, char* pThirdPosition);
-    void reconfig(); 
-    static void handleServoUpTimeLimit(); 
-    static void handleServoDownTimeLimit(); 
-    AlgorithmState run(unsigned int* pAttemptsCounter); 
-
-private:
-    bool setNextValidCombination(); 
-    AlgorithmCommand _currentCommand; 
-    AlgorithmCommand _previousCommand; 
-    static bool _isServoUpTimeLimitReached;
-    static bool _isServoDownTimeLimitReached; 
-    char* _pFirstPosition; 
-    char* _pSecondPosition;
-    char* _pThirdPosition; 
-    char _firstZone; 
-}; 
-
-#endif
+
+#ifndef ALGORITHM_H
+#define ALGORITHM_H
+
+#include "DialModel.h"
+#include "PriorHistogram.h"
+#include "CombinationCache.h"
+#include "LimitSwitch.h"
+#include "StepperControl.h"
+#include "ServoControl.h"
+#include "Common.h"
+
+//the servo holds each position this long after it has arrived (ServoControl::hasArrived()), the travel time isn't included
+//kept at the old waits (which included the travel), until SERVO_HORN_SPEED_US is measured on the machine and these can be shortened
+#define SERVO_UP_HOLD_TIME_MS 500  
+#define SERVO_DOWN_HOLD_TIME_MS 300  
+
+#define NO_POSITION_ASSIGNED -1
+
+#define ALL_COMBINATIONS_TRIED 0
+#define NEW_COMBINATION_SET 1
+
+//add -D SHORTEST_DIAL_MANEUVER to the build flags (platformio.ini) to let the dial model plan partial re-dial sequences
+#ifdef SHORTEST_DIAL_MANEUVER
+  #define DEFAULT_DIAL_SEQUENCE_MODE DialSequenceMode::shortestManeuver
+#else
+  #define DEFAULT_DIAL_SEQUENCE_MODE DialSequenceMode::fullReset
+#endif
+
+//add -D PROGRESSIVE_SEARCH to the build flags (platformio.ini) to keep searching with shifted/finer zones instead of stopping at the error page
+#ifdef PROGRESSIVE_SEARCH
+  #define DEFAULT_PROGRESSIVE_SEARCH true
+#else
+  #define DEFAULT_PROGRESSIVE_SEARCH false
+#endif
+
+//add -D REFINE_COMBINATION to the build flags (platformio.ini) to search for the exact positions once a zone combination has opened the lock
+#ifdef REFINE_COMBINATION
+  #define DEFAULT_COMBINATION_REFINEMENT true
+#else
+  #define DEFAULT_COMBINATION_REFINEMENT false
+#endif
+
+#define NUMBER_OF_SEARCH_PASSES 3
+#define SEARCH_PASS_TOLERANCE 2   //a tried position is assumed to also open the lock when the dial is off by up to this many positions
+
+enum class AlgorithmState { 
+    running, 
+    error, 
+    complete 
+};
+
+enum class AlgorithmCommand {
+    none, 
+    setNextValidCombination,
+    rotateClockwiseTwice,
+    goToThirdPosition,
+    rotateCounterclockwiseOnce,
+    goToSecondPosition,
+    goToFirstPosition,
+    followManeuver,
+    servoUp,
+    servoDown,
+    homeToIndex
+};
+
+enum class DialSequenceMode {
+    fullReset,          //every new second position is dialed from scratch (rotateClockwiseTwice)
+    shortestManeuver    //the dial model plans the shortest sequence that keeps the first wheel in place
+};
+
+enum class CombinationOrder {
+    odometer,       //the third position changes fastest, then the second, then the first
+    priorWeighted   //combinations are tried in descending prior probability (see PriorHistogram.h)
+};
+
+struct SearchPass {
+    char zoneOffset;   //added to the first zone (saved in setup3) to get the first position of this pass
+    char zoneWidth;    //number of positions between two tried positions
+};
+
+#define ATTEMPT_AVERAGE_WEIGHT 8   //each measured attempt moves the average attempt duration by 1/8 of the difference
+
+#define EXPECTED_ATTEMPTS_CHUNK (NUMBER_OF_ZONES*NUMBER_OF_ZONES)   //combinations looked at per call of calculateExpectedAttempts()
+
+#define TRIED_COMBINATIONS_BYTES ((NUMBER_OF_ZONES*NUMBER_OF_ZONES*NUMBER_OF_ZONES + 7) / 8)   //one bit per zone combination
+
+class Algorithm {
+public:
+    void init(unsigned char channel, StepperControl* pStepperControl, ServoControl* pServoControl, uint8_t limitSwitchPin, char* pFirstPosition, char* pSecondPosition, char* pThirdPosition);
+    void reconfig(); 
+    AlgorithmState run(unsigned int* pAttemptsCounter); 
+    void seekAttempt(unsigned int attemptNumber); 
+    void setDialSequenceMode(DialSequenceMode mode); 
+    void loadLockProfile(); 
+    void loadLockId(); 
+    unsigned int getExpectedAttempts(); 
+    void setProgressiveSearch(bool isEnabled); 
+    unsigned char getSearchPass(); 
+    void setCombinationRefinement(bool isEnabled); 
+    unsigned int getPlannedAttempts(); 
+    unsigned long getEstimatedRemainingMs(unsigned int attemptNumber); 
+    unsigned long getAverageTravelMs(); 
+    unsigned long getAverageDwellMs(); 
+    bool isDwelling(); 
+
+private:
+    bool setNextValidCombination(); 
+    bool setNextPriorWeightedCombination(); 
+    bool isCombinationTried(unsigned int combinationIndex); 
+    bool startNextSearchPass(); 
+    bool isCoveredByEarlierPass(char firstPos, char secondPos, char thirdPos, unsigned char searchPass); 
+    unsigned int countSearchPassCombinations(); 
+    void startCountingNextPass(); 
+    void countNextPassCombinations(); 
+    static void updateAverage(unsigned long* pAverageMs, unsigned long sampleMs); 
+    void startRefinement(); 
+    void startEdgeSearch(bool isUpperEdge); 
+    bool setNextRefinementProbe(); 
+    void saveOpenedCombination(); 
+    void calculateExpectedAttempts(); 
+    AlgorithmCommand _currentCommand; 
+    AlgorithmCommand _previousCommand; 
+    unsigned char _channel; 
+    StepperControl* _pStepperControl; 
+    ServoControl* _pServoControl; 
+    LimitSwitch _limitSwitch; 
+    bool _isServoMoving;   //the servo was moved and the hold timer starts once it has arrived
+    bool _isHolding;       //the servo has arrived and is held there until the hold time is over
+    unsigned int _seekAttemptNumber;   //0 if no attempt is being sought
+    bool _isDialResetNeeded;   //combinations were skipped, so the dial has to be reset before the next one
+    unsigned long _holdStartMs; 
+    char* _pFirstPosition; 
+    char* _pSecondPosition;
+    char* _pThirdPosition; 
+    char _firstZone;       //first position of the current search pass
+    char _savedFirstZone;  //first zone saved in setup3 (the first position of the zone-center pass)
+    char _zoneWidth; 
+    bool _isProgressiveSearchEnabled; 
+    unsigned char _searchPass; 
+    unsigned int _plannedAttempts;     //combinations in the search passes that have been started (and the fast-open attempt)
+    unsigned int _nextPassCombinations;   //combinations of the next search pass counted so far (see countNextPassCombinations())
+    char _nextPassFirst;               //first and second positions of the next row to count
+    char _nextPassSecond; 
+    bool _isNextPassCounted; 
+    unsigned long _attemptStartMs;     //when the dial started moving to the current combination
+    unsigned long _dwellStartMs;       //when the servo started pulling the shackle
+    unsigned long _averageTravelMs;    //moving average of the time spent dialing a combination (0 until measured)
+    unsigned long _averageDwellMs;     //moving average of the time spent pulling and releasing the shackle (0 until measured)
+    DialSequenceMode _dialSequenceMode; 
+    DialModel _dialModel; 
+    DialManeuver _maneuver; 
+    unsigned char _maneuverMoveIndex; 
+    CombinationOrder _combinationOrder; 
+    PriorHistogram _priorHistogram; 
+    unsigned char _triedCombinations[TRIED_COMBINATIONS_BYTES]; 
+    unsigned int _expectedAttempts; 
+    bool _isExpectedAttemptsDone;   //false while calculateExpectedAttempts() has passes left to make
+    unsigned int _expectedIndex;    //next combination that calculateExpectedAttempts() looks at
+    unsigned long _expectedPreviousWeight;   //the combinations with a higher weight have been counted
+    unsigned long _expectedGroupWeight;      //highest weight below that, found so far in this pass
+    unsigned int _expectedGroupCount;        //combinations with that weight
+    unsigned int _expectedRank;              //combinations that have been counted (tried before the current group)
+    float _expectedTotalWeight;              //summed up in the first pass
+    float _expectedWeightedAttempts;         //sum of weight * attempt number over the counted combinations
+    CombinationCache _combinationCache; 
+    unsigned char _lockId; 
+    bool _isFastOpenPending;   //the cached combination still needs to be tried
+    bool _isFastOpenAttempt;   //the cached combination is being tried
+    char _cachedFirstPosition, _cachedSecondPosition, _cachedThirdPosition; 
+    bool _isRefinementEnabled; 
+    bool _isRefining;                 //the lock has been opened, and the exact positions are being searched for
+    bool _isProbeOpened;              //result of the last refinement probe
+    unsigned char _refinementDigit;   //0 = first position, 1 = second position, 2 = third position
+    bool _isUpperEdgeSearch; 
+    char _openOffset;                 //offset from the refined position that is known to open the lock
+    char _closedOffset;               //offset from the refined position that is assumed to not open the lock
+    char _lowerEdgeOffset; 
+    char _probeOffset; 
+    bool _isProbePending;             //a probe has been dialed, but its result hasn't been used yet
+    char _refinedPositions[3];        //positions that opened the lock (zone positions until each digit is refined)
+}; 
+
+#endif
@@ -0,0 +1,70 @@
+
+#include <Arduino.h>
+#include "BootTimer.h"
+
+#ifdef PRINT_BOOT_TIME
+//printed next to the times, in the same order as BootStage
+const char bootStageName_config[] PROGMEM = "config"; 
+const char bootStageName_servo[] PROGMEM = "servo"; 
+const char bootStageName_stepper[] PROGMEM = "stepper"; 
+const char bootStageName_algorithm[] PROGMEM = "algorithm"; 
+const char bootStageName_touch[] PROGMEM = "touch"; 
+const char bootStageName_display[] PROGMEM = "display"; 
+const char bootStageName_interactive[] PROGMEM = "interactive"; 
+const char* const bootStageNames[(unsigned char)BootStage::count] PROGMEM = {
+    bootStageName_config, 
+    bootStageName_servo, 
+    bootStageName_stepper, 
+    bootStageName_algorithm, 
+    bootStageName_touch, 
+    bootStageName_display, 
+    bootStageName_interactive
+}; 
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   Records the time (since reset) at which a boot stage was 
+ *          reached. Only the first time counts, so this can be called from 
+ *          loop(). Once the program is interactive, the times are printed
+ *          to the serial monitor (115200 baud). 
+ * @note    Does nothing unless -D PRINT_BOOT_TIME is set. The times don't
+ *          include the bootloader or the start-up delay set by the fuses, 
+ *          since micros() starts counting just before setup(). 
+ * @param   stage   The stage that was just completed. 
+ */
+/*****************************************************************************/
+void BootTimer::mark(BootStage stage) {
+#ifdef PRINT_BOOT_TIME
+    if(_stageMicros[(unsigned char)stage] == 0) {   //the object is zeroed at startup, and micros() is never 0 by the time setup() runs
+        _stageMicros[(unsigned char)stage] = micros(); 
+    }
+    if(stage == BootStage::interactive && !_isPrinted) {
+        print(); 
+        _isPrinted = true; 
+    }
+#else
+    (void)stage; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints the time at which each stage was reached, and how long it
+ *          took after the previous one. 
+ */
+/*****************************************************************************/
+void BootTimer::print() {
+#ifdef PRINT_BOOT_TIME
+    unsigned long previousMicros = 0; 
+    Serial.println(F("Boot time (us since reset / since the previous stage):")); 
+    for(unsigned char i = 0; i < (unsigned char)BootStage::count; i++) {
+        Serial.print((const __FlashStringHelper*)pgm_read_ptr(&bootStageNames[i])); 
+        Serial.print(F(": ")); 
+        Serial.print(_stageMicros[i]); 
+        Serial.print(F(" / ")); 
+        Serial.println(_stageMicros[i] - previousMicros); 
+        previousMicros = _stageMicros[i]; 
+    }
+#endif
+}
@@ -0,0 +1,30 @@
+
+#ifndef BOOT_TIMER_H
+#define BOOT_TIMER_H
+
+//the steps of a boot, in order (see setup() and loop() in main.cpp)
+enum class BootStage : unsigned char {
+    config,        //EEPROM configuration loaded
+    servo,         //servo signal started at the saved bottom position
+    stepper,       //stepper driver disabled
+    algorithm, 
+    touch,         //touch screen and calibration set up
+    display,       //LCD reset and initialized
+    interactive,   //home page drawn and touch screen being read
+    count
+};
+
+class BootTimer {
+public:
+    void mark(BootStage stage); 
+
+private:
+    void print(); 
+#ifdef PRINT_BOOT_TIME
+    unsigned long _stageMicros[(unsigned char)BootStage::count]; 
+    bool _isPrinted; 
+#endif
+};
+extern BootTimer bootTimer; 
+
+#endif
@@ -0,0 +1,83 @@
+
+#include <EEPROM.h>
+#include "CombinationCache.h"
+#include "Common.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Looks for a previously opened combination for a lock ID.
+ * @param   lockId  The lock ID (1 to MAX_LOCK_ID). 
+ * @param   pFirstPosition  The cached first position is written here.
+ * @param   pSecondPosition The cached second position is written here.
+ * @param   pThirdPosition  The cached third position is written here.
+ * @returns Returns true if the lock ID was found. If it wasn't found, the
+ *          positions are not modified. 
+ */
+/*****************************************************************************/
+bool CombinationCache::find(unsigned char lockId, char* pFirstPosition, char* pSecondPosition, char* pThirdPosition) {
+    if(lockId == NO_LOCK_ID || lockId > MAX_LOCK_ID) {
+        return false;
+    }
+    for(unsigned char i = 0; i < COMBINATION_CACHE_SIZE; i++) {
+        int address = getEntryAddress(i);
+        if(EEPROM.read(address) == lockId) {
+            *pFirstPosition = EEPROM.read(address + 1);
+            *pSecondPosition = EEPROM.read(address + 2);
+            *pThirdPosition = EEPROM.read(address + 3);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Saves the combination that opened a lock. The entry is moved to
+ *          the front of the cache. If the lock ID isn't cached yet and the 
+ *          cache is full, the least recently used entry is evicted. 
+ * @note    Erased EEPROM reads 0xFF, which is never a valid lock ID, so 
+ *          unused entries are simply the last ones to be evicted.
+ * @param   lockId  The lock ID (1 to MAX_LOCK_ID). Nothing is saved for
+ *          NO_LOCK_ID.
+ * @param   firstPos    The first position that opened the lock. 
+ * @param   secondPos   The second position that opened the lock. 
+ * @param   thirdPos    The third position that opened the lock. 
+ */
+/*****************************************************************************/
+void CombinationCache::store(unsigned char lockId, char firstPos, char secondPos, char thirdPos) {
+    if(lockId == NO_LOCK_ID || lockId > MAX_LOCK_ID) {
+        return;
+    }
+
+    unsigned char entryIndex = COMBINATION_CACHE_SIZE - 1;   //least recently used entry, unless the lock ID is already cached
+    for(unsigned char i = 0; i < COMBINATION_CACHE_SIZE; i++) {
+        if(EEPROM.read(getEntryAddress(i)) == lockId) {
+            entryIndex = i;
+            break;
+        }
+    }
+
+    //shifts the more recently used entries back by one to make room at the front
+    for(unsigned char i = entryIndex; i > 0; i--) {
+        for(unsigned char j = 0; j < COMBINATION_CACHE_ENTRY_SIZE; j++) {
+            EEPROM.update(getEntryAddress(i) + j, EEPROM.read(getEntryAddress(i - 1) + j));   //only writes to eeprom if the value is different
+        }
+    }
+
+    int address = getEntryAddress(0);
+    EEPROM.update(address, lockId);
+    EEPROM.update(address + 1, firstPos);
+    EEPROM.update(address + 2, secondPos);
+    EEPROM.update(address + 3, thirdPos);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the EEPROM address of a cache entry. 
+ * @param   entryIndex  The entry index (0 is the most recently used entry).
+ * @returns Returns the address of the entry's lock ID byte.
+ */
+/*****************************************************************************/
+int CombinationCache::getEntryAddress(unsigned char entryIndex) {
+    return COMBINATION_CACHE_EEPROM_ADDRESS + entryIndex*COMBINATION_CACHE_ENTRY_SIZE;
+}
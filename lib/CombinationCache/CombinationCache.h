@@ -0,0 +1,15 @@
+
+#ifndef COMBINATION_CACHE_H
+#define COMBINATION_CACHE_H
+
+//the cache keeps no state in RAM, everything is read from and written to the EEPROM (see Common.h for the layout)
+class CombinationCache {
+public:
+    bool find(unsigned char lockId, char* pFirstPosition, char* pSecondPosition, char* pThirdPosition);
+    void store(unsigned char lockId, char firstPos, char secondPos, char thirdPos);
+
+private:
+    int getEntryAddress(unsigned char entryIndex);
+};
+
+#endif
@@ -0,0 +1,47 @@
+
+#include <Arduino.h>
+#include "ChannelPins.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Gets one of the pins in the pin table, when building. 
+ * @param   index   The channel times 7, plus the pin's place in ChannelPins.
+ * @returns Returns the pin. 
+ */
+/*****************************************************************************/
+constexpr uint8_t getTablePin(unsigned char index) {
+    return index % 7 == 0 ? channelPinTable[index / 7].step 
+        : index % 7 == 1 ? channelPinTable[index / 7].dir 
+        : index % 7 == 2 ? channelPinTable[index / 7].ms1 
+        : index % 7 == 3 ? channelPinTable[index / 7].ms2 
+        : index % 7 == 4 ? channelPinTable[index / 7].en 
+        : index % 7 == 5 ? channelPinTable[index / 7].servoSignal 
+        : channelPinTable[index / 7].limitSwitch; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks, when building, if a pin of the channels that are used is
+ *          also used by another channel (or twice by the same one). 
+ * @param   index   The pin to compare (see getTablePin()). 
+ * @param   otherIndex  The first pin it's compared with. 
+ * @returns Returns true if any pin from index on is repeated. 
+ */
+/*****************************************************************************/
+constexpr bool isTablePinRepeated(unsigned char index, unsigned char otherIndex) {
+    return index < 7*NUMBER_OF_CHANNELS && (otherIndex < 7*NUMBER_OF_CHANNELS 
+        ? getTablePin(index) == getTablePin(otherIndex) || isTablePinRepeated(index, otherIndex + 1) 
+        : isTablePinRepeated(index + 1, index + 2)); 
+}
+static_assert(!isTablePinRepeated(0, 1), "A pin is used twice in the pin table"); 
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the pins of a channel from the pin table (kept in flash). 
+ * @param   channel The channel (0 to NUMBER_OF_CHANNELS - 1). 
+ * @param   pPins   Points to the pins to be filled in. 
+ */
+/*****************************************************************************/
+void getChannelPins(unsigned char channel, ChannelPins* pPins) {
+    memcpy_P(pPins, &channelPinTable[channel], sizeof(ChannelPins)); 
+}
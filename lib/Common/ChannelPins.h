@@ -0,0 +1,53 @@
+
+#ifndef CHANNEL_PINS_H
+#define CHANNEL_PINS_H
+
+#include <Arduino.h>
+#include "Common.h"
+#include "StepperControl.h"
+#include "ServoControl.h"
+#include "LimitSwitch.h"
+
+#define MAX_NUMBER_OF_CHANNELS 3   //rows in the pin table (below)
+
+#if NUMBER_OF_CHANNELS < 1 || NUMBER_OF_CHANNELS > MAX_NUMBER_OF_CHANNELS
+  #error "NUMBER_OF_CHANNELS has to be between 1 and MAX_NUMBER_OF_CHANNELS (add rows to the pin table for more)"
+#endif
+
+//the pins of one rig (channel). Channel 0 is the original rig, its pins are defined in StepperControl.h, ServoControl.h and LimitSwitch.h
+struct ChannelPins {
+    uint8_t step; 
+    uint8_t dir; 
+    uint8_t ms1; 
+    uint8_t ms2; 
+    uint8_t en; 
+    uint8_t servoSignal; 
+    uint8_t limitSwitch; 
+};
+
+//channels 1 and 2 use the Mega's double header (pins 42 to 49, port L), port D (pins 18 to 21) and pins 50 and 51. Check that the 
+//pins are free on the board that is used, the custom board only breaks out some of them. The step and servo pins are 
+//written by interrupts, so they can't be on a port that the LCD library writes to (read-modify-write from loop() would
+//undo a step or a servo pulse edge), which is checked when building (see main.cpp and Display::isOnLcdPort())
+constexpr ChannelPins channelPinTable[MAX_NUMBER_OF_CHANNELS] PROGMEM = {
+    {STEP_PIN, DIR_PIN, MS1_PIN, MS2_PIN, EN_PIN, SIGNAL_PIN, LIMIT_SWITCH_PIN}, 
+    {42, 43, 44, 45, 46, 47, 48}, 
+    {18, 19, 20, 21, 50, 51, 49}   //not port C, which has LCD_WR and LCD_RD on the custom board (pin 38 is channel 0's limit switch)
+}; 
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the port of a pin of MegaCore's "Arduino MEGA pinout" (pins
+ *          0 to 85), when building. digitalPinToPort() reads a table in 
+ *          flash, so it can't be used in a static_assert. 
+ * @param   pin The pin (an Arduino pin number). 
+ * @returns Returns the port's letter ('A' to 'L'). 
+ */
+/*****************************************************************************/
+constexpr char getPinPort(uint8_t pin) {
+    return "EEEEGEHHHHBBBBJJHHDDDDAAAAAAAACCCCCCCCDGGGLLLLLLLLBBBBFFFFFFFFKKKKKKKKGGJJJJJJEEEDDDHH"[pin]; 
+}
+
+void getChannelPins(unsigned char channel, ChannelPins* pPins); 
+
+#endif
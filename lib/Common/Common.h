@@ -1,14 +1,72 @@
-
-#ifndef COMMON_H
-#define COMMON_H
-
-#define SERVO_BOTTOM_POSITION_EEPROM_ADDRESS 1   
-#define FIRST_ZONE_EEPROM_ADDRESS 0
-
-#define CENTER_OFFSET 2  //to imprecisely get the center position of the first zone, you need to take the first zone starting point and add 2 positions
-#define ZONE_OFFSET 6    //each zone is seperated by 6 positions
-#define NUMBER_OF_ZONES 10  
-#define NUMBER_OF_POSITIONS 60 
-
-#endif
-
+
+#ifndef COMMON_H
+#define COMMON_H
+
+#define SERVO_BOTTOM_POSITION_EEPROM_ADDRESS 1   
+#define FIRST_ZONE_EEPROM_ADDRESS 0
+#define LOCK_PROFILE_EEPROM_ADDRESS 2
+#define LOCK_ID_EEPROM_ADDRESS 3
+
+//number of locks that are opened at the same time, each with its own stepper, servo and limit switch (see ChannelPins.h)
+//add -D NUMBER_OF_CHANNELS=2 to the build flags (platformio.ini) to drive a second rig
+#ifndef NUMBER_OF_CHANNELS
+  #define NUMBER_OF_CHANNELS 1
+#endif
+
+//prior histograms of opened combinations, one block per lock profile (see PriorHistogram.h)
+#define PRIOR_HISTOGRAM_EEPROM_ADDRESS 16
+#define PRIOR_HISTOGRAM_BLOCK_SIZE (1 + 3*NUMBER_OF_ZONES)   //magic byte, then one count per zone for each of the three wheels
+#define NUMBER_OF_LOCK_PROFILES 4
+#define NO_LOCK_PROFILE 0   //lock profiles are numbered from 1 to NUMBER_OF_LOCK_PROFILES
+
+//recently opened combinations, most recently used first (see CombinationCache.h)
+#define COMBINATION_CACHE_EEPROM_ADDRESS 160
+#define COMBINATION_CACHE_ENTRY_SIZE 4   //lock ID, first position, second position, third position
+#define COMBINATION_CACHE_SIZE 8
+#define NO_LOCK_ID 0   //lock IDs are numbered from 1 to MAX_LOCK_ID
+#define MAX_LOCK_ID 99
+
+//touch screen calibration (see TouchCalibration.h)
+#define TOUCH_CALIBRATION_EEPROM_ADDRESS 192
+#define TOUCH_CALIBRATION_BLOCK_SIZE (1 + 6*4)   //magic byte, then the six coefficients of the transform (4-byte longs)
+
+//tuned stepper motor step period (see StepperControl.h)
+#define STEP_PERIOD_EEPROM_ADDRESS 224
+#define STEP_PERIOD_BLOCK_SIZE (1 + 2)   //magic byte, then the period in microseconds
+
+//measured index sensor position (see StepperControl.h)
+#define INDEX_STEP_EEPROM_ADDRESS 227
+#define INDEX_STEP_BLOCK_SIZE (1 + 1)   //magic byte, then the step
+
+//the flight recorder's events, saved when a run ends on the error page (see FlightRecorder.h)
+#define FLIGHT_LOG_EEPROM_ADDRESS 256
+#define FLIGHT_RECORDER_EVENTS 64   //a power of 2, the ring buffer takes 8 bytes of SRAM per event
+#define FLIGHT_LOG_BLOCK_SIZE (1 + 1 + 8*FLIGHT_RECORDER_EVENTS)   //magic byte, number of events, then the events (oldest first)
+
+#define CENTER_OFFSET 2  //to imprecisely get the center position of the first zone, you need to take the first zone starting point and add 2 positions
+#define ZONE_OFFSET 6    //each zone is seperated by 6 positions
+#define NUMBER_OF_ZONES 10  
+#define NUMBER_OF_POSITIONS 60 
+
+//makes sure that the EEPROM blocks don't overlap
+#if PRIOR_HISTOGRAM_EEPROM_ADDRESS <= LOCK_ID_EEPROM_ADDRESS
+  #error "The prior histograms overlap the configuration bytes"
+#endif
+#if COMBINATION_CACHE_EEPROM_ADDRESS < PRIOR_HISTOGRAM_EEPROM_ADDRESS + NUMBER_OF_LOCK_PROFILES*PRIOR_HISTOGRAM_BLOCK_SIZE
+  #error "The combination cache overlaps the prior histograms"
+#endif
+#if TOUCH_CALIBRATION_EEPROM_ADDRESS < COMBINATION_CACHE_EEPROM_ADDRESS + COMBINATION_CACHE_SIZE*COMBINATION_CACHE_ENTRY_SIZE
+  #error "The touch calibration overlaps the combination cache"
+#endif
+#if STEP_PERIOD_EEPROM_ADDRESS < TOUCH_CALIBRATION_EEPROM_ADDRESS + TOUCH_CALIBRATION_BLOCK_SIZE
+  #error "The step period overlaps the touch calibration"
+#endif
+#if INDEX_STEP_EEPROM_ADDRESS < STEP_PERIOD_EEPROM_ADDRESS + STEP_PERIOD_BLOCK_SIZE
+  #error "The index position overlaps the step period"
+#endif
+#if FLIGHT_LOG_EEPROM_ADDRESS < INDEX_STEP_EEPROM_ADDRESS + INDEX_STEP_BLOCK_SIZE
+  #error "The flight log overlaps the index position"
+#endif
+
+#endif
+
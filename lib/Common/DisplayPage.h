@@ -0,0 +1,34 @@
+
+#ifndef DISPLAY_PAGE_H
+#define DISPLAY_PAGE_H
+
+//the pages of the UI, which are also the states of the main loop (see loop() in main.cpp). Kept out of Display.h so that
+//the headless build (HeadlessDisplay.h) can use them without the display libraries
+enum class DisplayPage { 
+    notAssigned,
+    home, 
+    results, 
+    error, 
+    setup1, 
+    setup2, 
+    setup3, 
+    setup4,
+    setup5,
+    setup6,
+    setup7,
+    setup8,
+    runProgram1, 
+    runProgram2, 
+    runProgram3,
+    lockProfile,
+    lockId,
+    touchCalibration,
+    stepRate1,
+    stepRate2,
+    stepRate3,
+    stepRate4,
+    channels,
+    diagnostics   //only reached with -D PROFILER_ENABLED (see Profiler.h)
+};
+
+#endif
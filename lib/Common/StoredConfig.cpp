@@ -0,0 +1,17 @@
+
+#include <EEPROM.h>
+#include "StoredConfig.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Reads all the configuration bytes from the EEPROM at once. Used
+ *          at boot, so the servo can be given its saved position before
+ *          anything else is set up. 
+ * @note    The values aren't checked here, each class that uses one checks
+ *          it (the EEPROM reads 0xFF if it was never written). 
+ * @param   pConfig Points to the configuration to be filled in. 
+ */
+/*****************************************************************************/
+void loadStoredConfig(StoredConfig* pConfig) {
+    EEPROM.get(FIRST_ZONE_EEPROM_ADDRESS, *pConfig);   //the first zone is the first byte (see StoredConfig.h)
+}
@@ -0,0 +1,23 @@
+
+#ifndef STORED_CONFIG_H
+#define STORED_CONFIG_H
+
+#include <stddef.h>
+#include "Common.h"
+
+//the configuration bytes at the start of the EEPROM, in address order, so they can be read with one EEPROM.get()
+struct StoredConfig {
+    char firstZone;                        //FIRST_ZONE_EEPROM_ADDRESS
+    unsigned char servoBottomPosition;     //SERVO_BOTTOM_POSITION_EEPROM_ADDRESS
+    unsigned char lockProfile;             //LOCK_PROFILE_EEPROM_ADDRESS
+    unsigned char lockId;                  //LOCK_ID_EEPROM_ADDRESS
+};
+
+static_assert(offsetof(StoredConfig, firstZone) == FIRST_ZONE_EEPROM_ADDRESS, "StoredConfig doesn't match the EEPROM addresses in Common.h");
+static_assert(offsetof(StoredConfig, servoBottomPosition) == SERVO_BOTTOM_POSITION_EEPROM_ADDRESS, "StoredConfig doesn't match the EEPROM addresses in Common.h");
+static_assert(offsetof(StoredConfig, lockProfile) == LOCK_PROFILE_EEPROM_ADDRESS, "StoredConfig doesn't match the EEPROM addresses in Common.h");
+static_assert(offsetof(StoredConfig, lockId) == LOCK_ID_EEPROM_ADDRESS, "StoredConfig doesn't match the EEPROM addresses in Common.h");
+
+void loadStoredConfig(StoredConfig* pConfig);
+
+#endif
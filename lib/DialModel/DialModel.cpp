@@ -0,0 +1,329 @@
+
+#include <Arduino.h>
+#include "DialModel.h"
+#include "StepperControl.h"
+#include "Common.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Forgets the wheel pack state. The model stays unsynchronized until
+ *          the dial has been rotated clockwise far enough to pick up every
+ *          wheel (rotateClockwiseTwice). The drive cam is assumed to be at
+ *          step 0, just like the stepper motor after StepperControl::reconfig().
+ * @note    The model treats the drive cam as the third "wheel" (the third
+ *          number is read directly from the cam), so only the first and
+ *          second wheels are tracked separately. The drive pins take up 
+ *          DRIVE_PIN_WIDTH_STEPS of each turn, so a wheel reads a different
+ *          dial position depending on the direction it was pushed in. The
+ *          coupling between the stepper motor and the dial has 
+ *          COUPLING_BACKLASH_STEPS of play, which is taken up after each 
+ *          direction change before the dial moves. 
+ */
+/*****************************************************************************/
+void DialModel::reset() {
+    _camStep = 0;
+    _couplingSlack = 0;
+    _camGap = 0;
+    _secondWheelGap = 0;
+    _isSynchronized = false;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Updates the wheel pack state after the stepper motor has turned 
+ *          the dial. The dial only follows once the coupling's backlash has
+ *          been taken up, and a wheel is only moved once the wheel in front
+ *          of it has travelled its free travel in the same direction.
+ * @param   direction   The direction that the dial was rotated.
+ * @param   steps   The number of steps that the stepper motor turned.
+ */
+/*****************************************************************************/
+void DialModel::rotate(StepperDirection direction, int steps) {
+    if(direction == StepperDirection::clockwise) {
+        int dialSteps = max(steps - (COUPLING_BACKLASH_STEPS - _couplingSlack), 0);
+        _couplingSlack = min(_couplingSlack + steps, COUPLING_BACKLASH_STEPS);
+        _camStep = (_camStep + steps) % NUMBER_OF_STEPS;
+        _camGap += dialSteps;
+        if(_camGap > FREE_TRAVEL_STEPS) {   //the cam is pushing the second wheel
+            _secondWheelGap += _camGap - FREE_TRAVEL_STEPS;
+            _camGap = FREE_TRAVEL_STEPS;
+            if(_secondWheelGap > FREE_TRAVEL_STEPS) {   //the second wheel is pushing the first wheel
+                _secondWheelGap = FREE_TRAVEL_STEPS;
+            }
+        }
+        if(steps >= 2*FREE_TRAVEL_STEPS + COUPLING_BACKLASH_STEPS) {   //every wheel has been picked up, so the state is now known no matter where the wheels were before
+            _isSynchronized = true;
+        }
+    }
+    else if(direction == StepperDirection::counterclockwise) {
+        int dialSteps = max(steps - _couplingSlack, 0);
+        _couplingSlack = max(_couplingSlack - steps, 0);
+        _camStep = ((_camStep - steps) % NUMBER_OF_STEPS + NUMBER_OF_STEPS) % NUMBER_OF_STEPS;
+        _camGap -= dialSteps;
+        if(_camGap < 0) {
+            _secondWheelGap += _camGap;
+            _camGap = 0;
+            if(_secondWheelGap < 0) {
+                _secondWheelGap = 0;
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Same as rotate(), but the dial is rotated until the stepper motor
+ *          reaches the target step (the same way that the StepperControl
+ *          goTo functions work).
+ * @param   direction   The direction that the dial is rotated.
+ * @param   targetStep  The step number where the stepper motor stops.
+ * @returns Returns the number of steps that were turned.
+ */
+/*****************************************************************************/
+int DialModel::rotateTo(StepperDirection direction, int targetStep) {
+    int steps = 0;
+    if(direction == StepperDirection::clockwise) {
+        steps = (targetStep - _camStep + NUMBER_OF_STEPS) % NUMBER_OF_STEPS;
+    }
+    else if(direction == StepperDirection::counterclockwise) {
+        steps = (_camStep - targetStep + NUMBER_OF_STEPS) % NUMBER_OF_STEPS;
+    }
+    rotate(direction, steps);
+    return steps;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Rotates the model through the full sequence that Algorithm::run()
+ *          dials a combination with (rotateClockwiseTwice, goToFirstPosition,
+ *          rotateCounterclockwiseOnce, goToSecondPosition and 
+ *          goToThirdPosition). 
+ * @param   firstPos    The first position.
+ * @param   secondPos   The second position.
+ * @param   thirdPos    The third position.
+ * @returns Returns the number of steps that were turned.
+ */
+/*****************************************************************************/
+int DialModel::rotateFullSequence(char firstPos, char secondPos, char thirdPos) {
+    int steps = 2*NUMBER_OF_STEPS + NUMBER_OF_STEPS;
+    rotate(StepperDirection::clockwise, 2*NUMBER_OF_STEPS);
+    steps += rotateTo(StepperDirection::clockwise, positionToStep(firstPos));
+    rotate(StepperDirection::counterclockwise, NUMBER_OF_STEPS);
+    steps += rotateTo(StepperDirection::counterclockwise, positionToStep(secondPos));
+    steps += rotateTo(StepperDirection::clockwise, positionToStep(thirdPos));
+    return steps;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if the wheel pack state is known.
+ * @returns Returns true if the model can be used to plan a maneuver.
+ */
+/*****************************************************************************/
+bool DialModel::isSynchronized() {
+    return _isSynchronized;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Moves the drive cam to the step that the stepper motor has been 
+ *          set to by the index sensor (-D INDEX_SENSOR, see 
+ *          StepperControl::homeToIndex() and correctDrift()). 
+ * @note    The dial itself didn't move, only the dead-reckoned step was 
+ *          off, so the wheels keep their gaps to the drive cam. 
+ * @param   camStep The stepper motor's current step. 
+ */
+/*****************************************************************************/
+void DialModel::setCamStep(int camStep) {
+    _camStep = camStep;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Finds the shortest sequence of dial moves that sets the wheel pack
+ *          from its current state to the target combination without
+ *          disturbing the first wheel.
+ * @note    Only maneuvers that keep the first wheel in place are planned. If
+ *          the first position changes (or if a full reset is shorter), the
+ *          caller should use the normal rotateClockwiseTwice sequence. A 
+ *          maneuver has to leave every wheel where the full sequence would 
+ *          (see rotateFullSequence()), so the drive pin widths and the 
+ *          coupling's backlash are made up for when a wheel is pushed from 
+ *          the other side. 
+ * @param   firstPos    The target first position.
+ * @param   secondPos   The target second position.
+ * @param   thirdPos    The target third position.
+ * @param   pManeuver   The planned moves are written here.
+ * @returns Returns true if a maneuver was planned, or false if a full reset
+ *          is needed.
+ */
+/*****************************************************************************/
+bool DialModel::planManeuver(char firstPos, char secondPos, char thirdPos, DialManeuver* pManeuver) {
+    if(!_isSynchronized) {
+        return false;
+    }
+    DialModel target = *this;
+    int fullResetSteps = target.rotateFullSequence(firstPos, secondPos, thirdPos);
+    if(getFirstWheelStep() != target.getFirstWheelStep()) {
+        return false;
+    }
+
+    DialManeuver bestManeuver;
+    bestManeuver.totalSteps = fullResetSteps;
+    bool isManeuverFound = false;
+
+    if(getSecondWheelStep() == target.getSecondWheelStep()) {   //only the drive cam needs to move
+        DialModel simulation = *this;
+        DialManeuver maneuver;
+        maneuver.numberOfMoves = 0;
+        maneuver.totalSteps = 0;
+        if(simulation.planCamMove(target.getDialStep(), &maneuver) && simulation.isSetLike(target) && maneuver.totalSteps < bestManeuver.totalSteps) {
+            bestManeuver = maneuver;
+            isManeuverFound = true;
+        }
+    }
+    else {   //re-pick the second wheel from either side, then bring the drive cam back to the third position
+        const StepperDirection directions[] = {StepperDirection::clockwise, StepperDirection::counterclockwise};
+        for(unsigned char i = 0; i < 2; i++) {
+            DialModel simulation = *this;
+            DialManeuver maneuver;
+            maneuver.numberOfMoves = 0;
+            maneuver.totalSteps = 0;
+
+            int pickUpSteps, pushSteps;   //the backlash and the cam's free travel, then the second wheel is pushed to where the full sequence would leave it
+            if(directions[i] == StepperDirection::clockwise) {
+                pickUpSteps = (COUPLING_BACKLASH_STEPS - _couplingSlack) + (FREE_TRAVEL_STEPS - _camGap);
+                pushSteps = (target.getSecondWheelStep() - getSecondWheelStep() + NUMBER_OF_STEPS) % NUMBER_OF_STEPS;
+            }
+            else {
+                pickUpSteps = _couplingSlack + _camGap;
+                pushSteps = (getSecondWheelStep() - target.getSecondWheelStep() + NUMBER_OF_STEPS) % NUMBER_OF_STEPS;
+            }
+            simulation.addMove(&maneuver, directions[i], pickUpSteps + pushSteps);
+
+            if(simulation.getFirstWheelStep() != target.getFirstWheelStep() || simulation.getSecondWheelStep() != target.getSecondWheelStep()) {
+                continue;   //the second wheel picked up the first wheel
+            }
+            if(simulation.planCamMove(target.getDialStep(), &maneuver) && simulation.isSetLike(target) && maneuver.totalSteps < bestManeuver.totalSteps) {
+                bestManeuver = maneuver;
+                isManeuverFound = true;
+            }
+        }
+    }
+
+    if(isManeuverFound) {
+        *pManeuver = bestManeuver;
+    }
+    return isManeuverFound;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if the wheels and the drive cam are set to the same dial 
+ *          positions as in another model (the lock would open the same). 
+ * @param   other   The other model.
+ * @returns Returns true if every wheel reads the same.
+ */
+/*****************************************************************************/
+bool DialModel::isSetLike(DialModel& other) {
+    return getDialStep() == other.getDialStep() 
+        && getSecondWheelStep() == other.getSecondWheelStep() 
+        && getFirstWheelStep() == other.getFirstWheelStep();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Converts a dial position to a step number the same way that the
+ *          StepperControl goTo functions do (decimal numbers are truncated).
+ * @param   position    The dial position.
+ * @returns Returns the step number.
+ */
+/*****************************************************************************/
+int DialModel::positionToStep(char position) {
+    return map(position, 0, NUMBER_OF_POSITIONS, 0, NUMBER_OF_STEPS);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Adds the shortest drive cam move to the target dial step that does
+ *          not pick up the second wheel. The model is rotated accordingly.
+ * @param   targetDialStep  The dial step where the drive cam should stop.
+ * @param   pManeuver   The move is appended here.
+ * @returns Returns false if the target can't be reached without moving the
+ *          second wheel.
+ */
+/*****************************************************************************/
+bool DialModel::planCamMove(int targetDialStep, DialManeuver* pManeuver) {
+    int clockwiseDialSteps = (targetDialStep - getDialStep() + NUMBER_OF_STEPS) % NUMBER_OF_STEPS;
+    int counterclockwiseDialSteps = (getDialStep() - targetDialStep + NUMBER_OF_STEPS) % NUMBER_OF_STEPS;
+    bool isClockwiseLegal = (_camGap + clockwiseDialSteps <= FREE_TRAVEL_STEPS);
+    bool isCounterclockwiseLegal = (_camGap - counterclockwiseDialSteps >= 0);
+    int clockwiseSteps = clockwiseDialSteps + (COUPLING_BACKLASH_STEPS - _couplingSlack);   //the backlash is taken up first
+    int counterclockwiseSteps = counterclockwiseDialSteps + _couplingSlack;
+
+    if(clockwiseDialSteps == 0) {
+        return true;
+    }
+    if(isClockwiseLegal && (!isCounterclockwiseLegal || clockwiseSteps <= counterclockwiseSteps)) {
+        addMove(pManeuver, StepperDirection::clockwise, clockwiseSteps);
+        return true;
+    }
+    if(isCounterclockwiseLegal) {
+        addMove(pManeuver, StepperDirection::counterclockwise, counterclockwiseSteps);
+        return true;
+    }
+    return false;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Rotates the model and records the move in the maneuver.
+ * @param   pManeuver   The move is appended here.
+ * @param   direction   The direction of the move.
+ * @param   steps   The number of steps in the move.
+ */
+/*****************************************************************************/
+void DialModel::addMove(DialManeuver* pManeuver, StepperDirection direction, int steps) {
+    if(steps == 0 || pManeuver->numberOfMoves >= MAX_MANEUVER_MOVES) {
+        return;
+    }
+    rotate(direction, steps);
+    pManeuver->moves[pManeuver->numberOfMoves].direction = direction;
+    pManeuver->moves[pManeuver->numberOfMoves].steps = steps;
+    pManeuver->numberOfMoves++;
+    pManeuver->totalSteps += steps;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the dial position (as a step number) that the drive cam is 
+ *          at, which is the third number. It lags the stepper motor by the
+ *          slack in the coupling.
+ * @returns Returns the step number.
+ */
+/*****************************************************************************/
+int DialModel::getDialStep() {
+    return (_camStep - _couplingSlack + NUMBER_OF_STEPS) % NUMBER_OF_STEPS;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the dial position (as a step number) that the second wheel
+ *          is set to.
+ * @returns Returns the step number.
+ */
+/*****************************************************************************/
+int DialModel::getSecondWheelStep() {
+    return ((getDialStep() - _camGap) % NUMBER_OF_STEPS + NUMBER_OF_STEPS) % NUMBER_OF_STEPS;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the dial position (as a step number) that the first wheel
+ *          is set to.
+ * @returns Returns the step number.
+ */
+/*****************************************************************************/
+int DialModel::getFirstWheelStep() {
+    return ((getSecondWheelStep() - _secondWheelGap) % NUMBER_OF_STEPS + NUMBER_OF_STEPS) % NUMBER_OF_STEPS;
+}
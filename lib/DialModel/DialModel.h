@@ -0,0 +1,50 @@
+
+#ifndef DIAL_MODEL_H
+#define DIAL_MODEL_H
+
+#include "StepperControl.h"
+
+#define MAX_MANEUVER_MOVES 2   //at most: pick up and push the second wheel, then bring the drive cam to the third position
+
+//slack in the drive train (in steps), set these to the rig's values. With both at 0, the dial is modelled as ideal. 
+#define DRIVE_PIN_WIDTH_STEPS 3     //drive pin and wheel fly together, a wheel is picked up after a full turn minus this much
+#define COUPLING_BACKLASH_STEPS 2   //the stepper motor turns this far after a direction change before the dial follows
+#define FREE_TRAVEL_STEPS (NUMBER_OF_STEPS - DRIVE_PIN_WIDTH_STEPS)
+
+struct DialMove {
+    StepperDirection direction;
+    int steps;
+};
+
+struct DialManeuver {
+    DialMove moves[MAX_MANEUVER_MOVES];
+    unsigned char numberOfMoves;
+    int totalSteps;
+};
+
+class DialModel {
+public:
+    void reset();
+    void rotate(StepperDirection direction, int steps);
+    int rotateTo(StepperDirection direction, int targetStep);
+    int rotateFullSequence(char firstPos, char secondPos, char thirdPos);
+    bool isSynchronized();
+    void setCamStep(int camStep);
+    bool planManeuver(char firstPos, char secondPos, char thirdPos, DialManeuver* pManeuver);
+    bool isSetLike(DialModel& other);
+    static int positionToStep(char position);
+
+private:
+    bool planCamMove(int targetDialStep, DialManeuver* pManeuver);
+    void addMove(DialManeuver* pManeuver, StepperDirection direction, int steps);
+    int getDialStep();
+    int getSecondWheelStep();
+    int getFirstWheelStep();
+    int _camStep;            //stepper motor's step (same as the stepper's _currentStep)
+    int _couplingSlack;      //how far the stepper motor is ahead of the dial (COUPLING_BACKLASH_STEPS after turning clockwise, 0 after turning counterclockwise)
+    int _camGap;             //free travel between the drive cam and the second wheel (0 = pushing counterclockwise, FREE_TRAVEL_STEPS = pushing clockwise)
+    int _secondWheelGap;     //free travel between the second wheel and the first wheel (same convention as _camGap)
+    bool _isSynchronized;    //false until a clockwise rotation long enough to pick up every wheel has been made
+};
+
+#endif
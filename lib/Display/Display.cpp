@@ -1,1360 +1,2569 @@
-
-#include <Adafruit_TFTLCD.h>
-#include <TouchScreen.h>
-#include <EEPROM.h>
-
-// custom fonts
-#include <Fonts/FreeSans12pt7b.h> 
-#include <Fonts/FreeSansBold12pt7b.h>
-#include <Fonts/FreeSans18pt7b.h> 
-#include <Fonts/FreeSans9pt7b.h>
-
-#include "Display.h"
-#include "ServoControl.h"  
-#include "Common.h"
-
-Adafruit_TFTLCD tft(LCD_CS, LCD_CD, LCD_WR, LCD_RD, LCD_RESET);
-TouchScreen ts = TouchScreen(XP, YP, XM, YM, 300);   //X plus, Y plus, X minus, Y minus, resistance accross X plates
-
-/*****************************************************************************/
-/**
- * @brief   Initializations are done here. This function should only be called
- *          once when the microcontroller boots (call in setup).
- */
-/*****************************************************************************/
-void Display::init() {
-    tft.reset();
-    tft.begin(0x9341); 
-    tft.setRotation(1);   // (options are 0, 1, 2, or 3) 
-    reconfig(); 
-}
-
-/*****************************************************************************/
-/**
- * @brief   Similar to init(), but only reconfigures variables and/or states 
- *          that need to be. This function can be used any time after the 
- *          program has been initialized with the init() function. This
- *          function is intended to be used when retarting the program 
- *          without power-cycling.  
- */
-/*****************************************************************************/
-void Display::reconfig() {
-    _previousPage = DisplayPage::notAssigned;
-
-    //initialized to values that will never be equivalent to firstPosition, secondPosition, or thirdPosition (these variables will be assigned different values when the program is running)
-    _previousFirstPosition = PREVIOUS_POSITION_INIT_VALUE; 
-    _previousSecondPosition = PREVIOUS_POSITION_INIT_VALUE; 
-    _previousThirdPosition = PREVIOUS_POSITION_INIT_VALUE;
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws the display page. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_homePage() {
-    if(_previousPage != DisplayPage::home) {   //so that the page is only drawn once  
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-
-        tft.setCursor(15,30);
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        printTextCentered("Combination Lock", 30);
-        printTextCentered("Opener", 60);
-
-        tft.drawFastHLine(0,75, 320, CUSTOM_GREEN);
-        drawSetupButton(BUTTON_RELEASED); 
-        drawRunProgramButton(BUTTON_RELEASED); 
-
-        _previousPage = DisplayPage::home;
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws setup page 1. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_setupPage1() {   
-    if(_previousPage != DisplayPage::setup1) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Setup", 40);
-        drawBackButton(BUTTON_RELEASED);
-        drawExitButton(BUTTON_RELEASED);
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b); 
-
-        tft.setCursor(15,100);
-        tft.print("Please remove the lock if it is");  
-        tft.setCursor(15,122);
-        tft.print("inserted. Press continue to move");
-        tft.setCursor(15,144);
-        tft.print("the shackle-puller to the bottom");
-        tft.setCursor(15,166);
-        tft.print("position.");   
-
-        drawContinueButton(BUTTON_RELEASED); 
-
-        _previousPage = DisplayPage::setup1; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws setup page 2. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_setupPage2() {
-    if(_previousPage != DisplayPage::setup2) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Setup", 40);
-        drawBackButton(BUTTON_RELEASED); 
-        drawExitButton(BUTTON_RELEASED); 
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b);
-        tft.setCursor(15,100);   
-        tft.print("Would you like to change");   
-        tft.setCursor(15,122);
-        tft.print("the saved value for the"); 
-        tft.setCursor(15,144);
-        tft.print("first zone's starting");  
-        tft.setCursor(15,166);
-        tft.print("position?");
-
-        drawStandardBlueButton("Yes", BUTTON_RELEASED, 230, 85, 80);  
-        drawStandardBlueButton("No", BUTTON_RELEASED, 230, 180, 80);
-
-        _previousPage = DisplayPage::setup2; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws setup page 3. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_setupPage3() {
-    if(_previousPage != DisplayPage::setup3) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Setup", 40);
-        drawBackButton(BUTTON_RELEASED); 
-        drawExitButton(BUTTON_RELEASED); 
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setCursor(15,100);
-        tft.setFont(&FreeSans9pt7b); 
-        tft.print("Select a zone starting position.");  
-
-        drawStandardBlueButton("0", BUTTON_RELEASED, 52, 120);  
-        drawStandardBlueButton("1", BUTTON_RELEASED, 107, 120);  
-        drawStandardBlueButton("2", BUTTON_RELEASED, 162, 120);  
-        drawStandardBlueButton("3", BUTTON_RELEASED, 217, 120); 
-        drawStandardBlueButton("4", BUTTON_RELEASED, 52, 175);  
-        drawStandardBlueButton("5", BUTTON_RELEASED, 107, 175); 
-        
-        _previousPage = DisplayPage::setup3; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws setup page 4. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_setupPage4() {
-    if(_previousPage != DisplayPage::setup4) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Setup", 40);
-        drawBackButton(BUTTON_RELEASED); 
-        drawExitButton(BUTTON_RELEASED); 
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b);
-        tft.setCursor(15,100); 
-        tft.print("Would you like to");    
-        tft.setCursor(15,122);
-        tft.print("recalibrate the servo"); 
-        tft.setCursor(15,144);
-        tft.print("motor? This may be");  
-        tft.setCursor(15,166);
-        tft.print("necessary if the pinion");
-        tft.setCursor(15,188);
-        tft.print("was detached");  
-
-        drawStandardBlueButton("Yes", BUTTON_RELEASED, 230, 85, 80);  
-        drawStandardBlueButton("No", BUTTON_RELEASED, 230, 180, 80);
-
-        _previousPage = DisplayPage::setup4; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws setup page 5. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_setupPage5() {
-    if(_previousPage != DisplayPage::setup5) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-
-        printTextCentered("Setup", 40); 
-
-        drawBackButton(BUTTON_RELEASED);
-        drawExitButton(BUTTON_RELEASED);
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b);
-        tft.setCursor(15,100); 
-        tft.print("Adjust the shackle-puller's");  
-        tft.setCursor(15,122);
-        tft.print("height if necessary and");
-        tft.setCursor(15,144);
-        tft.print("then press continue. The");
-        tft.setCursor(15,166);
-        tft.print("height will be saved. ");
-
-        drawStandardBlueButton("Up", BUTTON_RELEASED, 260, 85);    
-        drawStandardBlueButton("Dn", BUTTON_RELEASED, 260, 180);
-        drawContinueButton(BUTTON_RELEASED); 
-
-        _previousPage = DisplayPage::setup5; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws setup page 6. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_setupPage6() {
-    if(_previousPage != DisplayPage::setup6) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Setup", 40);
-        drawBackButton(BUTTON_RELEASED);
-        drawExitButton(BUTTON_RELEASED);
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b); 
-
-        tft.setCursor(15,100);
-        tft.print("Please insert the lock.");  
-
-        drawContinueButton(BUTTON_RELEASED);
-
-        _previousPage = DisplayPage::setup6; 
-    }
-}
-
-
-/*****************************************************************************/
-/**
- * @brief   Draws setup page 7. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_setupPage7() {
-    if(_previousPage != DisplayPage::setup7) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Setup", 40);
-        drawBackButton(BUTTON_RELEASED);
-        drawExitButton(BUTTON_RELEASED);
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b);
-
-        tft.setCursor(15,100); 
-        tft.print("Turn the dial to the zero position. "); 
-
-        drawContinueButton(BUTTON_RELEASED);
-
-        _previousPage = DisplayPage::setup7; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws setup page 8. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_setupPage8() {
-    if(_previousPage != DisplayPage::setup8) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Setup", 40);
-        drawBackButton(BUTTON_RELEASED);
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b);
-        printTextCentered("Setup is complete.", 100);
-
-        drawMainMenuButton(BUTTON_RELEASED); 
-        _previousPage = DisplayPage::setup8; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws run program page 1. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_runProgramPage1() {
-    if(_previousPage != DisplayPage::runProgram1) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Run Program", 40);
-        drawBackButton(BUTTON_RELEASED);
-        drawExitButton(BUTTON_RELEASED);
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b); 
-
-        tft.setCursor(15,100);
-        tft.print("Please remove the lock if it is");  
-        tft.setCursor(15,122);
-        tft.print("inserted. Press continue to move");
-        tft.setCursor(15,144);
-        tft.print("the shackle-puller to the bottom");
-        tft.setCursor(15,166);
-        tft.print("position.");   
-
-        drawContinueButton(BUTTON_RELEASED); 
-
-        _previousPage = DisplayPage::runProgram1; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws run program page 2. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_runProgramPage2() {
-    if(_previousPage != DisplayPage::runProgram2) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Run Program", 40);
-        drawBackButton(BUTTON_RELEASED);
-        drawExitButton(BUTTON_RELEASED);
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b); 
-
-        tft.setCursor(15,100);
-        tft.print("Please insert the lock. Press");    
-        tft.setCursor(15,122);
-        tft.print("continue to run the program.");
-
-        drawContinueButton(BUTTON_RELEASED);
-
-        _previousPage = DisplayPage::runProgram2; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws run program page 3. If this function is called repeatedly,
- *          the page will only be drawn once. The combination is not drawn 
- *          to the screen here, but the dashes between the combination
- *          numbers are drawn because they are not changing variables. 
- */
-/*****************************************************************************/
-void Display::drawOnce_runProgramPage3() {
-    if(_previousPage != DisplayPage::runProgram3) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Run Program", 40);
-        drawExitButton(BUTTON_RELEASED);
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b);
-        printTextCentered("Current combination:", 100);
-
-        tft.setFont(&FreeSans18pt7b);
-
-        tft.setCursor(124, 150); 
-        tft.print("-"); 
-        tft.setCursor(188, 150); 
-        tft.print("-"); 
-
-        _previousPage = DisplayPage::runProgram3; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws the updated combination if the value has changed. The dashes
- *          between the combination numbers will not be drawn here (drawn in
- *          drawOnce_runProgramPage3). 
- * @note    Since drawing to the tft display slows down the program, logic is 
- *          used to determine which numbers will be drawn. 
- * @param   firstPos    The first position that is to be printed to the display. 
- * @param   secondPos   The second position that is to be printed to the display. 
- * @param   thirdPos    The third position that is to be printed to the display. 
- */
-/*****************************************************************************/
-void Display::drawOnce_updatedCombination(char firstPos, char secondPos, char thirdPos) {
-    tft.setTextColor(WHITE);
-    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0   
-    tft.setFont(&FreeSans18pt7b);
-
-    //This is important, because the libraries are sharing pins
-    pinMode(XM, OUTPUT);
-    pinMode(YP, OUTPUT);
-
-    if(firstPos != _previousFirstPosition) {
-        char firstPositionBuffer[2];
-        sprintf(firstPositionBuffer, "%02d", firstPos); 
-        tft.setCursor(78, 150);   
-        tft.fillRect(78, 125, 38, 26, BLACK); 
-        tft.print(firstPositionBuffer); 
-        _previousFirstPosition = firstPos; 
-    }
-    if(secondPos != _previousSecondPosition) {
-        char secondPositionBuffer[2];
-        sprintf(secondPositionBuffer, "%02d", secondPos); 
-        tft.setCursor(142, 150); 
-        tft.fillRect(142, 125, 38, 26, BLACK); 
-        tft.print(secondPositionBuffer);
-        _previousSecondPosition = secondPos;   
-    }
-    if(thirdPos != _previousThirdPosition) {
-        char thirdPositionBuffer[2];
-        sprintf(thirdPositionBuffer, "%02d", thirdPos); 
-        tft.setCursor(206, 150);  
-        tft.fillRect(206, 125, 38, 26, BLACK); 
-        tft.print(thirdPositionBuffer);  
-        _previousThirdPosition = thirdPos;         
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws the results page. If this function is called repeatedly,
- *          the page will only be drawn once. 
- * @param   firstPos    The first position value that successfully opened the
- *          combination lock. This value is printed to the display. 
- * @param   secondPos   Same as firstPos, except for second position.
- * @param   thirdPos    Same as firstPos, except for third position.
- * @param   attemptNumber   The attempt number that successfully opened the
- *          combination lock. This value is printed to the display.  
- * @param   startTimeMillis The time (milliseconds) that the program started 
- *          running. This value is used to calculate the ellapsed time which
- *          is printed to the display. 
- */
-/*****************************************************************************/
-void Display::drawOnce_resultsPage(char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber, unsigned long startTimeMillis) {
-    if(_previousPage != DisplayPage::results) {  
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-
-        tft.fillScreen(BLACK);
-        printTextCentered("Results", 40);    
-        drawExitButton(BUTTON_RELEASED);
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b);
-
-        char positionsBuffer[40];   
-        sprintf(positionsBuffer, "Successful combination : %02d-%02d-%02d", firstPos, secondPos, thirdPos); 
-        tft.setCursor(15,100); 
-        tft.print(positionsBuffer);
-
-        unsigned long elapsedTimeMs = millis() - startTimeMillis;
-        unsigned long allSeconds = elapsedTimeMs / 1000; 
-        int elapsedHours = allSeconds / 3600; 
-        int remainingSeconds = allSeconds % 3600; 
-        int elapsedMinutes = remainingSeconds / 60; 
-        int elapsedSeconds = remainingSeconds % 60; 
-        char timeBuffer[30];   
-        sprintf(timeBuffer, "Elapsed time : %02d:%02d:%02d", elapsedHours, elapsedMinutes, elapsedSeconds); 
-        tft.setCursor(15,122);
-        tft.print(timeBuffer); 
-
-        //note that the second positon cannot be the same value as the first and third
-        unsigned int maxAttempts = (NUMBER_OF_ZONES) * (NUMBER_OF_ZONES -1) * (NUMBER_OF_ZONES -1);   //10*9*9 = 810      
-        char attemptsBuffer[40];   
-        sprintf(attemptsBuffer, "Attempt number : %u out of %u", attemptNumber, maxAttempts);   
-        tft.setCursor(15,144);
-        tft.print(attemptsBuffer);  
-
-        _previousPage = DisplayPage::results; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws the error page. If this function is called repeatedly,
- *          the page will only be drawn once. 
- */
-/*****************************************************************************/
-void Display::drawOnce_errorPage() {
-    if(_previousPage != DisplayPage::error) {
-        tft.setTextColor(WHITE);
-        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-        tft.setFont(&FreeSansBold12pt7b); 
-
-        //This is important, because the libraries are sharing pins
-        pinMode(XM, OUTPUT);
-        pinMode(YP, OUTPUT);
-        
-        tft.fillScreen(BLACK);
-        printTextCentered("Error", 40);
-        drawExitButton(BUTTON_RELEASED);
-        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
-
-        tft.setFont(&FreeSans9pt7b);
-        tft.setCursor(15,100); 
-        tft.print("All combinations have been tried");  
-        tft.setCursor(15,122);
-        tft.print("without success. Possible fixes:"); 
-        tft.setCursor(15,144);
-        tft.print("  - inspect limit switch");
-        tft.setCursor(15,166);
-        tft.print("  - adjust first zone's starting");
-        tft.setCursor(15,188);
-        tft.print("    position if necessary");
-        tft.setCursor(15,210);
-        tft.print("  - recalibrate servo"); 
-
-        _previousPage = DisplayPage::error; 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on the home page. 
- * @return  Returns the updated enumeration for the current page. 
- *          Options: 
- *          DisplayPage::home, DisplayPage::setup1, DisplayPage::runProgram1
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_homePage() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240); 
-        if(point.x>=60 && point.x<=260 && point.y>=100 && point.y<=150){    //setup button
-            drawSetupButton(BUTTON_PRESSED);    
-            while(ts.isTouching());   //wait until the button is released before continuing  
-            return DisplayPage::setup1;
-        } 
-        else if(point.x>=60 && point.x<=260 && point.y>=170 && point.y<=220){   //run program button
-            drawRunProgramButton(BUTTON_PRESSED); 
-            while(ts.isTouching());  
-            return DisplayPage::runProgram1;          
-        }  
-    } 
-    return DisplayPage::home;
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on setup page 1. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_setupPage1() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240); 
-        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button
-            drawBackButton(BUTTON_PRESSED);   
-            while(ts.isTouching());   //wait until the button is released before continuing 
-            return DisplayPage::home;
-        } 
-        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());  
-            return DisplayPage::home;         
-        }
-        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
-            drawContinueButton(BUTTON_PRESSED); 
-            while(ts.isTouching());     
-            return DisplayPage::setup2;                    
-        }
-    } 
-    return DisplayPage::setup1;
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on setup page 2. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_setupPage2() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240); 
-        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button
-            drawBackButton(BUTTON_PRESSED);   
-            while(ts.isTouching());   //wait until the button is released before continuing 
-            return DisplayPage::setup1;
-        } 
-        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());  
-            return DisplayPage::home;         
-        }
-        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
-            drawContinueButton(BUTTON_PRESSED); 
-            while(ts.isTouching());     
-            return DisplayPage::setup3;                    
-        }
-        else if(point.x>=230 && point.x<=310 && point.y>=85 && point.y<=135){    // yes button    
-            drawStandardBlueButton("Yes", BUTTON_PRESSED, 230, 85, 80);  
-            while(ts.isTouching()); 
-            return DisplayPage::setup3;      
-        }     
-        else if(point.x>=230 && point.x<=310 && point.y>=180 && point.y<=230){    // no button    
-            drawStandardBlueButton("No", BUTTON_PRESSED, 230, 180, 80); 
-            while(ts.isTouching());            
-            return DisplayPage::setup4; 
-        } 
-    } 
-    return DisplayPage::setup2; 
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on setup page 3. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_setupPage3() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240);
-        
-        char firstZoneValue;   //for the first zone's center position  
-        
-        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button      
-            drawBackButton(BUTTON_PRESSED); 
-            while(ts.isTouching());     
-            return DisplayPage::setup2; 
-        }
-        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());   
-            return DisplayPage::home; 
-        }   
-        else if(point.x>=52 && point.x<=102 && point.y>=120 && point.y<=170){    // 0 button 
-
-            firstZoneValue = 0 + CENTER_OFFSET; 
-            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET;  //to make sure the first zone is the lowest possible value
-            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue);   //only writes to eeprom if the value is different  
-            drawStandardBlueButton("0", BUTTON_PRESSED, 52, 120);    
-            while(ts.isTouching());      
-            return DisplayPage::setup4; 
-        }     
-        else if(point.x>=107 && point.x<=157 && point.y>=120 && point.y<=170){    // 1 button   
-            firstZoneValue = 1 + CENTER_OFFSET;  
-            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET;  
-            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue);     
-            drawStandardBlueButton("1", BUTTON_PRESSED, 107, 120);    
-            while(ts.isTouching());            
-            return DisplayPage::setup4;
-        }    
-        else if(point.x>=162 && point.x<=212 && point.y>=120 && point.y<=170){    // 2 button 
-            firstZoneValue = 2 + CENTER_OFFSET; 
-            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET;  
-            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue); 
-            drawStandardBlueButton("2", BUTTON_PRESSED, 162, 120);    
-            while(ts.isTouching());               
-            return DisplayPage::setup4;
-        }  
-        else if(point.x>=217 && point.x<=267 && point.y>=120 && point.y<=170){    // 3 button  
-            firstZoneValue = 3 + CENTER_OFFSET; 
-            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET;  
-            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue);     
-            drawStandardBlueButton("3", BUTTON_PRESSED, 217, 120);    
-            while(ts.isTouching());             
-            return DisplayPage::setup4;
-        }    
-        else if(point.x>=52 && point.x<=102 && point.y>=175 && point.y<=225){    // 4 button  
-            firstZoneValue = 4 + CENTER_OFFSET; 
-            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET; 
-            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue);     
-            drawStandardBlueButton("4", BUTTON_PRESSED, 52, 175);    
-            while(ts.isTouching());             
-            return DisplayPage::setup4;
-        } 
-        else if(point.x>=107 && point.x<=157 && point.y>=175 && point.y<=225){    // 5 button
-            firstZoneValue = 5 + CENTER_OFFSET; 
-            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET;  
-            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue);
-            drawStandardBlueButton("5", BUTTON_PRESSED, 107, 175);    
-            while(ts.isTouching());                
-            return DisplayPage::setup4;
-        }  
-    }
-    return DisplayPage::setup3; 
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on setup page 4. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_setupPage4() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240);
-
-        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button          
-            drawBackButton(BUTTON_PRESSED); 
-            while(ts.isTouching());     
-            return DisplayPage::setup3; 
-        }
-        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());   
-            return DisplayPage::home; 
-        }     
-        else if(point.x>=230 && point.x<=310 && point.y>=85 && point.y<=135){    // yes button    
-            drawStandardBlueButton("Yes", BUTTON_PRESSED, 230, 85, 80);  
-            while(ts.isTouching());      
-            return DisplayPage::setup5;
-        }     
-        else if(point.x>=230 && point.x<=310 && point.y>=180 && point.y<=230){    // no button    
-            drawStandardBlueButton("No", BUTTON_PRESSED, 230, 180, 80); 
-            while(ts.isTouching());            
-            return DisplayPage::setup6; 
-        }   
-    }
-    return DisplayPage::setup4;
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on setup page 5. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_setupPage5() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240);
-
-        if(point.x>10 && point.x<60 && point.y>10 && point.y<50){    //back button      
-            drawBackButton(BUTTON_PRESSED); 
-            while(ts.isTouching());    
-            return DisplayPage::setup4;
-        }
-        else if(point.x>260 && point.x<310 && point.y>10 && point.y<50){    //exit button   
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());     
-            return DisplayPage::home;
-        }
-        else if(point.x>45 && point.x<195 && point.y>180 && point.y<230){    //continue button  
-            drawContinueButton(BUTTON_PRESSED); 
-            while(ts.isTouching());    
-            unsigned char currentServoPos = servoControl.getCurrentPosition();   
-            EEPROM.update(SERVO_BOTTOM_POSITION_EEPROM_ADDRESS, currentServoPos);   //only writes to eeprom if the value is different    
-            return DisplayPage::setup6; 
-        }             
-        else if(point.x>260 && point.x<310 && point.y>85 && point.y<135){   //up button
-            drawStandardBlueButton("Up", BUTTON_PRESSED, 260, 85);   
-            while(ts.isTouching());      
-            drawStandardBlueButton("Up", BUTTON_RELEASED, 260, 85);   
-            servoControl.moveUpOneIncrement(); 
-        }    
-        else if(point.x>260 && point.x<310 && point.y>180 && point.y<230){   //down button
-            drawStandardBlueButton("Dn", BUTTON_PRESSED, 260, 180 );
-            while(ts.isTouching());   
-            drawStandardBlueButton("Dn", BUTTON_RELEASED, 260, 180 );    
-            servoControl.moveDownOneIncrement();  
-        } 
-    }
-    return DisplayPage::setup5;
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on setup page 6. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_setupPage6() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240);
-
-        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button   
-            drawBackButton(BUTTON_PRESSED); 
-            while(ts.isTouching());        
-            return DisplayPage::setup5; 
-        }
-        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());     
-            return DisplayPage::home; 
-        }
-        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
-            drawContinueButton(BUTTON_PRESSED); 
-            while(ts.isTouching());           
-            return DisplayPage::setup7; 
-        } 
-    }
-    return DisplayPage::setup6;
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on setup page 7. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_setupPage7() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240);
-
-        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button 
-            drawBackButton(BUTTON_PRESSED); 
-            while(ts.isTouching());          
-            return DisplayPage::setup6; 
-        }
-        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());     
-            return DisplayPage::home;
-        }
-        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button  
-            drawContinueButton(BUTTON_PRESSED); 
-            while(ts.isTouching());          
-            return DisplayPage::setup8; 
-        }    
-    }
-    return DisplayPage::setup7;
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on setup page 8. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_setupPage8() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240);
-
-        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button 
-            drawBackButton(BUTTON_PRESSED); 
-            while(ts.isTouching());          
-            return DisplayPage::setup7;
-        }
-        else if(point.x>=50 && point.x<=270 && point.y>=180 && point.y<=230){    //main menu button   
-            drawMainMenuButton(BUTTON_PRESSED);  
-            while(ts.isTouching());       
-            return DisplayPage::home;
-        } 
-    }
-    return DisplayPage::setup8;
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on 
- *          run program page 1. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_runProgramPage1() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240); 
-        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button
-            drawBackButton(BUTTON_PRESSED);   
-            while(ts.isTouching());   //wait until the button is released before continuing 
-            return DisplayPage::home;
-        } 
-        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());  
-            return DisplayPage::home;         
-        }
-        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
-            drawContinueButton(BUTTON_PRESSED); 
-            while(ts.isTouching());     
-            return DisplayPage::runProgram2;                    
-        }
-    } 
-    return DisplayPage::runProgram1;   
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on 
- *          run program page 2. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_runProgramPage2() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240); 
-        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button
-            drawBackButton(BUTTON_PRESSED);   
-            while(ts.isTouching());   //wait until the button is released before continuing 
-            return DisplayPage::runProgram1;
-        } 
-        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());  
-            return DisplayPage::home;         
-        }
-        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
-            drawContinueButton(BUTTON_PRESSED); 
-            while(ts.isTouching());     
-            return DisplayPage::runProgram3;                    
-        }
-    } 
-    return DisplayPage::runProgram2;
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on 
- *          run program page 3. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_runProgramPage3() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240); 
-        if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());  
-            return DisplayPage::home;         
-        }
-    } 
-    return DisplayPage::runProgram3;   
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on the
- *          results page. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_resultsPage() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240); 
-        if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());  
-            return DisplayPage::home;         
-        }
-    } 
-    return DisplayPage::results; 
-}
-
-/*****************************************************************************/
-/**
- * @brief   Checks to see if any buttons have been pressed on the
- *          error page. 
- * @return  Returns the updated enumeration for the current page, depending
- *          on whether or not a button has been pressed. If no button has  
- *          been pressed, return the same page.
- */
-/*****************************************************************************/
-DisplayPage Display::monitorInputs_errorPage() {
-    TSPoint point = ts.getPoint();  //Get touch point  
-    if (point.z > ts.pressureThreshhold){ 
-        point.x = map(point.x, TS_MINX, TS_MAXX, 0, 320);   
-        point.y = map(point.y, TS_MINY, TS_MAXY, 0, 240); 
-        if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
-            drawExitButton(BUTTON_PRESSED); 
-            while(ts.isTouching());  
-            return DisplayPage::home;         
-        }
-    } 
-    return DisplayPage::error; 
-}
-
-/*****************************************************************************/
-/**
- * @brief   Prints texted so that it is centered on the screen. Similar to
- *          tft.print(). The X coordinate is calculated in this function.
- * @note    tft.setTextColor(), tft.setTextSize(), and tft.setFont() need
- *          to be called before this function, just like when 
- *          using tft.print().  
- * @note    This function was tested for FreeSans12pt7b font. Other fonts 
- *          may not be centered if they are used. 
- * @param   inputText   This is the text that will be printed to the display. 
- * @param   y   This is the Y coordinate at which the text will be printed. 
- */
-/*****************************************************************************/
-void Display::printTextCentered(const char inputText[], unsigned int y) {
-
-    int16_t  x1, y1;
-    uint16_t w, h, cursorPosition;
-
-    //all we really need from this function is the width of the text
-    tft.getTextBounds(inputText, 0, y, &x1, &y1, &w, &h); // x coordinate set to 0, but doesn't really matter because it will be calculated to center the text
-
-    cursorPosition = (320/2) - (w/2);   //calculating the cursor position so that the text will be centered on the screen
-    cursorPosition = cursorPosition - 2;  //offsetting X position by -2 seems to center the text better (at least for FreeSans12pt7b font)
-
-    tft.setCursor(cursorPosition, y); 
-    tft.print(inputText);
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws the setup button. The button will have different colours
- *          depending on whether it is pressed or released.     
- * @param   buttonState The state of the button is passed into this function.
- *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
- */
-/*****************************************************************************/
-void Display::drawSetupButton(bool buttonState) {
-    //This is important, because the libraries are sharing pins
-    pinMode(XM, OUTPUT);
-    pinMode(YP, OUTPUT);
-
-    if(buttonState == BUTTON_RELEASED) {
-        tft.fillRoundRect(60, 100, 200, 50, 10, CUSTOM_GREEN);   
-        tft.drawRoundRect(60, 100, 200, 50, 10, WHITE);   
-    }
-    else if(buttonState == BUTTON_PRESSED) {
-        tft.fillRoundRect(60, 100, 200, 50, 10, BLACK);   
-        tft.drawRoundRect(60, 100, 200, 50, 10, CUSTOM_GREEN);    
-    }      
-    tft.setTextColor(WHITE);
-    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-    tft.setFont(&FreeSans12pt7b);           
-    printTextCentered("Setup", 132);
-} 
-
-/*****************************************************************************/
-/**
- * @brief   Draws the run program button. The button will have different 
- *          colours depending on whether it is pressed or released.       
- * @param   buttonState The state of the button is passed into this function.
- *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
- */
-/*****************************************************************************/
-void Display::drawRunProgramButton(bool buttonState) {
-    //This is important, because the libraries are sharing pins
-    pinMode(XM, OUTPUT);
-    pinMode(YP, OUTPUT);
-
-    if(buttonState == BUTTON_RELEASED) {
-        tft.fillRoundRect(60, 170, 200, 50, 10, CUSTOM_GREEN);   
-        tft.drawRoundRect(60, 170, 200, 50, 10, WHITE);   
-    }
-    else if(buttonState == BUTTON_PRESSED) {
-        tft.fillRoundRect(60, 170, 200, 50, 10, BLACK);   
-        tft.drawRoundRect(60, 170, 200, 50, 10, CUSTOM_GREEN);    
-    }      
-    tft.setTextColor(WHITE);
-    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-    tft.setFont(&FreeSans12pt7b);           
-    printTextCentered("Run Program", 202);
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws the back button. The button will have different colours
- *          depending on whether it is pressed or released.       
- * @param   buttonState The state of the button is passed into this function.
- *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
- */
-/*****************************************************************************/
-void Display::drawBackButton(bool buttonState) {
-    //This is important, because the libraries are sharing pins
-    pinMode(XM, OUTPUT);
-    pinMode(YP, OUTPUT);
-
-    if(buttonState == BUTTON_RELEASED) {
-        tft.fillRoundRect(10, 10, 50, 40, 10, CUSTOM_GREEN);  
-        tft.drawRoundRect(10, 10, 50, 40, 10, WHITE); 
-    }
-    else if(buttonState == BUTTON_PRESSED) {
-        tft.fillRoundRect(10, 10, 50, 40, 10, BLACK); 
-        tft.drawRoundRect(10, 10, 50, 40, 10, CUSTOM_GREEN);    
-    }          
-    tft.setTextColor(WHITE);
-    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-    tft.setCursor(19,38);
-    tft.setFont(&FreeSans18pt7b);                 
-    tft.print("<-");
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws the exit button. The button will have different colours
- *          depending on whether it is pressed or released.     
- * @param   buttonState The state of the button is passed into this function.
- *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
- */
-/*****************************************************************************/
-void Display::drawExitButton(bool buttonState) {
-    //This is important, because the libraries are sharing pins
-    pinMode(XM, OUTPUT);
-    pinMode(YP, OUTPUT);
-
-    if(buttonState == BUTTON_RELEASED) {
-        tft.fillRoundRect(260, 10, 50, 40, 10, RED);   
-        tft.drawRoundRect(260, 10, 50, 40, 10, WHITE);  
-    }
-    else if(buttonState == BUTTON_PRESSED) {
-        tft.fillRoundRect(260, 10, 50, 40, 10, BLACK);   
-        tft.drawRoundRect(260, 10, 50, 40, 10, RED);     
-    }      
-    tft.setTextColor(WHITE);
-    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-    tft.setCursor(276, 39);  
-    tft.setFont(&FreeSans18pt7b);                 
-    tft.print("x");
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws the continue button. The button will have different colours
- *          depending on whether it is pressed or released.       
- * @param   buttonState The state of the button is passed into this function.
- *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
- */
-/*****************************************************************************/
-void Display::drawContinueButton(bool buttonState) {
-    //This is important, because the libraries are sharing pins
-    pinMode(XM, OUTPUT);
-    pinMode(YP, OUTPUT);
-
-    if(buttonState == BUTTON_RELEASED) {
-        tft.fillRoundRect(45, 180, 150, 50, 10, CUSTOM_GREEN);   
-        tft.drawRoundRect(45, 180, 150, 50, 10, WHITE);   
-    }
-    else if(buttonState == BUTTON_PRESSED) {
-        tft.fillRoundRect(45, 180, 150, 50, 10, BLACK);   
-        tft.drawRoundRect(45, 180, 150, 50, 10, CUSTOM_GREEN);    
-    }      
-    tft.setTextColor(WHITE);
-    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-    tft.setCursor(72,212);  //X cursor postion = (rect X coordinate + (rect width/2) - text width/2) -2    //Y cursor position = rect Y coordinate + 32    //formulas work for FreeSans12pt7b   //text width found with printTextInfoToSerial function
-    tft.setFont(&FreeSans12pt7b);           
-    tft.print("Continue");   //text width = 92 pixels    
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws a standard blue button. The button will have different colours
- *          depending on whether it is pressed or released. 
- * @param   inputText   This is the text that will be printed as the button's
- *          label.        
- * @param   buttonState The state of the button is passed into this function.
- *          Options: BUTTON_RELEASED, BUTTON_PRESSED      
- * @param   rectX   The X coordinate that determines where the left side of the
- *          button is located on the display. 
- * @param   rectY   The Y coordinate that determines where the top of the button
- *          is located on the display.
- * @param   rectWidth   Determines the width of the button (in pixels). This
- *          parameter has a default value of 50 (look in header file) and 
- *          does not need to be specified.  
- */
-/*****************************************************************************/
-void Display::drawStandardBlueButton(const char inputText[], bool buttonState, int16_t rectX, int16_t rectY, int16_t rectWidth) {
-    tft.setTextColor(WHITE);
-    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-    tft.setFont(&FreeSans12pt7b);   
-
-    //This is important, because the libraries are sharing pins
-    pinMode(XM, OUTPUT);
-    pinMode(YP, OUTPUT);
-
-    int16_t  x1, y1;
-    uint16_t textWidth, textHeight;       
-    tft.getTextBounds(inputText, 0, 0, &x1, &y1, &textWidth, &textHeight); 
-
-    if(buttonState == BUTTON_RELEASED) {
-        tft.fillRoundRect(rectX, rectY, rectWidth, 50, 10, BLUE);  
-        tft.drawRoundRect(rectX, rectY, rectWidth, 50, 10, WHITE);   
-    }
-    else if(buttonState == BUTTON_PRESSED) {
-        tft.fillRoundRect(rectX, rectY, rectWidth, 50, 10, BLACK); 
-        tft.drawRoundRect(rectX, rectY, rectWidth, 50, 10, BLUE);    
-    }  
-    tft.setCursor((rectX + rectWidth/2 - textWidth/2) -2, rectY + 32);  //this line sets the cursor position with the correct offset to center the text with the button (works for FreeSans12pt7b only)                       
-    tft.print(inputText);     
-}
-
-/*****************************************************************************/
-/**
- * @brief   Draws the main menu button. The button will have different colours
- *          depending on whether it is pressed or released.       
- * @param   buttonState The state of the button is passed into this function.
- *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
- */
-/*****************************************************************************/
-void Display::drawMainMenuButton(bool buttonState) {
-    //This is important, because the libraries are sharing pins
-    pinMode(XM, OUTPUT);
-    pinMode(YP, OUTPUT);
-
-    if(buttonState == BUTTON_RELEASED) {
-        tft.fillRoundRect(50, 180, 220, 50, 10, CUSTOM_GREEN);   
-        tft.drawRoundRect(50, 180, 220, 50, 10, WHITE);   
-    }
-    else if(buttonState == BUTTON_PRESSED) {
-        tft.fillRoundRect(50, 180, 220, 50, 10, BLACK);   
-        tft.drawRoundRect(50, 180, 220, 50, 10, CUSTOM_GREEN);    
-    }      
-    tft.setTextColor(WHITE);
-    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
-    tft.setFont(&FreeSans12pt7b);           
-    printTextCentered("Go To Main Menu", 212);
-}
-
-
-
+
+//Either the in-tree driver or the Adafruit_TFTLCD fork for the environment is used (see platformio.ini)
+#ifdef IN_TREE_LCD_DRIVER
+  #include "ILI9341Parallel.h"
+#else
+  #include <Adafruit_TFTLCD.h>
+#endif
+#include <TouchScreen.h>
+#include <EEPROM.h>
+
+// custom fonts
+#ifdef FULL_FONTS
+  #include <Fonts/FreeSans12pt7b.h> 
+  #include <Fonts/FreeSansBold12pt7b.h>
+  #include <Fonts/FreeSans18pt7b.h> 
+  #include <Fonts/FreeSans9pt7b.h>
+#else
+  #include "SubsetFonts.h"   //only the glyphs the UI prints, generated when building (see tools/subset_fonts.py)
+#endif
+
+#include "DigitGlyphs.h"   //generated from FreeSans18pt7b when building (see tools/generate_digit_glyphs.py)
+#include "Display.h"
+#include "TextFormat.h"
+#include "ServoControl.h"  
+#include "CombinationCache.h"
+#include "Profiler.h"
+#include "MemoryMonitor.h"
+#include "Algorithm.h"
+#include "Common.h"
+
+#ifdef IN_TREE_LCD_DRIVER
+  ILI9341Parallel tft(LCD_CS, LCD_CD, LCD_WR, LCD_RD, LCD_RESET);
+#else
+  Adafruit_TFTLCD tft(LCD_CS, LCD_CD, LCD_WR, LCD_RD, LCD_RESET);
+#endif
+TouchScreen ts = TouchScreen(XP, YP, XM, YM, TOUCH_X_PLATE_RESISTANCE);   //X plus, Y plus, X minus, Y minus, resistance accross X plates
+
+//where the crosses are drawn on the touch calibration page (spread out, and not on one line)
+const int calibrationTargetX[NUMBER_OF_CALIBRATION_POINTS] = {30, 290, 160}; 
+const int calibrationTargetY[NUMBER_OF_CALIBRATION_POINTS] = {215, 215, 130}; 
+
+/*****************************************************************************/
+/**
+ * @brief   Initializations are done here. This function should only be called
+ *          once when the microcontroller boots (call in setup).
+ * @note    The LCD isn't set up here, since its reset and initialization 
+ *          take about 0.8 s of delays. It's brought up by bringUp(), which 
+ *          is called from loop(). 
+ */
+/*****************************************************************************/
+void Display::init() {
+    _bus.init(&ts); 
+#if defined(PRINT_REDRAW_TIME) || defined(DISPLAY_BENCHMARK) || defined(CHECK_TEXT_METRICS) || defined(PRINT_BUS_SWITCHES) || defined(PRINT_BOOT_TIME) || defined(PRINT_INDEX_DRIFT) || defined(PRINT_LOOP_RATE)
+    Serial.begin(115200); 
+#endif
+    _isBroughtUp = false; 
+    _bringUpStep = 0; 
+    _bringUpStepStartMs = millis(); 
+    _bringUpWaitMs = 0; 
+    reconfig(); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Brings up the LCD one step at a time, without waiting for the
+ *          delays that the display needs between steps. This function
+ *          should be called repeatedly (in loop) until it returns true. 
+ * @note    With the Adafruit_TFTLCD library, the reset and initialization
+ *          can't be split, so they are done in one call (the delays are 
+ *          still spent there). 
+ * @returns Returns true once the LCD is ready to be drawn on. 
+ */
+/*****************************************************************************/
+bool Display::bringUp() {
+    if(_isBroughtUp) {
+        return true; 
+    }
+    if(millis() - _bringUpStepStartMs < _bringUpWaitMs) {
+        return false; 
+    }
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+#ifdef IN_TREE_LCD_DRIVER
+    if(_bringUpStep < ILI9341_INIT_STEPS) {
+        _bringUpWaitMs = tft.initStep(_bringUpStep); 
+        _bringUpStepStartMs = millis(); 
+        _bringUpStep++; 
+        return false; 
+    }
+#else
+    tft.reset();
+    tft.begin(0x9341); 
+#endif
+    tft.setRotation(1);   // (options are 0, 1, 2, or 3) 
+#ifdef CHECK_TEXT_METRICS
+    checkTextMetrics(); 
+#endif
+#ifdef DISPLAY_BENCHMARK
+    printDrawTimes(); 
+    reconfig(); 
+#endif
+    _isBroughtUp = true; 
+    return true; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Similar to init(), but only reconfigures variables and/or states 
+ *          that need to be. This function can be used any time after the 
+ *          program has been initialized with the init() function. This
+ *          function is intended to be used when retarting the program 
+ *          without power-cycling.  
+ */
+/*****************************************************************************/
+void Display::reconfig() {
+    _previousPage = DisplayPage::notAssigned;
+
+    //initialized to values that will never be equivalent to firstPosition, secondPosition, or thirdPosition (these variables will be assigned different values when the program is running)
+    _previousFirstPosition = PREVIOUS_POSITION_INIT_VALUE; 
+    _previousSecondPosition = PREVIOUS_POSITION_INIT_VALUE; 
+    _previousThirdPosition = PREVIOUS_POSITION_INIT_VALUE;
+
+    for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+        _isChannelDrawn[i] = false; 
+    }
+}
+
+#ifdef CHECK_TEXT_METRICS
+/*****************************************************************************/
+/**
+ * @brief   Compares the text sizes measured when building (UiStringMetrics.h)
+ *          with tft.getTextBounds() for every string in the string table, 
+ *          and prints the strings that don't match to the serial monitor 
+ *          (115200 baud). Should be run after updating the GFX library or
+ *          the fonts. 
+ */
+/*****************************************************************************/
+void Display::checkTextMetrics() {
+    unsigned char mismatches = 0; 
+    for(unsigned char i = 0; i < (unsigned char)UiString::count; i++) {
+        UiString id = (UiString)i; 
+        int16_t  x1, y1;
+        uint16_t w, h;
+        setUiFont(getUiStringFont(id)); 
+        tft.getTextBounds(getUiString(id), 0, 0, &x1, &y1, &w, &h); 
+        if(w != getUiStringWidth(id) || h != getUiStringHeight(id)) {
+            Serial.print(F("Text metrics don't match for: ")); 
+            Serial.println(getUiString(id)); 
+            mismatches++; 
+        }
+    }
+    Serial.print(F("Text metrics checked, mismatches: ")); 
+    Serial.println(mismatches); 
+}
+#endif
+
+#ifdef DISPLAY_BENCHMARK
+/*****************************************************************************/
+/**
+ * @brief   Draws every page once and prints how long each one took to the
+ *          serial monitor (115200 baud). Build each display environment with
+ *          -D DISPLAY_BENCHMARK to compare the display drivers. 
+ */
+/*****************************************************************************/
+void Display::printDrawTimes() {
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    unsigned long startTimeMicros = micros(); 
+    tft.fillScreen(BLACK); 
+    printDrawTime(F("fillScreen"), startTimeMicros); 
+
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_homePage(); 
+    printDrawTime(F("home page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_setupPage1(); 
+    printDrawTime(F("setup1 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_setupPage2(); 
+    printDrawTime(F("setup2 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_setupPage3(); 
+    printDrawTime(F("setup3 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_setupPage4(); 
+    printDrawTime(F("setup4 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_setupPage5(); 
+    printDrawTime(F("setup5 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_setupPage6(); 
+    printDrawTime(F("setup6 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_setupPage7(); 
+    printDrawTime(F("setup7 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_setupPage8(); 
+    printDrawTime(F("setup8 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_runProgramPage1(); 
+    printDrawTime(F("runProgram1 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_runProgramPage2(); 
+    printDrawTime(F("runProgram2 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_runProgramPage3(); 
+    printDrawTime(F("runProgram3 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_lockProfilePage(); 
+    printDrawTime(F("lockProfile page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_lockIdPage(); 
+    printDrawTime(F("lockId page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_touchCalibrationPage(); 
+    printDrawTime(F("touchCalibration page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_stepRatePage1(); 
+    printDrawTime(F("stepRate1 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_stepRatePage2(500); 
+    printDrawTime(F("stepRate2 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_stepRatePage3(); 
+    printDrawTime(F("stepRate3 page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_stepRatePage4(1600, true); 
+    printDrawTime(F("stepRate4 page"), startTimeMicros); 
+#ifdef DIAGNOSTICS_PAGE
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_diagnosticsPage(); 
+    printDrawTime(F("diagnostics page"), startTimeMicros); 
+#endif
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_channelsPage(); 
+    printDrawTime(F("channels page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_resultsPage(12, 34, 56, 100, millis(), 0, 0); 
+    printDrawTime(F("results page"), startTimeMicros); 
+    _previousPage = DisplayPage::notAssigned; 
+    startTimeMicros = micros(); 
+    drawOnce_errorPage(); 
+    printDrawTime(F("error page"), startTimeMicros); 
+
+    _previousPage = DisplayPage::notAssigned; 
+    drawOnce_runProgramPage3(); 
+    startTimeMicros = micros(); 
+    drawOnce_updatedCombination(12, 34, 56); 
+    printDrawTime(F("combination readout"), startTimeMicros); 
+
+    _previousPage = DisplayPage::notAssigned; 
+    drawOnce_channelsPage(); 
+    startTimeMicros = micros(); 
+    drawOnce_updatedChannel(0, 12, 34, 56, 100, 1000, AlgorithmState::running); 
+    printDrawTime(F("channel row"), startTimeMicros); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints the time since startTimeMicros to the serial monitor. 
+ * @param   label   What was drawn. 
+ * @param   startTimeMicros The time (microseconds) when drawing started. 
+ */
+/*****************************************************************************/
+void Display::printDrawTime(const __FlashStringHelper* label, unsigned long startTimeMicros) {
+    unsigned long drawTimeMicros = micros() - startTimeMicros; 
+    Serial.print(label); 
+    Serial.print(F(" (us): ")); 
+    Serial.println(drawTimeMicros); 
+}
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the display page. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_homePage() {
+    if(_previousPage != DisplayPage::home) {   //so that the page is only drawn once  
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+
+        tft.setCursor(15,30);
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        printStringCentered(UiString::homeTitle1, 30);
+        printStringCentered(UiString::homeTitle2, 60);
+
+        tft.drawFastHLine(0,75, 320, CUSTOM_GREEN);
+        drawSetupButton(BUTTON_RELEASED); 
+        drawRunProgramButton(BUTTON_RELEASED); 
+
+        _previousPage = DisplayPage::home;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws setup page 1. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_setupPage1() {   
+    if(_previousPage != DisplayPage::setup1) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::setupTitle, 40);
+        drawBackButton(BUTTON_RELEASED);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b); 
+
+        tft.setCursor(15,100);
+        printString(UiString::removeLock1);  
+        tft.setCursor(15,122);
+        printString(UiString::removeLock2);
+        tft.setCursor(15,144);
+        printString(UiString::removeLock3);
+        tft.setCursor(15,166);
+        printString(UiString::removeLock4);   
+
+        drawContinueButton(BUTTON_RELEASED); 
+
+        _previousPage = DisplayPage::setup1; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws setup page 2. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_setupPage2() {
+    if(_previousPage != DisplayPage::setup2) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::setupTitle, 40);
+        drawBackButton(BUTTON_RELEASED); 
+        drawExitButton(BUTTON_RELEASED); 
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        tft.setCursor(15,100);   
+        printString(UiString::changeFirstZone1);   
+        tft.setCursor(15,122);
+        printString(UiString::changeFirstZone2); 
+        tft.setCursor(15,144);
+        printString(UiString::changeFirstZone3);  
+        tft.setCursor(15,166);
+        printString(UiString::changeFirstZone4);
+
+        drawStandardBlueButton(UiString::yesButton, BUTTON_RELEASED, 230, 85, 80);  
+        drawStandardBlueButton(UiString::noButton, BUTTON_RELEASED, 230, 180, 80);
+
+        _previousPage = DisplayPage::setup2; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws setup page 3. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_setupPage3() {
+    if(_previousPage != DisplayPage::setup3) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::setupTitle, 40);
+        drawBackButton(BUTTON_RELEASED); 
+        drawExitButton(BUTTON_RELEASED); 
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setCursor(15,100);
+        tft.setFont(&FreeSans9pt7b); 
+        printString(UiString::selectFirstZone);  
+
+        drawStandardBlueButton(UiString::button0, BUTTON_RELEASED, 52, 120);  
+        drawStandardBlueButton(UiString::button1, BUTTON_RELEASED, 107, 120);  
+        drawStandardBlueButton(UiString::button2, BUTTON_RELEASED, 162, 120);  
+        drawStandardBlueButton(UiString::button3, BUTTON_RELEASED, 217, 120); 
+        drawStandardBlueButton(UiString::button4, BUTTON_RELEASED, 52, 175);  
+        drawStandardBlueButton(UiString::button5, BUTTON_RELEASED, 107, 175); 
+        
+        _previousPage = DisplayPage::setup3; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws setup page 4. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_setupPage4() {
+    if(_previousPage != DisplayPage::setup4) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::setupTitle, 40);
+        drawBackButton(BUTTON_RELEASED); 
+        drawExitButton(BUTTON_RELEASED); 
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        tft.setCursor(15,100); 
+        printString(UiString::recalibrateServo1);    
+        tft.setCursor(15,122);
+        printString(UiString::recalibrateServo2); 
+        tft.setCursor(15,144);
+        printString(UiString::recalibrateServo3);  
+        tft.setCursor(15,166);
+        printString(UiString::recalibrateServo4);
+        tft.setCursor(15,188);
+        printString(UiString::recalibrateServo5);  
+
+        drawStandardBlueButton(UiString::yesButton, BUTTON_RELEASED, 230, 85, 80);  
+        drawStandardBlueButton(UiString::noButton, BUTTON_RELEASED, 230, 180, 80);
+
+        _previousPage = DisplayPage::setup4; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws setup page 5. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_setupPage5() {
+    if(_previousPage != DisplayPage::setup5) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+
+        printStringCentered(UiString::setupTitle, 40); 
+
+        drawBackButton(BUTTON_RELEASED);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        tft.setCursor(15,100); 
+        printString(UiString::adjustHeight1);  
+        tft.setCursor(15,122);
+        printString(UiString::adjustHeight2);
+        tft.setCursor(15,144);
+        printString(UiString::adjustHeight3);
+        tft.setCursor(15,166);
+        printString(UiString::adjustHeight4);
+
+        drawStandardBlueButton(UiString::upButton, BUTTON_RELEASED, 260, 85);    
+        drawStandardBlueButton(UiString::downButton, BUTTON_RELEASED, 260, 180);
+        drawContinueButton(BUTTON_RELEASED); 
+
+        _previousPage = DisplayPage::setup5; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws setup page 6. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_setupPage6() {
+    if(_previousPage != DisplayPage::setup6) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::setupTitle, 40);
+        drawBackButton(BUTTON_RELEASED);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b); 
+
+        tft.setCursor(15,100);
+        printString(UiString::insertLock);  
+
+        drawContinueButton(BUTTON_RELEASED);
+
+        _previousPage = DisplayPage::setup6; 
+    }
+}
+
+
+/*****************************************************************************/
+/**
+ * @brief   Draws setup page 7. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_setupPage7() {
+    if(_previousPage != DisplayPage::setup7) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::setupTitle, 40);
+        drawBackButton(BUTTON_RELEASED);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+
+        tft.setCursor(15,100); 
+        printString(UiString::turnDialToZero); 
+
+        drawContinueButton(BUTTON_RELEASED);
+
+        _previousPage = DisplayPage::setup7; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws setup page 8. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_setupPage8() {
+    if(_previousPage != DisplayPage::setup8) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::setupTitle, 40);
+        drawBackButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        printStringCentered(UiString::setupComplete, 100);
+
+        drawStandardBlueButton(UiString::touchButton, BUTTON_RELEASED, 30, 115, 125); 
+        drawStandardBlueButton(UiString::stepRateButton, BUTTON_RELEASED, 165, 115, 125); 
+#ifdef DIAGNOSTICS_PAGE
+        drawStandardBlueButton(UiString::diagnosticsButton, BUTTON_RELEASED, 220, 10, 90); 
+#endif
+        drawMainMenuButton(BUTTON_RELEASED); 
+        _previousPage = DisplayPage::setup8; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws run program page 1. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_runProgramPage1() {
+    if(_previousPage != DisplayPage::runProgram1) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::runProgramTitle, 40);
+        drawBackButton(BUTTON_RELEASED);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b); 
+
+        tft.setCursor(15,100);
+        printString(UiString::removeLock1);  
+        tft.setCursor(15,122);
+        printString(UiString::removeLock2);
+        tft.setCursor(15,144);
+        printString(UiString::removeLock3);
+        tft.setCursor(15,166);
+        printString(UiString::removeLock4);   
+
+        drawContinueButton(BUTTON_RELEASED); 
+
+        _previousPage = DisplayPage::runProgram1; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws run program page 2. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_runProgramPage2() {
+    if(_previousPage != DisplayPage::runProgram2) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::runProgramTitle, 40);
+        drawBackButton(BUTTON_RELEASED);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b); 
+
+        tft.setCursor(15,100);
+        printString(UiString::insertLockToRun1);    
+        tft.setCursor(15,122);
+        printString(UiString::insertLockToRun2);
+
+        drawContinueButton(BUTTON_RELEASED);
+
+        _previousPage = DisplayPage::runProgram2; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws run program page 3. If this function is called repeatedly,
+ *          the page will only be drawn once. The combination is not drawn 
+ *          to the screen here, but the dashes between the combination
+ *          numbers are drawn because they are not changing variables. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_runProgramPage3() {
+    if(_previousPage != DisplayPage::runProgram3) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::runProgramTitle, 40);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        printStringCentered(UiString::currentCombination, 100);
+
+        tft.setFont(&FreeSans18pt7b);
+
+        tft.setCursor(124, 150); 
+        printString(UiString::combinationDash); 
+        tft.setCursor(188, 150); 
+        printString(UiString::combinationDash); 
+
+        tft.drawRect(PROGRESS_BAR_X, PROGRESS_BAR_Y, PROGRESS_BAR_WIDTH, PROGRESS_BAR_HEIGHT, WHITE); 
+        _isProgressDrawn = false; 
+        _previousProgressFillWidth = 0; 
+
+        _previousPage = DisplayPage::runProgram3; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the lock profile page. If this function is called 
+ *          repeatedly, the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_lockProfilePage() {
+    if(_previousPage != DisplayPage::lockProfile) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::runProgramTitle, 40);
+        drawBackButton(BUTTON_RELEASED);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setCursor(15,100);
+        tft.setFont(&FreeSans9pt7b); 
+        printString(UiString::selectLockProfile);  
+
+        drawStandardBlueButton(UiString::button1, BUTTON_RELEASED, 52, 120);  
+        drawStandardBlueButton(UiString::button2, BUTTON_RELEASED, 107, 120);  
+        drawStandardBlueButton(UiString::button3, BUTTON_RELEASED, 162, 120);  
+        drawStandardBlueButton(UiString::button4, BUTTON_RELEASED, 217, 120); 
+        drawStandardBlueButton(UiString::noneButton, BUTTON_RELEASED, 52, 175, 105);  
+
+        _previousPage = DisplayPage::lockProfile; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the lock ID page. If this function is called repeatedly, 
+ *          the page will only be drawn once. The lock ID starts at the value
+ *          that was saved the last time. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_lockIdPage() {
+    if(_previousPage != DisplayPage::lockId) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::runProgramTitle, 40);
+        drawBackButton(BUTTON_RELEASED);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setCursor(15,100);
+        tft.setFont(&FreeSans9pt7b); 
+        printString(UiString::selectLockId);  
+
+        drawStandardBlueButton(UiString::minusButton, BUTTON_RELEASED, 52, 120);  
+        drawStandardBlueButton(UiString::plusButton, BUTTON_RELEASED, 217, 120); 
+        drawContinueButton(BUTTON_RELEASED); 
+
+        _selectedLockId = EEPROM.read(LOCK_ID_EEPROM_ADDRESS); 
+        if(_selectedLockId > MAX_LOCK_ID) {
+            _selectedLockId = NO_LOCK_ID; 
+        }
+        drawLockIdValue(); 
+
+        _previousPage = DisplayPage::lockId; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the touch calibration page, with the first cross to be
+ *          touched. If this function is called repeatedly, the page will 
+ *          only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_touchCalibrationPage() {
+    if(_previousPage != DisplayPage::touchCalibration) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::touchCalibrationTitle, 40);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        printStringCentered(UiString::touchTheCross, 95);
+
+        _calibrationPointIndex = 0; 
+        drawCalibrationTarget(_calibrationPointIndex, WHITE); 
+
+        _previousPage = DisplayPage::touchCalibration; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws step rate page 1, which explains the step rate tuning. If 
+ *          this function is called repeatedly, the page will only be drawn 
+ *          once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_stepRatePage1() {
+    if(_previousPage != DisplayPage::stepRate1) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::stepRateTitle, 40);
+        drawBackButton(BUTTON_RELEASED);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        tft.setCursor(15,100); 
+        printString(UiString::stepRateIntro1); 
+        tft.setCursor(15,122); 
+        printString(UiString::stepRateIntro2); 
+        tft.setCursor(15,144); 
+        printString(UiString::stepRateIntro3); 
+
+        drawStandardBlueButton(UiString::startButton, BUTTON_RELEASED, 45, 180, 150); 
+        _previousPage = DisplayPage::stepRate1; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws step rate page 2, which is shown while a trial is running. 
+ *          If this function is called repeatedly, the page will only be 
+ *          drawn once per trial (with the index sensor, the trials follow 
+ *          each other without going through page 3). 
+ * @note    There are no buttons on this page, the touch screen isn't read 
+ *          while the stepper is moving. 
+ * @param   stepsPerSecond  The step rate of the trial. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_stepRatePage2(unsigned int stepsPerSecond) {
+    if(_previousPage != DisplayPage::stepRate2 || stepsPerSecond != _previousStepsPerSecond) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::stepRateTitle, 40);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        tft.setCursor(15,100); 
+        printString(UiString::stepRateTesting); 
+        tft.print(stepsPerSecond); 
+        _previousStepsPerSecond = stepsPerSecond; 
+
+        _previousPage = DisplayPage::stepRate2; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws step rate page 3, which asks if the dial is still at zero 
+ *          after a trial. If this function is called repeatedly, the page 
+ *          will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_stepRatePage3() {
+    if(_previousPage != DisplayPage::stepRate3) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::stepRateTitle, 40);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        tft.setCursor(15,100); 
+        printString(UiString::stepRateCheck1); 
+        tft.setCursor(15,122); 
+        printString(UiString::stepRateCheck2); 
+
+        drawStandardBlueButton(UiString::yesButton, BUTTON_RELEASED, 230, 85, 80);  
+        drawStandardBlueButton(UiString::noButton, BUTTON_RELEASED, 230, 180, 80);
+
+        _previousPage = DisplayPage::stepRate3; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws step rate page 4, which shows the saved step rate. If this 
+ *          function is called repeatedly, the page will only be drawn once. 
+ * @param   stepsPerSecond  The saved step rate. 
+ * @param   isTuned     False if no trial passed (the default rate is used). 
+ */
+/*****************************************************************************/
+void Display::drawOnce_stepRatePage4(unsigned int stepsPerSecond, bool isTuned) {
+    if(_previousPage != DisplayPage::stepRate4) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::stepRateTitle, 40);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        if(isTuned) {
+            tft.setCursor(15,100); 
+            printString(UiString::stepRateSaved); 
+            tft.print(stepsPerSecond); 
+        }
+        else {
+            tft.setCursor(15,100); 
+            printString(UiString::stepRateNotTuned1); 
+            tft.setCursor(15,122); 
+            printString(UiString::stepRateNotTuned2); 
+        }
+
+        drawContinueButton(BUTTON_RELEASED);
+        _previousPage = DisplayPage::stepRate4; 
+    }
+}
+
+#ifdef DIAGNOSTICS_PAGE
+/*****************************************************************************/
+/**
+ * @brief   Draws the diagnostics page. With -D PROFILER_ENABLED, it shows 
+ *          the profiler's results (see Profiler.h): the mean and the longest
+ *          time of each section, and a histogram where bar k is the number 
+ *          of times shorter than 2^k us (the bar's height is the number of 
+ *          bits in the count). With -D MEMORY_MONITOR, it shows the size of
+ *          the global variables and the smallest that the free SRAM has 
+ *          been (see MemoryMonitor.h). The results are also printed to the 
+ *          serial port. If this function is called repeatedly, the page 
+ *          will only be drawn once. 
+ * @note    The results aren't updated while the page is shown, press reset
+ *          to clear the profiler's results and draw the page again. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_diagnosticsPage() {
+    if(_previousPage != DisplayPage::diagnostics) {
+        profiler.print();   //before drawing, so that the page's own draw isn't part of the printed results
+        memoryMonitor.print(); 
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::diagnosticsTitle, 40);
+        drawBackButton(BUTTON_RELEASED);
+#ifdef PROFILER_ENABLED
+        drawStandardBlueButton(UiString::resetButton, BUTTON_RELEASED, 235, 10, 75); 
+#endif
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setTextColor(WHITE);
+        tft.setFont(&FreeSans9pt7b);
+#ifdef PROFILER_ENABLED
+        tft.setCursor(10,84);
+        printString(UiString::profileSectionHeader); 
+        tft.setCursor(100,84);
+        printString(UiString::profileMeanHeader); 
+        tft.setCursor(170,84);
+        printString(UiString::profileMaxHeader); 
+        tft.setCursor(250,84);
+        printString(UiString::profileHistogramHeader); 
+
+        for(unsigned char i = 0; i < (unsigned char)ProfileSection::count; i++) {
+            ProfileSection section = (ProfileSection)i; 
+            int16_t baselineY = 102 + i*16; 
+            tft.setCursor(10, baselineY);
+            printString((UiString)((unsigned char)UiString::profileLoop + i));   //the labels are listed in the same order as ProfileSection
+            if(profiler.getCount(section) == 0) {
+                continue; 
+            }
+            tft.setCursor(100, baselineY);
+            tft.print(profiler.getMeanMicros(section)); 
+            tft.setCursor(170, baselineY);
+            tft.print(profiler.getMaxMicros(section)); 
+
+            for(unsigned char bucket = 0; bucket < PROFILER_BUCKETS; bucket++) {
+                unsigned int count = profiler.getBucket(section, bucket); 
+                unsigned char bitCount = 0; 
+                while(count != 0) {
+                    count >>= 1; 
+                    bitCount++; 
+                }
+                if(bitCount > 0) {
+                    int16_t barHeight = (bitCount*3 + 3) / 4;   //1 to 12 pixels
+                    tft.fillRect(246 + bucket*3, baselineY - barHeight, 2, barHeight, CUSTOM_GREEN); 
+                }
+            }
+        }
+#endif
+
+#ifdef MEMORY_MONITOR
+        char memoryBuffer[40];   //"Static RAM : 3942    Min free : 3570"
+        char* textEnd = formatUiString(memoryBuffer, UiString::staticRam); 
+        textEnd = formatUnsigned(textEnd, memoryMonitor.getStaticBytes()); 
+        textEnd = formatUiString(textEnd, UiString::minFreeRam); 
+        formatUnsigned(textEnd, memoryMonitor.getMinFreeBytes()); 
+  #ifdef PROFILER_ENABLED
+        printTextCentered(memoryBuffer, 234);   //under the profiler's rows
+  #else
+        printTextCentered(memoryBuffer, 100); 
+  #endif
+#endif
+
+        _previousPage = DisplayPage::diagnostics; 
+    }
+}
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the updated combination if the value has changed. The dashes
+ *          between the combination numbers will not be drawn here (drawn in
+ *          drawOnce_runProgramPage3). 
+ * @note    Since drawing to the tft display slows down the program, logic is 
+ *          used to determine which numbers will be drawn. This should only 
+ *          be called in a UI window (see UiScheduler.h). 
+ * @param   firstPos    The first position that is to be printed to the display. 
+ * @param   secondPos   The second position that is to be printed to the display. 
+ * @param   thirdPos    The third position that is to be printed to the display. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_updatedCombination(char firstPos, char secondPos, char thirdPos) {
+    if(firstPos == _previousFirstPosition && secondPos == _previousSecondPosition && thirdPos == _previousThirdPosition) {
+        return; 
+    }
+    PROFILE_SCOPE(ProfileSection::drawCombination); 
+#ifdef PRINT_REDRAW_TIME
+    unsigned long startTimeMicros = micros(); 
+#endif
+
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    if(firstPos != _previousFirstPosition) {
+        drawTwoDigitNumber(firstPos, 78, 150); 
+        _previousFirstPosition = firstPos; 
+    }
+    if(secondPos != _previousSecondPosition) {
+        drawTwoDigitNumber(secondPos, 142, 150); 
+        _previousSecondPosition = secondPos;   
+    }
+    if(thirdPos != _previousThirdPosition) {
+        drawTwoDigitNumber(thirdPos, 206, 150); 
+        _previousThirdPosition = thirdPos;         
+    }
+
+#ifdef PRINT_REDRAW_TIME
+    Serial.print(F("Combination redraw time (us): ")); 
+    Serial.println(micros() - startTimeMicros); 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the progress bar and the estimated time remaining on the 
+ *          run program page (3). The bar only grows by the newly filled
+ *          part, and nothing is drawn if the last update was less than
+ *          PROGRESS_REFRESH_INTERVAL_MS ago. 
+ * @note    This should only be called in a UI window (see UiScheduler.h),
+ *          so that drawing doesn't slow the dial down. 
+ * @param   attemptNumber   The number of attempts made so far. 
+ * @param   plannedAttempts The number of attempts that the search can take
+ *          (see Algorithm::getPlannedAttempts()). 
+ * @param   remainingMs The estimated time remaining (milliseconds), or 0 if 
+ *          it isn't known yet. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_updatedProgress(unsigned int attemptNumber, unsigned int plannedAttempts, unsigned long remainingMs) {
+    if(_isProgressDrawn && millis() - _previousProgressDrawMs < PROGRESS_REFRESH_INTERVAL_MS) {
+        return; 
+    }
+    _isProgressDrawn = true; 
+    _previousProgressDrawMs = millis(); 
+    PROFILE_SCOPE(ProfileSection::drawProgress); 
+
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    if(attemptNumber > plannedAttempts) {
+        attemptNumber = plannedAttempts; 
+    }
+    int16_t fillWidth = 0; 
+    if(plannedAttempts > 0) {
+        fillWidth = (long)(PROGRESS_BAR_WIDTH - 2) * attemptNumber / plannedAttempts; 
+    }
+    if(fillWidth > _previousProgressFillWidth) {
+        tft.fillRect(PROGRESS_BAR_X + 1 + _previousProgressFillWidth, PROGRESS_BAR_Y + 1, fillWidth - _previousProgressFillWidth, PROGRESS_BAR_HEIGHT - 2, CUSTOM_GREEN); 
+    }
+    else if(fillWidth < _previousProgressFillWidth) {   //more attempts were planned (a new search pass started)
+        tft.fillRect(PROGRESS_BAR_X + 1 + fillWidth, PROGRESS_BAR_Y + 1, _previousProgressFillWidth - fillWidth, PROGRESS_BAR_HEIGHT - 2, BLACK); 
+    }
+    _previousProgressFillWidth = fillWidth; 
+
+    char progressBuffer[40];   //"attempts / planned    ETA hh:mm:ss"
+    char* textEnd = formatUnsigned(progressBuffer, attemptNumber); 
+    textEnd = formatUiString(textEnd, UiString::progressSeparator); 
+    textEnd = formatUnsigned(textEnd, plannedAttempts); 
+    textEnd = formatUiString(textEnd, UiString::progressEta); 
+    if(remainingMs == 0 && attemptNumber < plannedAttempts) {
+        formatUiString(textEnd, UiString::unknownEta); 
+    }
+    else {
+        formatTime(textEnd, remainingMs / 1000); 
+    }
+    tft.setTextColor(WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+    tft.setFont(&FreeSans9pt7b);
+    tft.fillRect(0, PROGRESS_BAR_Y + PROGRESS_BAR_HEIGHT + 6, 320, 24, BLACK); 
+    printTextCentered(progressBuffer, PROGRESS_BAR_Y + PROGRESS_BAR_HEIGHT + 24); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the channels page, which shows the progress of every 
+ *          channel when several locks are opened at once (-D 
+ *          NUMBER_OF_CHANNELS=2 or 3). If this function is called 
+ *          repeatedly, the page will only be drawn once. The channels' rows
+ *          are drawn by drawOnce_updatedChannel(). 
+ */
+/*****************************************************************************/
+void Display::drawOnce_channelsPage() {
+    if(_previousPage != DisplayPage::channels) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::channelsTitle, 40);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+            _isChannelDrawn[i] = false; 
+        }
+
+        _previousPage = DisplayPage::channels; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws one channel's row on the channels page: the combination 
+ *          being tried and the attempts, or the result once the channel is
+ *          done. The row is only redrawn if something has changed, and at 
+ *          most once per PROGRESS_REFRESH_INTERVAL_MS while the channel is
+ *          running. 
+ * @note    The steps themselves are sent by the Timer1 interrupt, but the 
+ *          other channels don't get their next step queued while a row is
+ *          being drawn. 
+ * @param   channel The channel (0 to NUMBER_OF_CHANNELS - 1). 
+ * @param   firstPos    The first position being tried. 
+ * @param   secondPos   The second position being tried. 
+ * @param   thirdPos    The third position being tried. 
+ * @param   attemptNumber   The number of attempts made so far. 
+ * @param   plannedAttempts The number of attempts that the search can take
+ *          (see Algorithm::getPlannedAttempts()). 
+ * @param   state   The channel's state, from Algorithm::run(). 
+ */
+/*****************************************************************************/
+void Display::drawOnce_updatedChannel(unsigned char channel, char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber, unsigned int plannedAttempts, AlgorithmState state) {
+    if(_isChannelDrawn[channel]) {
+        if(state == _previousChannelState[channel] && attemptNumber == _previousChannelAttempts[channel] && thirdPos == _previousChannelThirdPosition[channel]) {
+            return; 
+        }
+        if(state == AlgorithmState::running && millis() - _previousChannelDrawMs[channel] < PROGRESS_REFRESH_INTERVAL_MS) {
+            return; 
+        }
+    }
+    PROFILE_SCOPE(ProfileSection::drawChannel); 
+    _isChannelDrawn[channel] = true; 
+    _previousChannelDrawMs[channel] = millis(); 
+    _previousChannelAttempts[channel] = attemptNumber; 
+    _previousChannelThirdPosition[channel] = thirdPos; 
+    _previousChannelState[channel] = state; 
+
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    char rowBuffer[48];   //"Ch 1 :  12-34-56    attempts / planned"
+    char* textEnd = formatUiString(rowBuffer, UiString::channelPrefix); 
+    textEnd = formatUnsigned(textEnd, channel + 1); 
+    textEnd = formatUiString(textEnd, UiString::channelSeparator); 
+    const char positions[3] = {firstPos, secondPos, thirdPos}; 
+    for(unsigned char i = 0; i < 3; i++) {
+        if(i > 0) {
+            textEnd = formatUiString(textEnd, UiString::channelDash); 
+        }
+        if(positions[i] == NO_POSITION_ASSIGNED) {
+            textEnd = formatUiString(textEnd, UiString::noPosition); 
+        }
+        else {
+            textEnd = formatUnsigned(textEnd, positions[i], 2); 
+        }
+    }
+    textEnd = formatUiString(textEnd, UiString::channelGap); 
+    if(state == AlgorithmState::complete) {
+        formatUiString(textEnd, UiString::channelOpened); 
+    }
+    else if(state == AlgorithmState::error) {
+        formatUiString(textEnd, UiString::channelFailed); 
+    }
+    else {
+        textEnd = formatUnsigned(textEnd, attemptNumber); 
+        textEnd = formatUiString(textEnd, UiString::progressSeparator); 
+        formatUnsigned(textEnd, plannedAttempts); 
+    }
+
+    int16_t baselineY = CHANNEL_ROW_Y + channel*CHANNEL_ROW_SPACING; 
+    tft.setTextColor((state == AlgorithmState::complete) ? CUSTOM_GREEN : WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+    tft.setFont(&FreeSans9pt7b);
+    tft.fillRect(0, baselineY - 18, 320, 24, BLACK); 
+    tft.setCursor(15, baselineY); 
+    tft.print(rowBuffer); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws a number from 0 to 99 with two digits (a leading zero is 
+ *          added), in the FreeSans18pt7b font. 
+ * @note    Each digit is a pre-rendered bitmap (DigitGlyphs.h) that also
+ *          covers the background, so the old digits don't need to be erased
+ *          first. Add -D GFX_TEXT_READOUT to the build flags to use the GFX
+ *          text rendering instead (to compare the redraw time, see 
+ *          PRINT_REDRAW_TIME). 
+ * @param   number  The number to be drawn. 
+ * @param   x   X coordinate of the left side of the first digit. 
+ * @param   baselineY   Y coordinate of the baseline (same as the GFX cursor).
+ */
+/*****************************************************************************/
+void Display::drawTwoDigitNumber(char number, int16_t x, int16_t baselineY) {
+#ifdef GFX_TEXT_READOUT
+    char numberBuffer[UNSIGNED_TEXT_SIZE]; 
+    formatUnsigned(numberBuffer, number, 2); 
+    tft.setTextColor(WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0   
+    tft.setFont(&FreeSans18pt7b);
+    tft.setCursor(x, baselineY); 
+    tft.fillRect(x, baselineY - 25, 38, 26, BLACK); 
+    tft.print(numberBuffer); 
+#else
+    drawDigitGlyph(number / 10, x, baselineY); 
+    drawDigitGlyph(number % 10, x + DIGIT_GLYPH_WIDTH, baselineY); 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws one pre-rendered digit (white on black). The address window
+ *          is set once, and the run-length encoded pixels are decoded into a
+ *          small buffer that is pushed to the display. 
+ * @param   digit   The digit to be drawn (0 to 9). 
+ * @param   x   X coordinate of the left side of the digit. 
+ * @param   baselineY   Y coordinate of the baseline (same as the GFX cursor).
+ */
+/*****************************************************************************/
+void Display::drawDigitGlyph(unsigned char digit, int16_t x, int16_t baselineY) {
+    int16_t y = baselineY - DIGIT_GLYPH_BASELINE; 
+    tft.setAddrWindow(x, y, x + DIGIT_GLYPH_WIDTH - 1, y + DIGIT_GLYPH_HEIGHT - 1); 
+
+    uint16_t pixelBuffer[GLYPH_PIXEL_BUFFER_SIZE]; 
+    uint8_t bufferedPixels = 0; 
+    bool isFirstPush = true;   //the first push starts writing at the top left corner of the address window
+    uint16_t color = BLACK;    //runs alternate between background and foreground, starting with background
+    uint16_t endIndex = pgm_read_word(&digitGlyphOffsets[digit + 1]); 
+    for(uint16_t i = pgm_read_word(&digitGlyphOffsets[digit]); i < endIndex; i++) {
+        uint8_t runLength = pgm_read_byte(&digitGlyphRuns[i]); 
+        while(runLength > 0) {
+            pixelBuffer[bufferedPixels] = color; 
+            bufferedPixels++; 
+            runLength--; 
+            if(bufferedPixels == GLYPH_PIXEL_BUFFER_SIZE) {
+                tft.pushColors(pixelBuffer, bufferedPixels, isFirstPush); 
+                isFirstPush = false; 
+                bufferedPixels = 0; 
+            }
+        }
+        color = (color == BLACK) ? WHITE : BLACK; 
+    }
+    if(bufferedPixels > 0) {
+        tft.pushColors(pixelBuffer, bufferedPixels, isFirstPush); 
+    }
+    tft.setAddrWindow(0, 0, tft.width() - 1, tft.height() - 1);   //back to the full screen for the GFX drawing functions
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the results page. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ * @param   firstPos    The first position value that successfully opened the
+ *          combination lock. This value is printed to the display. 
+ * @param   secondPos   Same as firstPos, except for second position.
+ * @param   thirdPos    Same as firstPos, except for third position.
+ * @param   attemptNumber   The attempt number that successfully opened the
+ *          combination lock. This value is printed to the display.  
+ * @param   startTimeMillis The time (milliseconds) that the program started 
+ *          running. This value is used to calculate the ellapsed time which
+ *          is printed to the display. 
+ * @param   expectedAttempts    The expected number of attempts under the 
+ *          selected lock profile's prior. This value is only printed if it
+ *          is not 0 (a lock profile was selected). 
+ * @param   searchPass  The search pass that opened the lock (see 
+ *          Algorithm::getSearchPass()). 
+ */
+/*****************************************************************************/
+void Display::drawOnce_resultsPage(char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber, unsigned long startTimeMillis, unsigned int expectedAttempts, unsigned char searchPass) {
+    if(_previousPage != DisplayPage::results) {  
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::resultsTitle, 40);    
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+
+        //each line is printed as a label from the string table followed by the value(s)
+        char valueBuffer[TIME_TEXT_SIZE]; 
+        char* valueEnd; 
+
+        tft.setCursor(15,100); 
+        printString(UiString::successfulCombination); 
+        valueEnd = formatUnsigned(valueBuffer, firstPos, 2); 
+        *valueEnd++ = '-'; 
+        valueEnd = formatUnsigned(valueEnd, secondPos, 2); 
+        *valueEnd++ = '-'; 
+        formatUnsigned(valueEnd, thirdPos, 2); 
+        tft.print(valueBuffer);
+
+        unsigned long elapsedTimeMs = millis() - startTimeMillis;
+        tft.setCursor(15,122);
+        printString(UiString::elapsedTime); 
+        formatTime(valueBuffer, elapsedTimeMs / 1000); 
+        tft.print(valueBuffer); 
+
+        unsigned long attemptsPerMinuteTenths = 0; 
+        if(elapsedTimeMs >= 100) {
+            attemptsPerMinuteTenths = ((unsigned long)attemptNumber * 6000) / (elapsedTimeMs / 100); 
+        }
+        tft.setCursor(15,166);
+        printString(UiString::attemptsPerMinute); 
+        tft.print(attemptsPerMinuteTenths / 10); 
+        tft.print('.'); 
+        tft.print(attemptsPerMinuteTenths % 10); 
+
+        //note that the second positon cannot be the same value as the first and third
+        unsigned int maxAttempts = (NUMBER_OF_ZONES) * (NUMBER_OF_ZONES -1) * (NUMBER_OF_ZONES -1);   //10*9*9 = 810      
+        tft.setCursor(15,144);
+        printString(UiString::attemptNumber); 
+        tft.print(attemptNumber); 
+        if(searchPass == 0) {
+            printString(UiString::attemptsOutOf); 
+            tft.print(maxAttempts); 
+        }
+        else {   //progressive search (Algorithm.h) went past the zone-center pass
+            printString(UiString::searchPassStart); 
+            tft.print((unsigned int)(searchPass + 1)); 
+            printString(UiString::searchPassOf); 
+            tft.print(NUMBER_OF_SEARCH_PASSES); 
+            printString(UiString::searchPassEnd); 
+        }
+
+        if(expectedAttempts > 0) {
+            tft.setCursor(15,188);
+            printString(UiString::expectedAttempts); 
+            tft.print(expectedAttempts); 
+        }
+
+        _previousPage = DisplayPage::results; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the error page. If this function is called repeatedly,
+ *          the page will only be drawn once. 
+ */
+/*****************************************************************************/
+void Display::drawOnce_errorPage() {
+    if(_previousPage != DisplayPage::error) {
+        PROFILE_SCOPE(ProfileSection::drawPage); 
+        tft.setTextColor(WHITE);
+        tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+        tft.setFont(&FreeSansBold12pt7b); 
+
+        _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+        
+        tft.fillScreen(BLACK);
+        printStringCentered(UiString::errorTitle, 40);
+        drawExitButton(BUTTON_RELEASED);
+        tft.drawFastHLine(0,65, 320, CUSTOM_GREEN);
+
+        tft.setFont(&FreeSans9pt7b);
+        tft.setCursor(15,100); 
+        printString(UiString::errorText1);  
+        tft.setCursor(15,122);
+        printString(UiString::errorText2); 
+        tft.setCursor(15,144);
+        printString(UiString::errorText3);
+        tft.setCursor(15,166);
+        printString(UiString::errorText4);
+        tft.setCursor(15,188);
+        printString(UiString::errorText5);
+        tft.setCursor(15,210);
+        printString(UiString::errorText6); 
+
+        _previousPage = DisplayPage::error; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on the home page. 
+ * @return  Returns the updated enumeration for the current page. 
+ *          Options: 
+ *          DisplayPage::home, DisplayPage::setup1, DisplayPage::runProgram1
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_homePage() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=60 && point.x<=260 && point.y>=100 && point.y<=150){    //setup button
+            drawSetupButton(BUTTON_PRESSED);    
+            while(_bus.isTouching());   //wait until the button is released before continuing  
+            return DisplayPage::setup1;
+        } 
+        else if(point.x>=60 && point.x<=260 && point.y>=170 && point.y<=220){   //run program button
+            drawRunProgramButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());  
+            return DisplayPage::runProgram1;          
+        }  
+    } 
+    return DisplayPage::home;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on setup page 1. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_setupPage1() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button
+            drawBackButton(BUTTON_PRESSED);   
+            while(_bus.isTouching());   //wait until the button is released before continuing 
+            return DisplayPage::home;
+        } 
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());  
+            return DisplayPage::home;         
+        }
+        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
+            drawContinueButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::setup2;                    
+        }
+    } 
+    return DisplayPage::setup1;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on setup page 2. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_setupPage2() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button
+            drawBackButton(BUTTON_PRESSED);   
+            while(_bus.isTouching());   //wait until the button is released before continuing 
+            return DisplayPage::setup1;
+        } 
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());  
+            return DisplayPage::home;         
+        }
+        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
+            drawContinueButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::setup3;                    
+        }
+        else if(point.x>=230 && point.x<=310 && point.y>=85 && point.y<=135){    // yes button    
+            drawStandardBlueButton(UiString::yesButton, BUTTON_PRESSED, 230, 85, 80);  
+            while(_bus.isTouching()); 
+            return DisplayPage::setup3;      
+        }     
+        else if(point.x>=230 && point.x<=310 && point.y>=180 && point.y<=230){    // no button    
+            drawStandardBlueButton(UiString::noButton, BUTTON_PRESSED, 230, 180, 80); 
+            while(_bus.isTouching());            
+            return DisplayPage::setup4; 
+        } 
+    } 
+    return DisplayPage::setup2; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on setup page 3. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_setupPage3() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        
+        char firstZoneValue;   //for the first zone's center position  
+        
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button      
+            drawBackButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::setup2; 
+        }
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());   
+            return DisplayPage::home; 
+        }   
+        else if(point.x>=52 && point.x<=102 && point.y>=120 && point.y<=170){    // 0 button 
+
+            firstZoneValue = 0 + CENTER_OFFSET; 
+            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET;  //to make sure the first zone is the lowest possible value
+            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue);   //only writes to eeprom if the value is different  
+            drawStandardBlueButton(UiString::button0, BUTTON_PRESSED, 52, 120);    
+            while(_bus.isTouching());      
+            return DisplayPage::setup4; 
+        }     
+        else if(point.x>=107 && point.x<=157 && point.y>=120 && point.y<=170){    // 1 button   
+            firstZoneValue = 1 + CENTER_OFFSET;  
+            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET;  
+            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue);     
+            drawStandardBlueButton(UiString::button1, BUTTON_PRESSED, 107, 120);    
+            while(_bus.isTouching());            
+            return DisplayPage::setup4;
+        }    
+        else if(point.x>=162 && point.x<=212 && point.y>=120 && point.y<=170){    // 2 button 
+            firstZoneValue = 2 + CENTER_OFFSET; 
+            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET;  
+            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue); 
+            drawStandardBlueButton(UiString::button2, BUTTON_PRESSED, 162, 120);    
+            while(_bus.isTouching());               
+            return DisplayPage::setup4;
+        }  
+        else if(point.x>=217 && point.x<=267 && point.y>=120 && point.y<=170){    // 3 button  
+            firstZoneValue = 3 + CENTER_OFFSET; 
+            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET;  
+            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue);     
+            drawStandardBlueButton(UiString::button3, BUTTON_PRESSED, 217, 120);    
+            while(_bus.isTouching());             
+            return DisplayPage::setup4;
+        }    
+        else if(point.x>=52 && point.x<=102 && point.y>=175 && point.y<=225){    // 4 button  
+            firstZoneValue = 4 + CENTER_OFFSET; 
+            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET; 
+            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue);     
+            drawStandardBlueButton(UiString::button4, BUTTON_PRESSED, 52, 175);    
+            while(_bus.isTouching());             
+            return DisplayPage::setup4;
+        } 
+        else if(point.x>=107 && point.x<=157 && point.y>=175 && point.y<=225){    // 5 button
+            firstZoneValue = 5 + CENTER_OFFSET; 
+            if(firstZoneValue >= ZONE_OFFSET) firstZoneValue -= ZONE_OFFSET;  
+            EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstZoneValue);
+            drawStandardBlueButton(UiString::button5, BUTTON_PRESSED, 107, 175);    
+            while(_bus.isTouching());                
+            return DisplayPage::setup4;
+        }  
+    }
+    return DisplayPage::setup3; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on setup page 4. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_setupPage4() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button          
+            drawBackButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::setup3; 
+        }
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());   
+            return DisplayPage::home; 
+        }     
+        else if(point.x>=230 && point.x<=310 && point.y>=85 && point.y<=135){    // yes button    
+            drawStandardBlueButton(UiString::yesButton, BUTTON_PRESSED, 230, 85, 80);  
+            while(_bus.isTouching());      
+            return DisplayPage::setup5;
+        }     
+        else if(point.x>=230 && point.x<=310 && point.y>=180 && point.y<=230){    // no button    
+            drawStandardBlueButton(UiString::noButton, BUTTON_PRESSED, 230, 180, 80); 
+            while(_bus.isTouching());            
+            return DisplayPage::setup6; 
+        }   
+    }
+    return DisplayPage::setup4;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on setup page 5. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_setupPage5() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+
+        if(point.x>10 && point.x<60 && point.y>10 && point.y<50){    //back button      
+            drawBackButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());    
+            return DisplayPage::setup4;
+        }
+        else if(point.x>260 && point.x<310 && point.y>10 && point.y<50){    //exit button   
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::home;
+        }
+        else if(point.x>45 && point.x<195 && point.y>180 && point.y<230){    //continue button  
+            drawContinueButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());    
+            unsigned char currentServoPos = servoControl.getCurrentPosition();   
+            EEPROM.update(SERVO_BOTTOM_POSITION_EEPROM_ADDRESS, currentServoPos);   //only writes to eeprom if the value is different    
+            return DisplayPage::setup6; 
+        }             
+        else if(point.x>260 && point.x<310 && point.y>85 && point.y<135){   //up button
+            drawStandardBlueButton(UiString::upButton, BUTTON_PRESSED, 260, 85);   
+            while(_bus.isTouching());      
+            drawStandardBlueButton(UiString::upButton, BUTTON_RELEASED, 260, 85);   
+            servoControl.moveUpOneIncrement(); 
+        }    
+        else if(point.x>260 && point.x<310 && point.y>180 && point.y<230){   //down button
+            drawStandardBlueButton(UiString::downButton, BUTTON_PRESSED, 260, 180 );
+            while(_bus.isTouching());   
+            drawStandardBlueButton(UiString::downButton, BUTTON_RELEASED, 260, 180 );    
+            servoControl.moveDownOneIncrement();  
+        } 
+    }
+    return DisplayPage::setup5;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on setup page 6. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_setupPage6() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button   
+            drawBackButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());        
+            return DisplayPage::setup5; 
+        }
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::home; 
+        }
+        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
+            drawContinueButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());           
+            return DisplayPage::setup7; 
+        } 
+    }
+    return DisplayPage::setup6;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on setup page 7. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_setupPage7() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button 
+            drawBackButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());          
+            return DisplayPage::setup6; 
+        }
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::home;
+        }
+        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button  
+            drawContinueButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());          
+            return DisplayPage::setup8; 
+        }    
+    }
+    return DisplayPage::setup7;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on setup page 8. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_setupPage8() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button 
+            drawBackButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());          
+            return DisplayPage::setup7;
+        }
+        else if(point.x>=30 && point.x<=155 && point.y>=115 && point.y<=165){    //touch (calibration) button   
+            drawStandardBlueButton(UiString::touchButton, BUTTON_PRESSED, 30, 115, 125);  
+            while(_bus.isTouching());       
+            return DisplayPage::touchCalibration;
+        } 
+        else if(point.x>=165 && point.x<=290 && point.y>=115 && point.y<=165){    //step rate button   
+            drawStandardBlueButton(UiString::stepRateButton, BUTTON_PRESSED, 165, 115, 125);  
+            while(_bus.isTouching());       
+            return DisplayPage::stepRate1;
+        } 
+#ifdef DIAGNOSTICS_PAGE
+        else if(point.x>=220 && point.x<=310 && point.y>=10 && point.y<=60){    //diagnostics button   
+            drawStandardBlueButton(UiString::diagnosticsButton, BUTTON_PRESSED, 220, 10, 90);  
+            while(_bus.isTouching());       
+            return DisplayPage::diagnostics;
+        } 
+#endif
+        else if(point.x>=50 && point.x<=270 && point.y>=180 && point.y<=230){    //main menu button   
+            drawMainMenuButton(BUTTON_PRESSED);  
+            while(_bus.isTouching());       
+            return DisplayPage::home;
+        } 
+    }
+    return DisplayPage::setup8;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on 
+ *          run program page 1. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_runProgramPage1() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button
+            drawBackButton(BUTTON_PRESSED);   
+            while(_bus.isTouching());   //wait until the button is released before continuing 
+            return DisplayPage::home;
+        } 
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());  
+            return DisplayPage::home;         
+        }
+        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
+            drawContinueButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::lockProfile;                    
+        }
+    } 
+    return DisplayPage::runProgram1;   
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on 
+ *          run program page 2. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_runProgramPage2() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button
+            drawBackButton(BUTTON_PRESSED);   
+            while(_bus.isTouching());   //wait until the button is released before continuing 
+            return DisplayPage::lockId;
+        } 
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());  
+            return DisplayPage::home;         
+        }
+        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
+            drawContinueButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::runProgram3;                    
+        }
+    } 
+    return DisplayPage::runProgram2;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on 
+ *          run program page 3. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_runProgramPage3() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());  
+            return DisplayPage::home;         
+        }
+    } 
+    return DisplayPage::runProgram3;   
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on the channels
+ *          page. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_channelsPage() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());  
+            return DisplayPage::home;         
+        }
+    } 
+    return DisplayPage::channels;   
+}
+
+#ifdef DIAGNOSTICS_PAGE
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on the 
+ *          diagnostics page. The reset button (-D PROFILER_ENABLED) clears
+ *          the profiler's results and draws the page again. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_diagnosticsPage() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button 
+            drawBackButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());          
+            return DisplayPage::setup8;
+        }
+#ifdef PROFILER_ENABLED
+        else if(point.x>=235 && point.x<=310 && point.y>=10 && point.y<=60){    //reset button   
+            drawStandardBlueButton(UiString::resetButton, BUTTON_PRESSED, 235, 10, 75);  
+            while(_bus.isTouching());       
+            profiler.reset(); 
+            _previousPage = DisplayPage::notAssigned;   //so that the page is drawn again
+        } 
+#endif
+    }
+    return DisplayPage::diagnostics;
+}
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on the lock 
+ *          profile page. The selected lock profile is saved in the EEPROM.
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_lockProfilePage() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button      
+            drawBackButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::runProgram1; 
+        }
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());   
+            return DisplayPage::home; 
+        }   
+        else if(point.x>=52 && point.x<=102 && point.y>=120 && point.y<=170){    // 1 button 
+            EEPROM.update(LOCK_PROFILE_EEPROM_ADDRESS, 1);   //only writes to eeprom if the value is different  
+            drawStandardBlueButton(UiString::button1, BUTTON_PRESSED, 52, 120);    
+            while(_bus.isTouching());      
+            return DisplayPage::lockId; 
+        }     
+        else if(point.x>=107 && point.x<=157 && point.y>=120 && point.y<=170){    // 2 button   
+            EEPROM.update(LOCK_PROFILE_EEPROM_ADDRESS, 2);     
+            drawStandardBlueButton(UiString::button2, BUTTON_PRESSED, 107, 120);    
+            while(_bus.isTouching());            
+            return DisplayPage::lockId;
+        }    
+        else if(point.x>=162 && point.x<=212 && point.y>=120 && point.y<=170){    // 3 button 
+            EEPROM.update(LOCK_PROFILE_EEPROM_ADDRESS, 3); 
+            drawStandardBlueButton(UiString::button3, BUTTON_PRESSED, 162, 120);    
+            while(_bus.isTouching());               
+            return DisplayPage::lockId;
+        }  
+        else if(point.x>=217 && point.x<=267 && point.y>=120 && point.y<=170){    // 4 button  
+            EEPROM.update(LOCK_PROFILE_EEPROM_ADDRESS, 4);     
+            drawStandardBlueButton(UiString::button4, BUTTON_PRESSED, 217, 120);    
+            while(_bus.isTouching());             
+            return DisplayPage::lockId;
+        }    
+        else if(point.x>=52 && point.x<=157 && point.y>=175 && point.y<=225){    // none button  
+            EEPROM.update(LOCK_PROFILE_EEPROM_ADDRESS, NO_LOCK_PROFILE); 
+            drawStandardBlueButton(UiString::noneButton, BUTTON_PRESSED, 52, 175, 105);    
+            while(_bus.isTouching());             
+            return DisplayPage::lockId;
+        } 
+    }
+    return DisplayPage::lockProfile; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on the lock ID 
+ *          page. The selected lock ID is saved in the EEPROM when the 
+ *          continue button is pressed.
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_lockIdPage() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button      
+            drawBackButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::lockProfile; 
+        }
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());   
+            return DisplayPage::home; 
+        }   
+        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button 
+            drawContinueButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            EEPROM.update(LOCK_ID_EEPROM_ADDRESS, _selectedLockId);   //only writes to eeprom if the value is different  
+            return DisplayPage::runProgram2;                    
+        }
+        else if(point.x>=52 && point.x<=102 && point.y>=120 && point.y<=170){    // - button 
+            drawStandardBlueButton(UiString::minusButton, BUTTON_PRESSED, 52, 120);    
+            while(_bus.isTouching());      
+            drawStandardBlueButton(UiString::minusButton, BUTTON_RELEASED, 52, 120);    
+            _selectedLockId = (_selectedLockId == 0) ? MAX_LOCK_ID : _selectedLockId - 1; 
+            drawLockIdValue(); 
+        }     
+        else if(point.x>=217 && point.x<=267 && point.y>=120 && point.y<=170){    // + button  
+            drawStandardBlueButton(UiString::plusButton, BUTTON_PRESSED, 217, 120);    
+            while(_bus.isTouching());             
+            drawStandardBlueButton(UiString::plusButton, BUTTON_RELEASED, 217, 120);    
+            _selectedLockId = (_selectedLockId == MAX_LOCK_ID) ? 0 : _selectedLockId + 1; 
+            drawLockIdValue(); 
+        }    
+    }
+    return DisplayPage::lockId; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if the cross on the touch calibration page has been
+ *          touched. The raw touch point is averaged over CALIBRATION_SAMPLES
+ *          samples, then the next cross is shown. Once all the crosses have
+ *          been touched, the calibration is calculated and saved. 
+ * @note    There are no buttons on this page, since they can't be hit 
+ *          reliably until the touch screen is calibrated. 
+ * @return  Returns DisplayPage::setup8 once the calibration is saved, 
+ *          otherwise the same page (the crosses start over if the 
+ *          calibration failed). 
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_touchCalibrationPage() {
+    TSPoint point = _bus.readRawTouch();  //Get touch point (not calibrated)  
+    if (point.z > ts.pressureThreshhold){ 
+        long sumX = 0, sumY = 0; 
+        unsigned char sampleCount = 0; 
+        while(sampleCount < CALIBRATION_SAMPLES && _bus.isTouching()) {
+            point = _bus.readRawTouch(); 
+            if(point.z > ts.pressureThreshhold) {
+                sumX += point.x; 
+                sumY += point.y; 
+                sampleCount++; 
+            }
+        }
+        while(_bus.isTouching());   //wait until the finger is lifted before continuing 
+        if(sampleCount < CALIBRATION_SAMPLES) {
+            return DisplayPage::touchCalibration;   //lifted too early, the same cross has to be touched again
+        }
+
+        _calibrationRawX[_calibrationPointIndex] = sumX / sampleCount; 
+        _calibrationRawY[_calibrationPointIndex] = sumY / sampleCount; 
+        drawCalibrationTarget(_calibrationPointIndex, BLACK); 
+        _calibrationPointIndex++; 
+
+        if(_calibrationPointIndex == NUMBER_OF_CALIBRATION_POINTS) {
+            if(_bus.calibrate(_calibrationRawX, _calibrationRawY, calibrationTargetX, calibrationTargetY)) {
+                return DisplayPage::setup8; 
+            }
+            tft.setTextColor(WHITE);
+            tft.fillRect(0, 75, 320, 30, BLACK); 
+            printStringCentered(UiString::touchCalibrationFailed, 95); 
+            _calibrationPointIndex = 0; 
+        }
+        drawCalibrationTarget(_calibrationPointIndex, WHITE); 
+    }
+    return DisplayPage::touchCalibration; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on step rate 
+ *          page 1. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_stepRatePage1() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=10 && point.x<=60 && point.y>=10 && point.y<=50){    //back button 
+            drawBackButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());          
+            return DisplayPage::setup8;
+        }
+        else if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){    //exit button   
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());     
+            return DisplayPage::home;
+        }
+        else if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //start button  
+            drawStandardBlueButton(UiString::startButton, BUTTON_PRESSED, 45, 180, 150); 
+            while(_bus.isTouching());          
+            return DisplayPage::stepRate2; 
+        }    
+    }
+    return DisplayPage::stepRate1;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on step rate 
+ *          page 3. 
+ * @return  Returns DisplayPage::stepRate2 if the dial is still at zero (the 
+ *          next trial runs), DisplayPage::stepRate4 if it isn't, otherwise 
+ *          the same page. 
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_stepRatePage3() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=230 && point.x<=310 && point.y>=85 && point.y<=135){    // yes button    
+            drawStandardBlueButton(UiString::yesButton, BUTTON_PRESSED, 230, 85, 80);  
+            while(_bus.isTouching()); 
+            return DisplayPage::stepRate2;      
+        }     
+        else if(point.x>=230 && point.x<=310 && point.y>=180 && point.y<=230){    // no button    
+            drawStandardBlueButton(UiString::noButton, BUTTON_PRESSED, 230, 180, 80); 
+            while(_bus.isTouching());            
+            return DisplayPage::stepRate4; 
+        } 
+    }
+    return DisplayPage::stepRate3;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on step rate 
+ *          page 4. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_stepRatePage4() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=45 && point.x<=195 && point.y>=180 && point.y<=230){    //continue button  
+            drawContinueButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());          
+            return DisplayPage::setup8; 
+        }    
+    }
+    return DisplayPage::stepRate4;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on the
+ *          results page. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_resultsPage() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());  
+            return DisplayPage::home;         
+        }
+    } 
+    return DisplayPage::results; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks to see if any buttons have been pressed on the
+ *          error page. 
+ * @return  Returns the updated enumeration for the current page, depending
+ *          on whether or not a button has been pressed. If no button has  
+ *          been pressed, return the same page.
+ */
+/*****************************************************************************/
+DisplayPage Display::monitorInputs_errorPage() {
+    TSPoint point = _bus.readTouch();  //Get touch point  
+    if (point.z > ts.pressureThreshhold){ 
+        if(point.x>=260 && point.x<=310 && point.y>=10 && point.y<=50){   //exit button
+            drawExitButton(BUTTON_PRESSED); 
+            while(_bus.isTouching());  
+            return DisplayPage::home;         
+        }
+    } 
+    return DisplayPage::error; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sets the font used by tft.print() to one of the display's fonts. 
+ * @param   font    The font from the string table (UiStrings.h). 
+ */
+/*****************************************************************************/
+void Display::setUiFont(UiFont font) {
+    switch(font) {
+        case UiFont::FreeSans9pt7b: 
+            tft.setFont(&FreeSans9pt7b); 
+            break; 
+        case UiFont::FreeSans12pt7b: 
+            tft.setFont(&FreeSans12pt7b); 
+            break; 
+        case UiFont::FreeSansBold12pt7b: 
+            tft.setFont(&FreeSansBold12pt7b); 
+            break; 
+        case UiFont::FreeSans18pt7b: 
+            tft.setFont(&FreeSans18pt7b); 
+            break; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints a string from the string table (UiStrings.h) at the 
+ *          cursor, in the string's font. The string is read from flash. 
+ * @note    tft.setTextColor() and tft.setTextSize() need to be called 
+ *          before this function. The font stays set afterwards, so numbers
+ *          printed right after the string use the same font. 
+ * @param   id  The string to be printed. 
+ */
+/*****************************************************************************/
+void Display::printString(UiString id) {
+    setUiFont(getUiStringFont(id)); 
+    tft.print(getUiString(id)); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Same as printTextCentered(), but for a string from the string
+ *          table (UiStrings.h), which is printed in the string's font. The
+ *          string's width was measured when building (UiStringMetrics.h), 
+ *          so tft.getTextBounds() isn't needed. 
+ * @param   id  The string to be printed. 
+ * @param   y   This is the Y coordinate at which the text will be printed. 
+ */
+/*****************************************************************************/
+void Display::printStringCentered(UiString id, unsigned int y) {
+    setUiFont(getUiStringFont(id)); 
+
+    uint16_t cursorPosition;
+    cursorPosition = (320/2) - (getUiStringWidth(id)/2);   //the width was measured when building, so the glyphs don't need to be walked here
+    cursorPosition = cursorPosition - 2;  //offsetting X position by -2 seems to center the text better (at least for FreeSans12pt7b font)
+
+    tft.setCursor(cursorPosition, y); 
+    tft.print(getUiString(id));
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints texted so that it is centered on the screen. Similar to
+ *          tft.print(). The X coordinate is calculated in this function.
+ *          Used for text that is formatted at runtime (strings from the
+ *          string table are printed with printStringCentered()). 
+ * @note    tft.setTextColor(), tft.setTextSize(), and tft.setFont() need
+ *          to be called before this function, just like when 
+ *          using tft.print().  
+ * @note    This function was tested for FreeSans12pt7b font. Other fonts 
+ *          may not be centered if they are used. 
+ * @param   inputText   This is the text that will be printed to the display. 
+ * @param   y   This is the Y coordinate at which the text will be printed. 
+ */
+/*****************************************************************************/
+void Display::printTextCentered(const char inputText[], unsigned int y) {
+
+    int16_t  x1, y1;
+    uint16_t w, h, cursorPosition;
+
+    //all we really need from this function is the width of the text
+    tft.getTextBounds(inputText, 0, y, &x1, &y1, &w, &h); // x coordinate set to 0, but doesn't really matter because it will be calculated to center the text
+
+    cursorPosition = (320/2) - (w/2);   //calculating the cursor position so that the text will be centered on the screen
+    cursorPosition = cursorPosition - 2;  //offsetting X position by -2 seems to center the text better (at least for FreeSans12pt7b font)
+
+    tft.setCursor(cursorPosition, y); 
+    tft.print(inputText);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the setup button. The button will have different colours
+ *          depending on whether it is pressed or released.     
+ * @param   buttonState The state of the button is passed into this function.
+ *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
+ */
+/*****************************************************************************/
+void Display::drawSetupButton(bool buttonState) {
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    if(buttonState == BUTTON_RELEASED) {
+        tft.fillRoundRect(60, 100, 200, 50, 10, CUSTOM_GREEN);   
+        tft.drawRoundRect(60, 100, 200, 50, 10, WHITE);   
+    }
+    else if(buttonState == BUTTON_PRESSED) {
+        tft.fillRoundRect(60, 100, 200, 50, 10, BLACK);   
+        tft.drawRoundRect(60, 100, 200, 50, 10, CUSTOM_GREEN);    
+    }      
+    tft.setTextColor(WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+    tft.setFont(&FreeSans12pt7b);           
+    printStringCentered(UiString::setupButton, 132);
+} 
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the run program button. The button will have different 
+ *          colours depending on whether it is pressed or released.       
+ * @param   buttonState The state of the button is passed into this function.
+ *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
+ */
+/*****************************************************************************/
+void Display::drawRunProgramButton(bool buttonState) {
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    if(buttonState == BUTTON_RELEASED) {
+        tft.fillRoundRect(60, 170, 200, 50, 10, CUSTOM_GREEN);   
+        tft.drawRoundRect(60, 170, 200, 50, 10, WHITE);   
+    }
+    else if(buttonState == BUTTON_PRESSED) {
+        tft.fillRoundRect(60, 170, 200, 50, 10, BLACK);   
+        tft.drawRoundRect(60, 170, 200, 50, 10, CUSTOM_GREEN);    
+    }      
+    tft.setTextColor(WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+    tft.setFont(&FreeSans12pt7b);           
+    printStringCentered(UiString::runProgramButton, 202);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the back button. The button will have different colours
+ *          depending on whether it is pressed or released.       
+ * @param   buttonState The state of the button is passed into this function.
+ *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
+ */
+/*****************************************************************************/
+void Display::drawBackButton(bool buttonState) {
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    if(buttonState == BUTTON_RELEASED) {
+        tft.fillRoundRect(10, 10, 50, 40, 10, CUSTOM_GREEN);  
+        tft.drawRoundRect(10, 10, 50, 40, 10, WHITE); 
+    }
+    else if(buttonState == BUTTON_PRESSED) {
+        tft.fillRoundRect(10, 10, 50, 40, 10, BLACK); 
+        tft.drawRoundRect(10, 10, 50, 40, 10, CUSTOM_GREEN);    
+    }          
+    tft.setTextColor(WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+    tft.setCursor(19,38);
+    tft.setFont(&FreeSans18pt7b);                 
+    printString(UiString::backButton);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the exit button. The button will have different colours
+ *          depending on whether it is pressed or released.     
+ * @param   buttonState The state of the button is passed into this function.
+ *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
+ */
+/*****************************************************************************/
+void Display::drawExitButton(bool buttonState) {
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    if(buttonState == BUTTON_RELEASED) {
+        tft.fillRoundRect(260, 10, 50, 40, 10, RED);   
+        tft.drawRoundRect(260, 10, 50, 40, 10, WHITE);  
+    }
+    else if(buttonState == BUTTON_PRESSED) {
+        tft.fillRoundRect(260, 10, 50, 40, 10, BLACK);   
+        tft.drawRoundRect(260, 10, 50, 40, 10, RED);     
+    }      
+    tft.setTextColor(WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+    tft.setCursor(276, 39);  
+    tft.setFont(&FreeSans18pt7b);                 
+    printString(UiString::exitButton);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the continue button. The button will have different colours
+ *          depending on whether it is pressed or released.       
+ * @param   buttonState The state of the button is passed into this function.
+ *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
+ */
+/*****************************************************************************/
+void Display::drawContinueButton(bool buttonState) {
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    if(buttonState == BUTTON_RELEASED) {
+        tft.fillRoundRect(45, 180, 150, 50, 10, CUSTOM_GREEN);   
+        tft.drawRoundRect(45, 180, 150, 50, 10, WHITE);   
+    }
+    else if(buttonState == BUTTON_PRESSED) {
+        tft.fillRoundRect(45, 180, 150, 50, 10, BLACK);   
+        tft.drawRoundRect(45, 180, 150, 50, 10, CUSTOM_GREEN);    
+    }      
+    tft.setTextColor(WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+    tft.setCursor(72,212);  //X cursor postion = (rect X coordinate + (rect width/2) - text width/2) -2    //Y cursor position = rect Y coordinate + 32    //formulas work for FreeSans12pt7b   //text width found with printTextInfoToSerial function
+    tft.setFont(&FreeSans12pt7b);           
+    printString(UiString::continueButton);   //text width = 92 pixels    
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws a standard blue button. The button will have different colours
+ *          depending on whether it is pressed or released. 
+ * @param   label   The string (UiStrings.h) that will be printed as the
+ *          button's label.        
+ * @param   buttonState The state of the button is passed into this function.
+ *          Options: BUTTON_RELEASED, BUTTON_PRESSED      
+ * @param   rectX   The X coordinate that determines where the left side of the
+ *          button is located on the display. 
+ * @param   rectY   The Y coordinate that determines where the top of the button
+ *          is located on the display.
+ * @param   rectWidth   Determines the width of the button (in pixels). This
+ *          parameter has a default value of 50 (look in header file) and 
+ *          does not need to be specified.  
+ */
+/*****************************************************************************/
+void Display::drawStandardBlueButton(UiString label, bool buttonState, int16_t rectX, int16_t rectY, int16_t rectWidth) {
+    tft.setTextColor(WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+    setUiFont(getUiStringFont(label));   //FreeSans12pt7b for all the button labels
+
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    uint16_t textWidth = getUiStringWidth(label);   //measured when building (see tools/text_metrics.py)
+
+    if(buttonState == BUTTON_RELEASED) {
+        tft.fillRoundRect(rectX, rectY, rectWidth, 50, 10, BLUE);  
+        tft.drawRoundRect(rectX, rectY, rectWidth, 50, 10, WHITE);   
+    }
+    else if(buttonState == BUTTON_PRESSED) {
+        tft.fillRoundRect(rectX, rectY, rectWidth, 50, 10, BLACK); 
+        tft.drawRoundRect(rectX, rectY, rectWidth, 50, 10, BLUE);    
+    }  
+    tft.setCursor((rectX + rectWidth/2 - textWidth/2) -2, rectY + 32);  //this line sets the cursor position with the correct offset to center the text with the button (works for FreeSans12pt7b only)                       
+    tft.print(getUiString(label));     
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the main menu button. The button will have different colours
+ *          depending on whether it is pressed or released.       
+ * @param   buttonState The state of the button is passed into this function.
+ *          Options: BUTTON_RELEASED, BUTTON_PRESSED       
+ */
+/*****************************************************************************/
+void Display::drawMainMenuButton(bool buttonState) {
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    if(buttonState == BUTTON_RELEASED) {
+        tft.fillRoundRect(50, 180, 220, 50, 10, CUSTOM_GREEN);   
+        tft.drawRoundRect(50, 180, 220, 50, 10, WHITE);   
+    }
+    else if(buttonState == BUTTON_PRESSED) {
+        tft.fillRoundRect(50, 180, 220, 50, 10, BLACK);   
+        tft.drawRoundRect(50, 180, 220, 50, 10, CUSTOM_GREEN);    
+    }      
+    tft.setTextColor(WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+    tft.setFont(&FreeSans12pt7b);           
+    printStringCentered(UiString::mainMenuButton, 212);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws the selected lock ID on the lock ID page, and whether a 
+ *          combination is cached for it (fast-open).
+ */
+/*****************************************************************************/
+void Display::drawLockIdValue() {
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    tft.setTextColor(WHITE);
+    tft.setTextSize(0); // Set text size. We are using custom font so you should always set text size as 0  
+    tft.setFont(&FreeSans18pt7b);
+
+    char lockIdBuffer[UNSIGNED_TEXT_SIZE]; 
+    formatUnsigned(lockIdBuffer, _selectedLockId, 2); 
+    tft.fillRect(110, 125, 100, 40, BLACK); 
+    printTextCentered(lockIdBuffer, 157); 
+
+    char firstPos, secondPos, thirdPos; 
+    CombinationCache combinationCache; 
+    tft.setFont(&FreeSans9pt7b);
+    tft.fillRect(200, 190, 120, 30, BLACK); 
+    tft.setCursor(205, 212); 
+    if(combinationCache.find(_selectedLockId, &firstPos, &secondPos, &thirdPos)) {
+        printString(UiString::cached); 
+    }
+    else if(_selectedLockId != NO_LOCK_ID) {
+        printString(UiString::notCached); 
+    }
+}
+
+
+/*****************************************************************************/
+/**
+ * @brief   Draws (or erases) a cross on the touch calibration page. 
+ * @param   index   The calibration point (0 to NUMBER_OF_CALIBRATION_POINTS - 1). 
+ * @param   color   The color of the cross (BLACK to erase it). 
+ */
+/*****************************************************************************/
+void Display::drawCalibrationTarget(unsigned char index, uint16_t color) {
+    _bus.claimForLcd();   //the libraries are sharing pins (see DisplayBus.h)
+
+    int16_t x = calibrationTargetX[index]; 
+    int16_t y = calibrationTargetY[index]; 
+    tft.drawFastHLine(x - CALIBRATION_TARGET_SIZE, y, 2*CALIBRATION_TARGET_SIZE + 1, color); 
+    tft.drawFastVLine(x, y - CALIBRATION_TARGET_SIZE, 2*CALIBRATION_TARGET_SIZE + 1, color); 
+    tft.drawCircle(x, y, CALIBRATION_TARGET_SIZE/2, color); 
+}
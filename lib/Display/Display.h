@@ -1,129 +1,220 @@
-
-#ifndef DISPLAY_H
-#define DISPLAY_H
-
-//Either ARDUINO_MEGA_ENV or CUSTOM_BOARD_ENV will be defined in the platformio.ini file, depending on which environment is being used
-#ifdef ARDUINO_MEGA_ENV
-  #define LCD_CS A3   
-  #define LCD_CD A2   
-  #define LCD_WR A1    
-  #define LCD_RD A0  
-  #define LCD_RESET A4      
-
-  //for touch screen
-  #define YP A2   //same as LCD_CD pin     //needs to be an analog pin
-  #define XM A3   //same as LCD_CS pin     //needs to be an analog pin
-  #define YM 8    //same as LCD_D0 pin     //digital pin 
-  #define XP 9    //same as LCD_D1 pin     //digital pin  
-
-#elif CUSTOM_BOARD_ENV
-  #define LCD_CS A10    
-  #define LCD_CD A9    
-  #define LCD_WR 34   
-  #define LCD_RD 35   
-  #define LCD_RESET 39    
-
-  //for touch screen 
-  #define YP A9   //same as LCD_CD pin     //needs to be an analog pin
-  #define XM A10  //same as LCD_CS pin     //needs to be an analog pin
-  #define YM 23   //same as LCD_D0 pin     //digital pin 
-  #define XP 22   //SAME as LCD_D1 pin     //digital pin 
-
-#endif
-
-#define TS_MINX 128
-#define TS_MINY 110
-#define TS_MAXX 952
-#define TS_MAXY 910
-
-#define BLACK   0x0000
-#define BLUE    0x001F
-#define RED     0xF800
-#define GREEN   0x07E0
-#define CYAN    0x07FF
-#define MAGENTA 0xF81F
-#define YELLOW  0xFFE0
-#define WHITE   0xFFFF
-#define CUSTOM_GREEN 0x05EC
-
-#define BUTTON_RELEASED 0
-#define BUTTON_PRESSED 1
-
-//initialized to values that will never be equivalent to firstPosition, secondPosition, or thirdPosition (these variables will be assigned different values when the program is running)
-#define PREVIOUS_POSITION_INIT_VALUE 99
-
-enum class DisplayPage { 
-    notAssigned,
-    home, 
-    results, 
-    error, 
-    setup1, 
-    setup2, 
-    setup3, 
-    setup4,
-    setup5,
-    setup6,
-    setup7,
-    setup8,
-    runProgram1, 
-    runProgram2, 
-    runProgram3
-};   
-
-class Display {
-public:
-    void init(); 
-    void reconfig(); 
-
-    void drawOnce_homePage(); 
-    void drawOnce_setupPage1(); 
-    void drawOnce_setupPage2();
-    void drawOnce_setupPage3();
-    void drawOnce_setupPage4();
-    void drawOnce_setupPage5();
-    void drawOnce_setupPage6();
-    void drawOnce_setupPage7();
-    void drawOnce_setupPage8();
-
-    void drawOnce_runProgramPage1();
-    void drawOnce_runProgramPage2();
-    void drawOnce_runProgramPage3();
-    void drawOnce_updatedCombination(char firstPos, char secondPos, char thirdPos); 
-
-    void drawOnce_resultsPage(char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber, unsigned long startTimeMillis); 
-    void drawOnce_errorPage(); 
-
-    DisplayPage monitorInputs_homePage();
-    DisplayPage monitorInputs_setupPage1();
-    DisplayPage monitorInputs_setupPage2();
-    DisplayPage monitorInputs_setupPage3();
-    DisplayPage monitorInputs_setupPage4();
-    DisplayPage monitorInputs_setupPage5();
-    DisplayPage monitorInputs_setupPage6();
-    DisplayPage monitorInputs_setupPage7();
-    DisplayPage monitorInputs_setupPage8();
-
-    DisplayPage monitorInputs_runProgramPage1();
-    DisplayPage monitorInputs_runProgramPage2();
-    DisplayPage monitorInputs_runProgramPage3();
-
-    DisplayPage monitorInputs_resultsPage(); 
-    DisplayPage monitorInputs_errorPage(); 
-
-private:
-    void printTextCentered(const char inputText[], unsigned int y); 
-
-    void drawSetupButton(bool buttonState); 
-    void drawRunProgramButton(bool buttonState); 
-    void drawBackButton(bool buttonState); 
-    void drawExitButton(bool buttonState); 
-    void drawContinueButton(bool buttonState);    
-    void drawStandardBlueButton(const char inputText[], bool buttonState, int16_t rectX, int16_t rectY, int16_t rectWidth = 50); 
-    void drawMainMenuButton(bool buttonState); 
-
-    DisplayPage _previousPage;
-    char _previousFirstPosition, _previousSecondPosition, _previousThirdPosition; 
-};  
-
-#endif
-
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include "UiStrings.h"
+#include "DisplayBus.h"
+#include "Algorithm.h"
+#include "Common.h"
+#include "ChannelPins.h"
+#include "DisplayPage.h"
+
+//the diagnostics page (reached from the last setup page) shows the results of the profiler and of the memory monitor
+#if defined(PROFILER_ENABLED) || defined(MEMORY_MONITOR)
+  #define DIAGNOSTICS_PAGE
+#endif
+
+//Either ARDUINO_MEGA_ENV or CUSTOM_BOARD_ENV will be defined in the platformio.ini file, depending on which environment is being used
+#ifdef ARDUINO_MEGA_ENV
+  #define LCD_CS A3   
+  #define LCD_CD A2   
+  #define LCD_WR A1    
+  #define LCD_RD A0  
+  #define LCD_RESET A4      
+
+  //for touch screen
+  #define YP A2   //same as LCD_CD pin     //needs to be an analog pin
+  #define XM A3   //same as LCD_CS pin     //needs to be an analog pin
+  #define YM 8    //same as LCD_D0 pin     //digital pin 
+  #define XP 9    //same as LCD_D1 pin     //digital pin  
+
+  #define LCD_DATA_PINS 8, 9, 2, 3, 4, 5, 6, 7   //LCD_D0 to LCD_D7, the shield's wiring (ports H, E and G)
+
+#elif CUSTOM_BOARD_ENV
+  #define LCD_CS A10    
+  #define LCD_CD A9    
+  #define LCD_WR 34   
+  #define LCD_RD 35   
+  #define LCD_RESET 39    
+
+  //for touch screen 
+  #define YP A9   //same as LCD_CD pin     //needs to be an analog pin
+  #define XM A10  //same as LCD_CS pin     //needs to be an analog pin
+  #define YM 23   //same as LCD_D0 pin     //digital pin 
+  #define XP 22   //SAME as LCD_D1 pin     //digital pin 
+
+  #define LCD_DATA_PINS 23, 22, 24, 25, 26, 27, 28, 29   //LCD_D0 to LCD_D7, port A for both drivers (see ILI9341Parallel.h)
+
+#endif
+
+#if defined(IN_TREE_LCD_DRIVER) && !defined(CUSTOM_BOARD_ENV)
+  #error "The in-tree display driver (ILI9341Parallel.h) is only wired for the custom board"
+#endif
+
+//the pins that the LCD libraries write to with read-modify-write: the control lines and the whole data bus (see isOnLcdPort())
+constexpr uint8_t lcdPortPins[] = {LCD_CS, LCD_CD, LCD_WR, LCD_RD, LCD_DATA_PINS}; 
+
+#define TS_MINX 128
+#define TS_MINY 110
+#define TS_MAXX 952
+#define TS_MAXY 910
+
+#define BLACK   0x0000
+#define BLUE    0x001F
+#define RED     0xF800
+#define GREEN   0x07E0
+#define CYAN    0x07FF
+#define MAGENTA 0xF81F
+#define YELLOW  0xFFE0
+#define WHITE   0xFFFF
+#define CUSTOM_GREEN 0x05EC
+
+#define BUTTON_RELEASED 0
+#define BUTTON_PRESSED 1
+
+//initialized to values that will never be equivalent to firstPosition, secondPosition, or thirdPosition (these variables will be assigned different values when the program is running)
+#define PREVIOUS_POSITION_INIT_VALUE 99
+
+#define PROGRESS_REFRESH_INTERVAL_MS 1000   //the progress bar and ETA are redrawn at most once per interval
+#define PROGRESS_BAR_X 20
+#define PROGRESS_BAR_Y 172
+#define PROGRESS_BAR_WIDTH 280
+#define PROGRESS_BAR_HEIGHT 14
+
+#define CHANNEL_ROW_Y 100   //baseline of the first channel's row on the channels page
+#define CHANNEL_ROW_SPACING 40
+
+#define CALIBRATION_TARGET_SIZE 10   //length of each arm of a calibration cross (pixels)
+#define CALIBRATION_SAMPLES 8   //raw touch samples averaged for each calibration point
+
+#define GLYPH_PIXEL_BUFFER_SIZE 32   //pixels decoded before each push to the display when drawing a digit glyph
+
+class Display {
+public:
+    void init(); 
+    void reconfig(); 
+    bool bringUp(); 
+    static constexpr bool isOnLcdPort(uint8_t pin, unsigned char index = 0); 
+
+    void drawOnce_homePage(); 
+    void drawOnce_setupPage1(); 
+    void drawOnce_setupPage2();
+    void drawOnce_setupPage3();
+    void drawOnce_setupPage4();
+    void drawOnce_setupPage5();
+    void drawOnce_setupPage6();
+    void drawOnce_setupPage7();
+    void drawOnce_setupPage8();
+
+    void drawOnce_runProgramPage1();
+    void drawOnce_runProgramPage2();
+    void drawOnce_runProgramPage3();
+    void drawOnce_lockProfilePage();
+    void drawOnce_lockIdPage();
+    void drawOnce_touchCalibrationPage();
+    void drawOnce_stepRatePage1();
+    void drawOnce_stepRatePage2(unsigned int stepsPerSecond);
+    void drawOnce_stepRatePage3();
+    void drawOnce_stepRatePage4(unsigned int stepsPerSecond, bool isTuned);
+#ifdef DIAGNOSTICS_PAGE
+    void drawOnce_diagnosticsPage();
+#endif
+    void drawOnce_updatedCombination(char firstPos, char secondPos, char thirdPos); 
+    void drawOnce_updatedProgress(unsigned int attemptNumber, unsigned int plannedAttempts, unsigned long remainingMs); 
+    void drawOnce_channelsPage(); 
+    void drawOnce_updatedChannel(unsigned char channel, char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber, unsigned int plannedAttempts, AlgorithmState state); 
+
+    void drawOnce_resultsPage(char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber, unsigned long startTimeMillis, unsigned int expectedAttempts, unsigned char searchPass); 
+    void drawOnce_errorPage(); 
+
+    DisplayPage monitorInputs_homePage();
+    DisplayPage monitorInputs_setupPage1();
+    DisplayPage monitorInputs_setupPage2();
+    DisplayPage monitorInputs_setupPage3();
+    DisplayPage monitorInputs_setupPage4();
+    DisplayPage monitorInputs_setupPage5();
+    DisplayPage monitorInputs_setupPage6();
+    DisplayPage monitorInputs_setupPage7();
+    DisplayPage monitorInputs_setupPage8();
+
+    DisplayPage monitorInputs_runProgramPage1();
+    DisplayPage monitorInputs_runProgramPage2();
+    DisplayPage monitorInputs_runProgramPage3();
+    DisplayPage monitorInputs_lockProfilePage();
+    DisplayPage monitorInputs_lockIdPage();
+    DisplayPage monitorInputs_touchCalibrationPage();
+    DisplayPage monitorInputs_stepRatePage1();
+    DisplayPage monitorInputs_stepRatePage3();
+    DisplayPage monitorInputs_stepRatePage4();
+    DisplayPage monitorInputs_channelsPage();
+#ifdef DIAGNOSTICS_PAGE
+    DisplayPage monitorInputs_diagnosticsPage();
+#endif
+
+    DisplayPage monitorInputs_resultsPage(); 
+    DisplayPage monitorInputs_errorPage(); 
+
+private:
+    void setUiFont(UiFont font); 
+    void printString(UiString id); 
+    void printStringCentered(UiString id, unsigned int y); 
+    void printTextCentered(const char inputText[], unsigned int y); 
+
+    void drawSetupButton(bool buttonState); 
+    void drawRunProgramButton(bool buttonState); 
+    void drawBackButton(bool buttonState); 
+    void drawExitButton(bool buttonState); 
+    void drawContinueButton(bool buttonState);    
+    void drawStandardBlueButton(UiString label, bool buttonState, int16_t rectX, int16_t rectY, int16_t rectWidth = 50); 
+    void drawMainMenuButton(bool buttonState); 
+    void drawLockIdValue(); 
+    void drawCalibrationTarget(unsigned char index, uint16_t color); 
+#ifdef CHECK_TEXT_METRICS
+    void checkTextMetrics(); 
+#endif
+#ifdef DISPLAY_BENCHMARK
+    void printDrawTimes(); 
+    void printDrawTime(const __FlashStringHelper* label, unsigned long startTimeMicros); 
+#endif
+    void drawTwoDigitNumber(char number, int16_t x, int16_t baselineY); 
+    void drawDigitGlyph(unsigned char digit, int16_t x, int16_t baselineY); 
+
+    DisplayBus _bus; 
+    bool _isBroughtUp; 
+    unsigned char _bringUpStep;   //the next step of the in-tree driver's initialization (see ILI9341Parallel::initStep())
+    unsigned long _bringUpStepStartMs; 
+    uint16_t _bringUpWaitMs;   //how long the display needs after the previous step
+    DisplayPage _previousPage;
+    char _previousFirstPosition, _previousSecondPosition, _previousThirdPosition; 
+    unsigned char _selectedLockId; 
+    bool _isProgressDrawn; 
+    unsigned long _previousProgressDrawMs; 
+    int16_t _previousProgressFillWidth; 
+    unsigned int _previousStepsPerSecond;   //the rate shown on step rate page 2
+    unsigned char _calibrationPointIndex;   //the target that is shown on the touch calibration page
+    int _calibrationRawX[NUMBER_OF_CALIBRATION_POINTS], _calibrationRawY[NUMBER_OF_CALIBRATION_POINTS]; 
+    unsigned long _previousChannelDrawMs[NUMBER_OF_CHANNELS]; 
+    unsigned int _previousChannelAttempts[NUMBER_OF_CHANNELS];   //the rows are only redrawn when something has changed
+    char _previousChannelThirdPosition[NUMBER_OF_CHANNELS]; 
+    AlgorithmState _previousChannelState[NUMBER_OF_CHANNELS]; 
+    bool _isChannelDrawn[NUMBER_OF_CHANNELS]; 
+};  
+
+/*****************************************************************************/
+/**
+ * @brief   Checks, when building, if a pin is on the same port as one of 
+ *          the LCD's control lines or data bus pins (lcdPortPins). The LCD 
+ *          libraries set and clear those lines with read-modify-write, 
+ *          which would undo an interrupt's write to another pin of the port
+ *          if the interrupt came in between. 
+ * @param   pin The pin (an Arduino pin number). 
+ * @param   index   The first of lcdPortPins to compare with. 
+ * @returns Returns true if the pin can't be written by an interrupt. 
+ */
+/*****************************************************************************/
+constexpr bool Display::isOnLcdPort(uint8_t pin, unsigned char index) {
+    return index < sizeof(lcdPortPins) && (getPinPort(lcdPortPins[index]) == getPinPort(pin) || isOnLcdPort(pin, index + 1)); 
+}
+
+#endif
+
@@ -0,0 +1,284 @@
+
+#include "DisplayBus.h"
+#include "Display.h"
+#include "Profiler.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Initializations are done here. This function should only be called
+ *          once when the microcontroller boots (call in setup).
+ * @param   touchScreen The touch screen that shares its pins with the LCD. 
+ */
+/*****************************************************************************/
+void DisplayBus::init(TouchScreen* touchScreen) {
+    _touchScreen = touchScreen; 
+    _owner = BusOwner::unknown;   //so that the first claim sets up the pins
+    _switchCount = 0; 
+    _previousTouchSampleMs = 0; 
+    _calibration.init(); 
+#ifdef PRINT_BUS_SWITCHES
+    _requestCount = 0; 
+    _previousReportMs = millis(); 
+    _previousReportSwitchCount = 0; 
+    _previousReportRequestCount = 0; 
+    _sampleMicrosTotal = 0; 
+    _sampleCount = 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sets up the shared pins for the LCD library. This needs to be
+ *          called before drawing. The pins are only reconfigured if the
+ *          touch screen used them last. 
+ */
+/*****************************************************************************/
+void DisplayBus::claimForLcd() {
+#ifdef PRINT_BUS_SWITCHES
+    _requestCount++; 
+#endif
+    if(_owner != BusOwner::lcd) {
+        //the touch screen library leaves these pins as inputs, and the LCD library doesn't set them back to outputs
+        pinMode(XM, OUTPUT);
+        pinMode(YP, OUTPUT);
+        _owner = BusOwner::lcd; 
+        _switchCount++; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Records that the touch screen library is about to use the shared 
+ *          pins (it sets them up itself when it reads the touch screen). 
+ */
+/*****************************************************************************/
+void DisplayBus::claimForTouch() {
+    if(_owner != BusOwner::touch) {
+        _owner = BusOwner::touch; 
+        _switchCount++; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Reads the touch screen, at most once per TOUCH_SAMPLE_INTERVAL_MS, 
+ *          and converts the point to screen coordinates with the touch
+ *          calibration (see TouchCalibration.h). 
+ * @note    Between samples, a point with no pressure (z = 0) is returned, so
+ *          the caller sees the screen as not touched and keeps using the 
+ *          pins for the LCD. 
+ * @returns Returns the touch point (x from 0 to 320, y from 0 to 240). 
+ */
+/*****************************************************************************/
+TSPoint DisplayBus::readTouch() {
+    TSPoint point = readRawTouch(); 
+    if(point.z > 0) {
+        _calibration.toScreen(&point); 
+    }
+    return point; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Same as readTouch(), but the point isn't converted to screen 
+ *          coordinates (used to calibrate the touch screen). 
+ * @returns Returns the raw touch point (ADC values). 
+ */
+/*****************************************************************************/
+TSPoint DisplayBus::readRawTouch() {
+#ifdef PRINT_BUS_SWITCHES
+    _requestCount++; 
+    printSwitches(); 
+#endif
+    if(millis() - _previousTouchSampleMs < TOUCH_SAMPLE_INTERVAL_MS) {
+        return TSPoint(0, 0, 0); 
+    }
+    _previousTouchSampleMs = millis(); 
+    PROFILE_SCOPE(ProfileSection::touchRead);   //only the reads that sample the touch screen 
+    claimForTouch(); 
+#ifdef PRINT_BUS_SWITCHES
+    unsigned long startTimeMicros = micros(); 
+    TSPoint point = sampleTouch(); 
+    _sampleMicrosTotal += micros() - startTimeMicros; 
+    _sampleCount++; 
+    return point; 
+#else
+    return sampleTouch(); 
+#endif
+}
+
+#ifdef LIBRARY_TOUCH_READ
+/*****************************************************************************/
+/**
+ * @brief   Reads the touch screen with the touch screen library (to compare
+ *          with the sampling below). 
+ * @returns Returns the raw touch point. 
+ */
+/*****************************************************************************/
+TSPoint DisplayBus::sampleTouch() {
+    return _touchScreen->getPoint(); 
+}
+#else
+/*****************************************************************************/
+/**
+ * @brief   Reads the touch screen. The plates are driven the same way as in
+ *          the touch screen library's getPoint(), but with TOUCH_SAMPLES 
+ *          conversions per axis and a median instead of its oversampling, 
+ *          and with a faster ADC clock, so a sample always takes about 
+ *          (2*TOUCH_SAMPLES + 2) conversions of 26 us. 
+ * @note    The ADC is only accurate to about 8 bits at 500 kHz, which is 
+ *          still much finer than a fingertip. The prescaler is set back 
+ *          afterwards, so analogRead() elsewhere isn't affected. 
+ * @returns Returns the raw touch point (ADC values), with z = 0 if the
+ *          screen isn't touched or the reading wasn't steady. 
+ */
+/*****************************************************************************/
+TSPoint DisplayBus::sampleTouch() {
+    uint8_t previousAdcsra = ADCSRA; 
+    ADCSRA = (ADCSRA & ~(_BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0))) | TOUCH_ADC_PRESCALER_BITS; 
+    bool isXSteady, isYSteady; 
+
+    //X: voltage across the X plates, read on YP
+    pinMode(YP, INPUT); 
+    pinMode(YM, INPUT); 
+    digitalWrite(YP, LOW); 
+    digitalWrite(YM, LOW); 
+    pinMode(XP, OUTPUT); 
+    pinMode(XM, OUTPUT); 
+    digitalWrite(XP, HIGH); 
+    digitalWrite(XM, LOW); 
+    delayMicroseconds(TOUCH_SETTLE_US); 
+    int x = 1023 - readMedian(YP, &isXSteady); 
+
+    //Y: voltage across the Y plates, read on XM
+    pinMode(XP, INPUT); 
+    pinMode(XM, INPUT); 
+    digitalWrite(XP, LOW); 
+    digitalWrite(XM, LOW); 
+    pinMode(YP, OUTPUT); 
+    pinMode(YM, OUTPUT); 
+    digitalWrite(YP, HIGH); 
+    digitalWrite(YM, LOW); 
+    delayMicroseconds(TOUCH_SETTLE_US); 
+    int y = 1023 - readMedian(XM, &isYSteady); 
+
+    //pressure: resistance between the plates
+    pinMode(XP, OUTPUT); 
+    digitalWrite(XP, LOW); 
+    digitalWrite(YM, HIGH); 
+    digitalWrite(YP, LOW); 
+    pinMode(YP, INPUT); 
+    int z1 = analogRead(XM); 
+    int z2 = analogRead(YP); 
+
+    ADCSRA = previousAdcsra; 
+
+    long z = 0; 
+    if(z1 > 0 && isXSteady && isYSteady) {
+        z = (long)(z2 - z1) * x * TOUCH_X_PLATE_RESISTANCE / z1 / 1024;   //same as the library, without floating point
+        if(z < 0) {
+            z = 0; 
+        }
+    }
+    return TSPoint(x, y, z); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Reads an analog pin TOUCH_SAMPLES times and gets the median. 
+ * @param   pin The analog pin. 
+ * @param   isSteady    Set to false if the conversions differ by more than
+ *          TOUCH_MAX_SPREAD. 
+ * @returns Returns the median of the conversions. 
+ */
+/*****************************************************************************/
+int DisplayBus::readMedian(uint8_t pin, bool* isSteady) {
+    int samples[TOUCH_SAMPLES]; 
+    for(unsigned char i = 0; i < TOUCH_SAMPLES; i++) {
+        int sample = analogRead(pin); 
+        unsigned char j = i; 
+        while(j > 0 && samples[j - 1] > sample) {   //insertion sort, a handful of samples
+            samples[j] = samples[j - 1]; 
+            j--; 
+        }
+        samples[j] = sample; 
+    }
+    *isSteady = (samples[TOUCH_SAMPLES - 1] - samples[0] <= TOUCH_MAX_SPREAD); 
+    return samples[TOUCH_SAMPLES / 2]; 
+}
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if the touch screen is being touched (not throttled, since
+ *          it's used to wait for a button to be released). 
+ * @returns Returns true if the touch screen is being touched. 
+ */
+/*****************************************************************************/
+bool DisplayBus::isTouching() {
+#ifdef PRINT_BUS_SWITCHES
+    _requestCount++; 
+#endif
+    claimForTouch(); 
+    return _touchScreen->isTouching(); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Calculates a new touch calibration and saves it to the EEPROM.
+ * @param   rawX    The raw X readings (NUMBER_OF_CALIBRATION_POINTS).
+ * @param   rawY    The raw Y readings.
+ * @param   screenX The X coordinates of the targets that were touched.
+ * @param   screenY The Y coordinates of the targets.
+ * @returns Returns true if the calibration was saved, or false if the 
+ *          readings couldn't be used (the old calibration is kept). 
+ */
+/*****************************************************************************/
+bool DisplayBus::calibrate(const int rawX[], const int rawY[], const int screenX[], const int screenY[]) {
+    if(!_calibration.calculate(rawX, rawY, screenX, screenY)) {
+        return false; 
+    }
+    _calibration.save(); 
+    return true; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the number of times the shared pins changed owner since boot. 
+ * @returns Returns the number of switches. 
+ */
+/*****************************************************************************/
+unsigned long DisplayBus::getSwitchCount() {
+    return _switchCount; 
+}
+
+#ifdef PRINT_BUS_SWITCHES
+/*****************************************************************************/
+/**
+ * @brief   Prints the pin switches per second to the serial monitor (115200
+ *          baud), next to the number of reconfigurations without this class
+ *          (every draw and every touch read), once per BUS_REPORT_INTERVAL_MS.
+ *          The average time of a touch sample is printed as well. 
+ */
+/*****************************************************************************/
+void DisplayBus::printSwitches() {
+    unsigned long elapsedMs = millis() - _previousReportMs; 
+    if(elapsedMs < BUS_REPORT_INTERVAL_MS) {
+        return; 
+    }
+    Serial.print(F("Pin switches per second: ")); 
+    Serial.print((_switchCount - _previousReportSwitchCount) * 1000 / elapsedMs); 
+    Serial.print(F(" (without arbitration: ")); 
+    Serial.print((_requestCount - _previousReportRequestCount) * 1000 / elapsedMs); 
+    Serial.println(F(")")); 
+    if(_sampleCount > 0) {
+        Serial.print(F("Touch sample time (us): ")); 
+        Serial.println(_sampleMicrosTotal / _sampleCount); 
+    }
+    _previousReportMs = millis(); 
+    _previousReportSwitchCount = _switchCount; 
+    _previousReportRequestCount = _requestCount; 
+    _sampleMicrosTotal = 0; 
+    _sampleCount = 0; 
+}
+#endif
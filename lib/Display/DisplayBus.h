@@ -0,0 +1,61 @@
+
+#ifndef DISPLAY_BUS_H
+#define DISPLAY_BUS_H
+
+#include <Arduino.h>
+#include <TouchScreen.h>
+#include "TouchCalibration.h"
+
+#define TOUCH_SAMPLE_INTERVAL_MS 20   //the touch screen is read at most once per interval (50 Hz), so several draws can happen between pin switches
+#define BUS_REPORT_INTERVAL_MS 1000   //how often the pin switches are printed with -D PRINT_BUS_SWITCHES
+
+//touch sampling (see DisplayBus::sampleTouch()), these can be tuned for the panel
+#define TOUCH_SAMPLES 3   //ADC conversions per axis, the median is used (odd, 1 to 5)
+#define TOUCH_MAX_SPREAD 8   //a sample whose conversions differ by more than this was taken while the finger moved or lifted, so it's dropped
+#define TOUCH_SETTLE_US 20   //time for the plates to settle after switching the drive pins
+#define TOUCH_ADC_PRESCALER_BITS (_BV(ADPS2) | _BV(ADPS0))   //16 MHz / 32 = 500 kHz ADC clock (26 us per conversion) while sampling, instead of Arduino's /128 (104 us)
+#define TOUCH_X_PLATE_RESISTANCE 300   //ohms, used for the pressure
+
+//which library the shared pins are currently set up for (YP/XM are also LCD_CD/LCD_CS, and YM/XP are also LCD_D0/LCD_D1)
+enum class BusOwner {
+    unknown,
+    lcd,
+    touch
+};
+
+class DisplayBus {
+public:
+    void init(TouchScreen* touchScreen); 
+    void claimForLcd(); 
+    TSPoint readTouch(); 
+    TSPoint readRawTouch(); 
+    bool isTouching(); 
+    bool calibrate(const int rawX[], const int rawY[], const int screenX[], const int screenY[]); 
+    unsigned long getSwitchCount(); 
+
+private:
+    void claimForTouch(); 
+    TSPoint sampleTouch(); 
+#ifndef LIBRARY_TOUCH_READ
+    int readMedian(uint8_t pin, bool* isSteady); 
+#endif
+#ifdef PRINT_BUS_SWITCHES
+    void printSwitches(); 
+#endif
+
+    TouchScreen* _touchScreen; 
+    TouchCalibration _calibration; 
+    BusOwner _owner; 
+    unsigned long _switchCount; 
+    unsigned long _previousTouchSampleMs; 
+#ifdef PRINT_BUS_SWITCHES
+    unsigned long _requestCount;   //claims and touch reads, which all reconfigured the pins before this class was added
+    unsigned long _previousReportMs; 
+    unsigned long _previousReportSwitchCount; 
+    unsigned long _previousReportRequestCount; 
+    unsigned long _sampleMicrosTotal;   //time spent reading the touch screen since the last report
+    unsigned long _sampleCount; 
+#endif
+};
+
+#endif
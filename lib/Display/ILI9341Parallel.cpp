@@ -0,0 +1,471 @@
+
+#include <Arduino.h>
+#include "ILI9341Parallel.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Minimal driver for the ILI9341 display controller on the custom
+ *          board's 8-bit parallel bus. The data bus is written through the
+ *          port register in one instruction, and the control pins' port
+ *          registers are looked up once here, so each byte only costs a few
+ *          cycles. Text and shapes are still drawn by Adafruit_GFX, which
+ *          ends up in the fill functions below.
+ * @note    The pin names are the same as the ones that are passed to
+ *          Adafruit_TFTLCD, so the two drivers can be swapped in Display.cpp.
+ *          Reading from the display isn't supported (RD is kept high).
+ * @param   cs  Chip select pin.
+ * @param   cd  Command/data pin.
+ * @param   wr  Write strobe pin.
+ * @param   rd  Read strobe pin.
+ * @param   reset   Reset pin.
+ */
+/*****************************************************************************/
+ILI9341Parallel::ILI9341Parallel(uint8_t cs, uint8_t cd, uint8_t wr, uint8_t rd, uint8_t reset) : Adafruit_GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT) {
+    _csPort = portOutputRegister(digitalPinToPort(cs));
+    _cdPort = portOutputRegister(digitalPinToPort(cd));
+    _wrPort = portOutputRegister(digitalPinToPort(wr));
+    _rdPort = portOutputRegister(digitalPinToPort(rd));
+    _csDdr = portModeRegister(digitalPinToPort(cs));
+    _cdDdr = portModeRegister(digitalPinToPort(cd));
+    _csMask = digitalPinToBitMask(cs);
+    _cdMask = digitalPinToBitMask(cd);
+    _wrMask = digitalPinToBitMask(wr);
+    _rdMask = digitalPinToBitMask(rd);
+    _resetPin = reset;
+    _transactionDepth = 0;
+
+    *_csPort |= _csMask;   //idle levels before the pins become outputs
+    *_wrPort |= _wrMask;
+    *_rdPort |= _rdMask;
+    pinMode(cs, OUTPUT);
+    pinMode(cd, OUTPUT);
+    pinMode(wr, OUTPUT);
+    pinMode(rd, OUTPUT);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Resets the display (hardware reset).
+ */
+/*****************************************************************************/
+void ILI9341Parallel::reset() {
+    for(uint8_t step = 0; step < ILI9341_BEGIN_FIRST_STEP; step++) {
+        delay(initStep(step));
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sends the ILI9341 initialization sequence (same settings as
+ *          Adafruit_TFTLCD uses for this controller).
+ * @param   id  Only kept so that the call matches Adafruit_TFTLCD::begin().
+ */
+/*****************************************************************************/
+void ILI9341Parallel::begin(uint16_t id) {
+    (void)id;
+    for(uint8_t step = ILI9341_BEGIN_FIRST_STEP; step < ILI9341_INIT_STEPS; step++) {
+        delay(initStep(step));
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Runs one step of reset() and begin(). The display needs a delay
+ *          after most steps, which the caller can spend on something else
+ *          instead of waiting (see Display::bringUp()).
+ * @param   step    The step (0 to ILI9341_INIT_STEPS - 1), the steps from
+ *          ILI9341_BEGIN_FIRST_STEP on are begin().
+ * @returns Returns the time (ms) to wait before the next step.
+ */
+/*****************************************************************************/
+uint16_t ILI9341Parallel::initStep(uint8_t step) {
+    switch(step) {
+        case 0:
+            *_csPort |= _csMask;
+            *_wrPort |= _wrMask;
+            *_rdPort |= _rdMask;
+            pinMode(_resetPin, OUTPUT);
+            digitalWrite(_resetPin, LOW);
+            return 2;
+        case 1:
+            digitalWrite(_resetPin, HIGH);
+            return 120;
+        case 2:
+            beginTransaction();
+            writeCommand(ILI9341_SOFTRESET);
+            endTransaction();
+            return 50;
+        case 3:
+            beginTransaction();
+            writeCommand(ILI9341_DISPLAYOFF);
+            writeCommand(ILI9341_POWERCONTROL1);
+            writeData(0x23);
+            writeCommand(ILI9341_POWERCONTROL2);
+            writeData(0x10);
+            writeCommand(ILI9341_VCOMCONTROL1);
+            writeData(0x2B);
+            writeData(0x2B);
+            writeCommand(ILI9341_VCOMCONTROL2);
+            writeData(0xC0);
+            writeCommand(ILI9341_MADCTL);
+            writeData(ILI9341_MADCTL_MY | ILI9341_MADCTL_BGR);
+            writeCommand(ILI9341_PIXELFORMAT);
+            writeData(0x55);   //16 bits per pixel
+            writeCommand(ILI9341_FRAMECONTROL);
+            writeData(0x00);
+            writeData(0x1B);
+            writeCommand(ILI9341_ENTRYMODE);
+            writeData(0x07);
+            writeCommand(ILI9341_SLEEPOUT);
+            endTransaction();
+            return 150;
+        case 4:
+            beginTransaction();
+            writeCommand(ILI9341_DISPLAYON);
+            endTransaction();
+            return 500;
+        default:
+            setAddrWindow(0, 0, ILI9341_TFTWIDTH - 1, ILI9341_TFTHEIGHT - 1);
+            return 0;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sets the display orientation. The memory access settings are the
+ *          same as Adafruit_TFTLCD's, so the pages look the same with either
+ *          driver.
+ * @param   r   Rotation (options are 0, 1, 2, or 3).
+ */
+/*****************************************************************************/
+void ILI9341Parallel::setRotation(uint8_t r) {
+    Adafruit_GFX::setRotation(r);
+    uint8_t memoryAccess;
+    switch(rotation) {
+        case 0:
+            memoryAccess = ILI9341_MADCTL_MY | ILI9341_MADCTL_BGR;
+            break;
+        case 1:
+            memoryAccess = ILI9341_MADCTL_MX | ILI9341_MADCTL_MY | ILI9341_MADCTL_MV | ILI9341_MADCTL_BGR;
+            break;
+        case 2:
+            memoryAccess = ILI9341_MADCTL_MX | ILI9341_MADCTL_BGR;
+            break;
+        default:
+            memoryAccess = ILI9341_MADCTL_MV | ILI9341_MADCTL_BGR;
+            break;
+    }
+    beginTransaction();
+    writeCommand(ILI9341_MADCTL);
+    writeData(memoryAccess);
+    endTransaction();
+    setAddrWindow(0, 0, _width - 1, _height - 1);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws one pixel.
+ * @param   x   X coordinate.
+ * @param   y   Y coordinate.
+ * @param   color   RGB565 color.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    beginTransaction();
+    writePixel(x, y, color);
+    endTransaction();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Fills a rectangle with one address window and one bulk fill. The
+ *          rectangle is clipped to the screen.
+ * @param   x   X coordinate of the top left corner.
+ * @param   y   Y coordinate of the top left corner.
+ * @param   w   Width.
+ * @param   h   Height.
+ * @param   color   RGB565 color.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    beginTransaction();
+    writeFillRect(x, y, w, h, color);
+    endTransaction();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws a horizontal line (a rectangle that is one pixel high).
+ */
+/*****************************************************************************/
+void ILI9341Parallel::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Draws a vertical line (a rectangle that is one pixel wide).
+ */
+/*****************************************************************************/
+void ILI9341Parallel::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    fillRect(x, y, 1, h, color);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Fills the whole screen with one color.
+ * @param   color   RGB565 color.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::fillScreen(uint16_t color) {
+    fillRect(0, 0, _width, _height, color);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Called by Adafruit_GFX before drawing a shape or a character, so
+ *          that the chip stays selected for every pixel of it.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::startWrite() {
+    beginTransaction();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Same as drawPixel(), for use between startWrite() and endWrite().
+ */
+/*****************************************************************************/
+void ILI9341Parallel::writePixel(int16_t x, int16_t y, uint16_t color) {
+    if(x < 0 || y < 0 || x >= _width || y >= _height) {
+        return;
+    }
+    setAddrWindow(x, y, x, y);
+    writeCommand(ILI9341_MEMORYWRITE);
+    writeData(color >> 8);
+    writeData(color);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Same as fillRect(), for use between startWrite() and endWrite().
+ */
+/*****************************************************************************/
+void ILI9341Parallel::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if(w < 0) {
+        x += w + 1;
+        w = -w;
+    }
+    if(h < 0) {
+        y += h + 1;
+        h = -h;
+    }
+    int16_t x2 = x + w - 1;
+    int16_t y2 = y + h - 1;
+    if(w == 0 || h == 0 || x2 < 0 || y2 < 0 || x >= _width || y >= _height) {
+        return;
+    }
+    if(x < 0) {
+        x = 0;
+    }
+    if(y < 0) {
+        y = 0;
+    }
+    if(x2 >= _width) {
+        x2 = _width - 1;
+    }
+    if(y2 >= _height) {
+        y2 = _height - 1;
+    }
+    setAddrWindow(x, y, x2, y2);
+    flood(color, (uint32_t)(x2 - x + 1) * (y2 - y + 1));
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Same as drawFastHLine(), for use between startWrite() and
+ *          endWrite().
+ */
+/*****************************************************************************/
+void ILI9341Parallel::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    writeFillRect(x, y, w, 1, color);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Same as drawFastVLine(), for use between startWrite() and
+ *          endWrite().
+ */
+/*****************************************************************************/
+void ILI9341Parallel::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    writeFillRect(x, y, 1, h, color);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Called by Adafruit_GFX once a shape or a character has been drawn.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::endWrite() {
+    endTransaction();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sets the rectangle that the next pixels are written to (left to
+ *          right, then top to bottom).
+ * @param   x1  X coordinate of the top left corner.
+ * @param   y1  Y coordinate of the top left corner.
+ * @param   x2  X coordinate of the bottom right corner.
+ * @param   y2  Y coordinate of the bottom right corner.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::setAddrWindow(int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+    beginTransaction();
+    writeCommand(ILI9341_COLADDRSET);
+    writeData(x1 >> 8);
+    writeData(x1);
+    writeData(x2 >> 8);
+    writeData(x2);
+    writeCommand(ILI9341_PAGEADDRSET);
+    writeData(y1 >> 8);
+    writeData(y1);
+    writeData(y2 >> 8);
+    writeData(y2);
+    endTransaction();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Writes the same color to a number of pixels, starting at the top
+ *          left corner of the address window.
+ * @note    When both bytes of the color are the same (black and white, for
+ *          example), the data bus is only set once and the write strobe is
+ *          just toggled for every byte.
+ * @param   color   RGB565 color.
+ * @param   len The number of pixels.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::flood(uint16_t color, uint32_t len) {
+    uint8_t high = LCD_BUS_BYTE(color >> 8);
+    uint8_t low = LCD_BUS_BYTE(color & 0xFF);
+
+    beginTransaction();
+    writeCommand(ILI9341_MEMORYWRITE);
+    *_cdPort |= _cdMask;
+    if(high == low) {
+        LCD_DATA_PORT = high;
+        while(len > 0) {
+            strobeWrite();
+            strobeWrite();
+            len--;
+        }
+    }
+    else {
+        while(len > 0) {
+            LCD_DATA_PORT = high;
+            strobeWrite();
+            LCD_DATA_PORT = low;
+            strobeWrite();
+            len--;
+        }
+    }
+    endTransaction();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Writes a buffer of pixels to the address window. Large bitmaps can
+ *          be written in several calls.
+ * @param   data    RGB565 colors.
+ * @param   len The number of pixels in the buffer.
+ * @param   first   True for the first call after setAddrWindow() (writing
+ *          starts at the top left corner). False to continue where the
+ *          previous call stopped.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::pushColors(uint16_t* data, uint8_t len, bool first) {
+    beginTransaction();
+    if(first) {
+        writeCommand(ILI9341_MEMORYWRITE);
+    }
+    *_cdPort |= _cdMask;
+    while(len > 0) {
+        uint16_t color = *data;
+        write8(color >> 8);
+        write8(color);
+        data++;
+        len--;
+    }
+    endTransaction();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Selects the display. The data bus and the pins shared with the
+ *          touch screen are set as outputs here, since the touch screen
+ *          library changes them. Transactions can be nested.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::beginTransaction() {
+    if(_transactionDepth == 0) {
+        LCD_DATA_DDR = 0xFF;
+        *_csDdr |= _csMask;
+        *_cdDdr |= _cdMask;
+        *_csPort &= ~_csMask;
+    }
+    _transactionDepth++;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Deselects the display once the outermost transaction ends.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::endTransaction() {
+    _transactionDepth--;
+    if(_transactionDepth == 0) {
+        *_csPort |= _csMask;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Writes a command byte (command/data pin low).
+ */
+/*****************************************************************************/
+void ILI9341Parallel::writeCommand(uint8_t command) {
+    *_cdPort &= ~_cdMask;
+    write8(command);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Writes a data byte (command/data pin high).
+ */
+/*****************************************************************************/
+void ILI9341Parallel::writeData(uint8_t data) {
+    *_cdPort |= _cdMask;
+    write8(data);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Puts a byte on the data bus and latches it.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::write8(uint8_t data) {
+    LCD_DATA_PORT = LCD_BUS_BYTE(data);
+    strobeWrite();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Toggles the write strobe. The display latches the data bus on the
+ *          rising edge.
+ */
+/*****************************************************************************/
+void ILI9341Parallel::strobeWrite() {
+    *_wrPort &= ~_wrMask;
+    *_wrPort |= _wrMask;
+}
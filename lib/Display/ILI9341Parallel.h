@@ -0,0 +1,83 @@
+
+#ifndef ILI9341_PARALLEL_H
+#define ILI9341_PARALLEL_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+//The 8-bit data bus is wired to PORTA (pins 22 to 29) on the custom board, but LCD_D0 is on pin 23 (PA1) and LCD_D1 is on pin 22 (PA0)
+#define LCD_DATA_PORT PORTA
+#define LCD_DATA_DDR DDRA
+#define LCD_BUS_BYTE(d) (((d) & 0xFC) | (((d) & 0x01) << 1) | (((d) & 0x02) >> 1))   //swaps bits 0 and 1 to match the wiring
+
+#define ILI9341_INIT_STEPS 6   //the steps of reset() and begin() (see initStep())
+#define ILI9341_BEGIN_FIRST_STEP 2   //steps 0 and 1 are the hardware reset
+
+#define ILI9341_TFTWIDTH 240
+#define ILI9341_TFTHEIGHT 320
+
+#define ILI9341_SOFTRESET 0x01
+#define ILI9341_SLEEPOUT 0x11
+#define ILI9341_DISPLAYOFF 0x28
+#define ILI9341_DISPLAYON 0x29
+#define ILI9341_COLADDRSET 0x2A
+#define ILI9341_PAGEADDRSET 0x2B
+#define ILI9341_MEMORYWRITE 0x2C
+#define ILI9341_MADCTL 0x36
+#define ILI9341_PIXELFORMAT 0x3A
+#define ILI9341_FRAMECONTROL 0xB1
+#define ILI9341_ENTRYMODE 0xB7
+#define ILI9341_POWERCONTROL1 0xC0
+#define ILI9341_POWERCONTROL2 0xC1
+#define ILI9341_VCOMCONTROL1 0xC5
+#define ILI9341_VCOMCONTROL2 0xC7
+
+#define ILI9341_MADCTL_MY 0x80
+#define ILI9341_MADCTL_MX 0x40
+#define ILI9341_MADCTL_MV 0x20
+#define ILI9341_MADCTL_BGR 0x08
+
+class ILI9341Parallel : public Adafruit_GFX {
+public:
+    ILI9341Parallel(uint8_t cs, uint8_t cd, uint8_t wr, uint8_t rd, uint8_t reset);
+    void begin(uint16_t id = 0x9341);
+    void reset();
+    uint16_t initStep(uint8_t step);
+    void setRotation(uint8_t r);
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void fillScreen(uint16_t color);
+
+    void startWrite();
+    void writePixel(int16_t x, int16_t y, uint16_t color);
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void endWrite();
+
+    void setAddrWindow(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+    void flood(uint16_t color, uint32_t len);
+    void pushColors(uint16_t* data, uint8_t len, bool first);
+
+private:
+    void beginTransaction();
+    void endTransaction();
+    void writeCommand(uint8_t command);
+    void writeData(uint8_t data);
+    void write8(uint8_t data);
+    void strobeWrite();
+    volatile uint8_t* _csPort;
+    volatile uint8_t* _cdPort;
+    volatile uint8_t* _wrPort;
+    volatile uint8_t* _rdPort;
+    volatile uint8_t* _csDdr;
+    volatile uint8_t* _cdDdr;
+    uint8_t _csMask, _cdMask, _wrMask, _rdMask;
+    uint8_t _resetPin;
+    uint8_t _transactionDepth;   //startWrite()/endWrite() keep the chip selected across many drawing calls
+};
+
+#endif
@@ -0,0 +1,63 @@
+
+#include "TextFormat.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Writes an unsigned number in decimal, with leading zeros if it has
+ *          fewer than minDigits digits (like "%02u"). 
+ * @param   buffer  Where the text is written (at least UNSIGNED_TEXT_SIZE 
+ *          bytes, or minDigits + 1 if that is larger). 
+ * @param   value   The number to be written. 
+ * @param   minDigits   The minimum number of digits. 
+ * @returns Returns a pointer to the null terminator. 
+ */
+/*****************************************************************************/
+char* formatUnsigned(char* buffer, unsigned long value, unsigned char minDigits) {
+    char digits[UNSIGNED_TEXT_SIZE - 1]; 
+    unsigned char numberOfDigits = 0; 
+    do {
+        digits[numberOfDigits] = '0' + value % 10; 
+        numberOfDigits++; 
+        value /= 10; 
+    } while(value > 0); 
+
+    while(minDigits > numberOfDigits) {
+        *buffer++ = '0'; 
+        minDigits--; 
+    }
+    while(numberOfDigits > 0) {   //the digits were found from the least significant one
+        numberOfDigits--; 
+        *buffer++ = digits[numberOfDigits]; 
+    }
+    *buffer = '\0'; 
+    return buffer; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Writes a duration as hh:mm:ss (like "%02u:%02u:%02u"). 
+ * @param   buffer  Where the text is written (at least TIME_TEXT_SIZE bytes). 
+ * @param   seconds The duration (seconds). 
+ * @returns Returns a pointer to the null terminator. 
+ */
+/*****************************************************************************/
+char* formatTime(char* buffer, unsigned long seconds) {
+    buffer = formatUnsigned(buffer, seconds / 3600, 2); 
+    *buffer++ = ':'; 
+    buffer = formatUnsigned(buffer, (seconds % 3600) / 60, 2); 
+    *buffer++ = ':'; 
+    return formatUnsigned(buffer, seconds % 60, 2); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Copies a string from the string table (UiStrings.h) out of flash. 
+ * @param   buffer  Where the text is written (it has to fit the string). 
+ * @param   id  The string to be copied. 
+ * @returns Returns a pointer to the null terminator. 
+ */
+/*****************************************************************************/
+char* formatUiString(char* buffer, UiString id) {
+    strcpy_P(buffer, (const char*)getUiString(id)); 
+    return buffer + strlen(buffer); 
+}
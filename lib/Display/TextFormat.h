@@ -0,0 +1,17 @@
+
+#ifndef TEXT_FORMAT_H
+#define TEXT_FORMAT_H
+
+#include "UiStrings.h"
+
+//small replacements for sprintf() (which links avr-libc's vfprintf) for the numbers and times printed on the display.
+//each function writes at the start of the buffer, adds the null terminator, and returns a pointer to it, so that more
+//text can be appended right after
+#define UNSIGNED_TEXT_SIZE 11   //10 digits for an unsigned long + '\0'
+#define TIME_TEXT_SIZE 12       //"hhhhh:mm:ss" (the hours aren't limited to two digits) + '\0'
+
+char* formatUnsigned(char* buffer, unsigned long value, unsigned char minDigits = 1); 
+char* formatTime(char* buffer, unsigned long seconds); 
+char* formatUiString(char* buffer, UiString id); 
+
+#endif
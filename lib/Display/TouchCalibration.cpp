@@ -0,0 +1,124 @@
+
+#include <EEPROM.h>
+#include "TouchCalibration.h"
+#include "Display.h"
+#include "Common.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Loads the touch calibration from the EEPROM. If the touch screen
+ *          has never been calibrated, the transform is derived from
+ *          TS_MINX, TS_MAXX, TS_MINY and TS_MAXY (Display.h), which gives
+ *          the same points as the map() calls that were used before.
+ */
+/*****************************************************************************/
+void TouchCalibration::init() {
+    if(EEPROM.read(TOUCH_CALIBRATION_EEPROM_ADDRESS) == TOUCH_CALIBRATION_MAGIC) {
+        EEPROM.get(TOUCH_CALIBRATION_EEPROM_ADDRESS + 1, _transform);
+    }
+    else {
+        setDefaultTransform();
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sets the transform that maps TS_MINX..TS_MAXX to 0..320 and
+ *          TS_MINY..TS_MAXY to 0..240 (no rotation).
+ */
+/*****************************************************************************/
+void TouchCalibration::setDefaultTransform() {
+    _transform.a = (320L << TOUCH_CALIBRATION_SHIFT) / (TS_MAXX - TS_MINX);
+    _transform.b = 0;
+    _transform.c = -TS_MINX * _transform.a;
+    _transform.d = 0;
+    _transform.e = (240L << TOUCH_CALIBRATION_SHIFT) / (TS_MAXY - TS_MINY);
+    _transform.f = -TS_MINY * _transform.e;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Calculates the transform from three calibration points (the raw
+ *          touch readings and the screen coordinates of the targets that
+ *          were touched). The current transform is only replaced if the
+ *          points give a usable result.
+ * @note    Floating point is only used here, once per calibration. Touch
+ *          points are converted with integer math (see toScreen()).
+ * @param   rawX    The raw X readings (NUMBER_OF_CALIBRATION_POINTS).
+ * @param   rawY    The raw Y readings.
+ * @param   screenX The X coordinates of the targets.
+ * @param   screenY The Y coordinates of the targets.
+ * @returns Returns true if the transform was updated, or false if the
+ *          readings were bad (the same spot touched twice, a reading that
+ *          is way off, ...).
+ */
+/*****************************************************************************/
+bool TouchCalibration::calculate(const int rawX[], const int rawY[], const int screenX[], const int screenY[]) {
+    //Cramer's rule for the two sets of three equations (one per screen axis)
+    float determinant = (float)rawX[0]*(rawY[1] - rawY[2]) + (float)rawX[1]*(rawY[2] - rawY[0]) + (float)rawX[2]*(rawY[0] - rawY[1]);
+    if(fabs(determinant) < MIN_CALIBRATION_DETERMINANT) {
+        return false;
+    }
+
+    float coefficients[6] = {0, 0, 0, 0, 0, 0};   //a, b, c, d, e, f
+    for(unsigned char i = 0; i < NUMBER_OF_CALIBRATION_POINTS; i++) {
+        unsigned char j = (i + 1) % NUMBER_OF_CALIBRATION_POINTS;
+        unsigned char k = (i + 2) % NUMBER_OF_CALIBRATION_POINTS;
+        float termA = (float)(rawY[j] - rawY[k]);
+        float termB = (float)(rawX[k] - rawX[j]);
+        float termC = (float)rawX[j]*rawY[k] - (float)rawX[k]*rawY[j];
+        coefficients[0] += screenX[i]*termA;
+        coefficients[1] += screenX[i]*termB;
+        coefficients[2] += screenX[i]*termC;
+        coefficients[3] += screenY[i]*termA;
+        coefficients[4] += screenY[i]*termB;
+        coefficients[5] += screenY[i]*termC;
+    }
+
+    long fixedPoint[6];
+    for(unsigned char i = 0; i < 6; i++) {
+        float value = coefficients[i] / determinant;
+        bool isOffset = (i == 2 || i == 5);
+        if(!isOffset && fabs(value) > MAX_CALIBRATION_SCALE) {
+            return false;
+        }
+        fixedPoint[i] = lround(value * (1L << TOUCH_CALIBRATION_SHIFT));
+    }
+
+    _transform.a = fixedPoint[0];
+    _transform.b = fixedPoint[1];
+    _transform.c = fixedPoint[2];
+    _transform.d = fixedPoint[3];
+    _transform.e = fixedPoint[4];
+    _transform.f = fixedPoint[5];
+    return true;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Saves the transform to the EEPROM, so it's used after the next
+ *          boot.
+ */
+/*****************************************************************************/
+void TouchCalibration::save() {
+    EEPROM.put(TOUCH_CALIBRATION_EEPROM_ADDRESS + 1, _transform);   //only writes the bytes that are different
+    EEPROM.update(TOUCH_CALIBRATION_EEPROM_ADDRESS, TOUCH_CALIBRATION_MAGIC);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Converts a raw touch point to screen coordinates (320 x 240,
+ *          landscape). The pressure (z) isn't changed.
+ * @note    Two multiplications and an addition per axis instead of the
+ *          divisions in map(). With a scale of at most MAX_CALIBRATION_SCALE
+ *          the sums stay well inside a long for raw values up to 1023.
+ * @param   point   The raw touch point, which is converted in place.
+ */
+/*****************************************************************************/
+void TouchCalibration::toScreen(TSPoint* point) {
+    const long rounding = 1L << (TOUCH_CALIBRATION_SHIFT - 1);
+    long rawX = point->x;
+    long rawY = point->y;
+    point->x = (_transform.a*rawX + _transform.b*rawY + _transform.c + rounding) >> TOUCH_CALIBRATION_SHIFT;
+    point->y = (_transform.d*rawX + _transform.e*rawY + _transform.f + rounding) >> TOUCH_CALIBRATION_SHIFT;
+}
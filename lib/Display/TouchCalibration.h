@@ -0,0 +1,35 @@
+
+#ifndef TOUCH_CALIBRATION_H
+#define TOUCH_CALIBRATION_H
+
+#include <Arduino.h>
+#include <TouchScreen.h>
+
+#define TOUCH_CALIBRATION_MAGIC 0x5A   //marks a calibration that has been saved at least once (erased EEPROM reads 0xFF)
+#define TOUCH_CALIBRATION_SHIFT 16   //the coefficients are fixed point numbers with 16 fractional bits
+#define NUMBER_OF_CALIBRATION_POINTS 3   //an affine transform is fully determined by three points that aren't on one line
+#define MIN_CALIBRATION_DETERMINANT 1000.0   //smaller means the three raw points were (nearly) on one line, or the same touch was read three times
+#define MAX_CALIBRATION_SCALE 4   //screen pixels per raw ADC count, anything larger is a bad reading (the plates span several hundred counts)
+
+//maps a raw touch point (ADC values) to screen coordinates:
+//    screenX = (a*rawX + b*rawY + c) >> TOUCH_CALIBRATION_SHIFT
+//    screenY = (d*rawX + e*rawY + f) >> TOUCH_CALIBRATION_SHIFT
+//which covers the scaling and offset of each axis, as well as a slightly rotated or sheared panel
+struct TouchTransform {
+    long a, b, c;
+    long d, e, f;
+};
+
+class TouchCalibration {
+public:
+    void init();
+    bool calculate(const int rawX[], const int rawY[], const int screenX[], const int screenY[]);
+    void save();
+    void toScreen(TSPoint* point);
+
+private:
+    void setDefaultTransform();
+    TouchTransform _transform;
+};
+
+#endif
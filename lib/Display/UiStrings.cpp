@@ -0,0 +1,70 @@
+
+#include "UiStrings.h"
+#include "UiStringMetrics.h"   //generated from the string table when building (see tools/text_metrics.py)
+
+//one PROGMEM array per string (PROGMEM can't be applied to string literals inside an initializer list)
+#define UI_STRING_TEXT(id, font, text) const char uiStringText_##id[] PROGMEM = text;
+UI_STRING_LIST(UI_STRING_TEXT)
+#undef UI_STRING_TEXT
+
+struct UiStringEntry {
+    const char* text;
+    UiFont font;
+    uint16_t width;   //size of the text in its font, measured when building
+    uint8_t height;
+};
+
+#define UI_STRING_ENTRY(id, font, text) { uiStringText_##id, UiFont::font, UI_STRING_WIDTH_##id, UI_STRING_HEIGHT_##id },
+const UiStringEntry uiStringTable[] PROGMEM = {
+    UI_STRING_LIST(UI_STRING_ENTRY)
+};
+#undef UI_STRING_ENTRY
+
+/*****************************************************************************/
+/**
+ * @brief   Gets a string from the string table.
+ * @note    The string stays in flash, so it can be passed to tft.print()
+ *          and tft.getTextBounds() (they have flash string overloads), but
+ *          not to functions that expect a string in SRAM.
+ * @param   id  The string to get.
+ * @returns Returns a pointer to the string in flash.
+ */
+/*****************************************************************************/
+const __FlashStringHelper* getUiString(UiString id) {
+    return (const __FlashStringHelper*)pgm_read_ptr(&uiStringTable[(unsigned char)id].text);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the font that a string is drawn in.
+ * @param   id  The string.
+ * @returns Returns the font from the string table.
+ */
+/*****************************************************************************/
+UiFont getUiStringFont(UiString id) {
+    return (UiFont)pgm_read_byte(&uiStringTable[(unsigned char)id].font);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the width of a string in its font, which was measured when
+ *          building. Same as the width from tft.getTextBounds(). 
+ * @param   id  The string.
+ * @returns Returns the width (pixels).
+ */
+/*****************************************************************************/
+uint16_t getUiStringWidth(UiString id) {
+    return pgm_read_word(&uiStringTable[(unsigned char)id].width);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the height of a string in its font, which was measured when
+ *          building. Same as the height from tft.getTextBounds(). 
+ * @param   id  The string.
+ * @returns Returns the height (pixels).
+ */
+/*****************************************************************************/
+uint8_t getUiStringHeight(UiString id) {
+    return pgm_read_byte(&uiStringTable[(unsigned char)id].height);
+}
@@ -0,0 +1,152 @@
+
+#ifndef UI_STRINGS_H
+#define UI_STRINGS_H
+
+#include <Arduino.h>
+
+//the fonts used by the display (named after the Adafruit GFX fonts, see Display.cpp)
+enum class UiFont : unsigned char {
+    FreeSans9pt7b,
+    FreeSans12pt7b,
+    FreeSansBold12pt7b,
+    FreeSans18pt7b
+};
+
+//every string that is drawn on the display, with the font that it's drawn in. The strings are kept in flash (PROGMEM)
+//instead of being copied to SRAM at startup. tools/subset_fonts.py reads this list to find the glyphs that each font needs,
+//and tools/text_metrics.py to measure each string in its font, so a string has to be listed again (with another ID) if it
+//is drawn in a second font.
+#define UI_STRING_LIST(X) \
+    X(homeTitle1, FreeSansBold12pt7b, "Combination Lock") \
+    X(homeTitle2, FreeSansBold12pt7b, "Opener") \
+    X(setupTitle, FreeSansBold12pt7b, "Setup") \
+    X(runProgramTitle, FreeSansBold12pt7b, "Run Program") \
+    X(resultsTitle, FreeSansBold12pt7b, "Results") \
+    X(errorTitle, FreeSansBold12pt7b, "Error") \
+    X(touchCalibrationTitle, FreeSansBold12pt7b, "Touch Calibration") \
+    X(stepRateTitle, FreeSansBold12pt7b, "Step Rate") \
+    X(channelsTitle, FreeSansBold12pt7b, "Channels") \
+    X(diagnosticsTitle, FreeSansBold12pt7b, "Diagnostics") \
+    \
+    X(setupButton, FreeSans12pt7b, "Setup") \
+    X(runProgramButton, FreeSans12pt7b, "Run Program") \
+    X(continueButton, FreeSans12pt7b, "Continue") \
+    X(mainMenuButton, FreeSans12pt7b, "Go To Main Menu") \
+    X(touchButton, FreeSans12pt7b, "Touch") \
+    X(stepRateButton, FreeSans12pt7b, "Step Rate") \
+    X(startButton, FreeSans12pt7b, "Start") \
+    X(yesButton, FreeSans12pt7b, "Yes") \
+    X(noButton, FreeSans12pt7b, "No") \
+    X(upButton, FreeSans12pt7b, "Up") \
+    X(downButton, FreeSans12pt7b, "Dn") \
+    X(diagnosticsButton, FreeSans12pt7b, "Diag") \
+    X(resetButton, FreeSans12pt7b, "Reset") \
+    X(noneButton, FreeSans12pt7b, "None") \
+    X(minusButton, FreeSans12pt7b, "-") \
+    X(plusButton, FreeSans12pt7b, "+") \
+    X(button0, FreeSans12pt7b, "0") \
+    X(button1, FreeSans12pt7b, "1") \
+    X(button2, FreeSans12pt7b, "2") \
+    X(button3, FreeSans12pt7b, "3") \
+    X(button4, FreeSans12pt7b, "4") \
+    X(button5, FreeSans12pt7b, "5") \
+    X(backButton, FreeSans18pt7b, "<-") \
+    X(exitButton, FreeSans18pt7b, "x") \
+    \
+    X(removeLock1, FreeSans9pt7b, "Please remove the lock if it is") \
+    X(removeLock2, FreeSans9pt7b, "inserted. Press continue to move") \
+    X(removeLock3, FreeSans9pt7b, "the shackle-puller to the bottom") \
+    X(removeLock4, FreeSans9pt7b, "position.") \
+    X(changeFirstZone1, FreeSans9pt7b, "Would you like to change") \
+    X(changeFirstZone2, FreeSans9pt7b, "the saved value for the") \
+    X(changeFirstZone3, FreeSans9pt7b, "first zone's starting") \
+    X(changeFirstZone4, FreeSans9pt7b, "position?") \
+    X(selectFirstZone, FreeSans9pt7b, "Select a zone starting position.") \
+    X(recalibrateServo1, FreeSans9pt7b, "Would you like to") \
+    X(recalibrateServo2, FreeSans9pt7b, "recalibrate the servo") \
+    X(recalibrateServo3, FreeSans9pt7b, "motor? This may be") \
+    X(recalibrateServo4, FreeSans9pt7b, "necessary if the pinion") \
+    X(recalibrateServo5, FreeSans9pt7b, "was detached") \
+    X(adjustHeight1, FreeSans9pt7b, "Adjust the shackle-puller's") \
+    X(adjustHeight2, FreeSans9pt7b, "height if necessary and") \
+    X(adjustHeight3, FreeSans9pt7b, "then press continue. The") \
+    X(adjustHeight4, FreeSans9pt7b, "height will be saved. ") \
+    X(insertLock, FreeSans9pt7b, "Please insert the lock.") \
+    X(turnDialToZero, FreeSans9pt7b, "Turn the dial to the zero position. ") \
+    X(setupComplete, FreeSans9pt7b, "Setup is complete.") \
+    X(insertLockToRun1, FreeSans9pt7b, "Please insert the lock. Press") \
+    X(insertLockToRun2, FreeSans9pt7b, "continue to run the program.") \
+    X(currentCombination, FreeSans9pt7b, "Current combination:") \
+    X(combinationDash, FreeSans18pt7b, "-") \
+    X(selectLockProfile, FreeSans9pt7b, "Select a lock profile.") \
+    X(selectLockId, FreeSans9pt7b, "Select the lock ID (0 = none).") \
+    X(cached, FreeSans9pt7b, "Cached") \
+    X(notCached, FreeSans9pt7b, "Not cached") \
+    X(touchTheCross, FreeSans9pt7b, "Touch the center of the cross.") \
+    X(touchCalibrationFailed, FreeSans9pt7b, "Calibration failed, please retry.") \
+    X(stepRateIntro1, FreeSans9pt7b, "The dial will be turned back and") \
+    X(stepRateIntro2, FreeSans9pt7b, "forth, faster each time. Turn the") \
+    X(stepRateIntro3, FreeSans9pt7b, "dial to zero, then press start.") \
+    X(stepRateTesting, FreeSans9pt7b, "Testing (steps/s) : ") \
+    X(stepRateCheck1, FreeSans9pt7b, "Is the dial still") \
+    X(stepRateCheck2, FreeSans9pt7b, "exactly at zero?") \
+    X(stepRateSaved, FreeSans9pt7b, "Saved rate (steps/s) : ") \
+    X(stepRateNotTuned1, FreeSans9pt7b, "No rate passed, the default") \
+    X(stepRateNotTuned2, FreeSans9pt7b, "rate will be used.") \
+    \
+    X(progressSeparator, FreeSans9pt7b, " / ") \
+    X(progressEta, FreeSans9pt7b, "    ETA ") \
+    X(unknownEta, FreeSans9pt7b, "--:--:--") \
+    X(channelPrefix, FreeSans9pt7b, "Ch ") \
+    X(channelSeparator, FreeSans9pt7b, " :  ") \
+    X(channelDash, FreeSans9pt7b, "-") \
+    X(channelGap, FreeSans9pt7b, "    ") \
+    X(noPosition, FreeSans9pt7b, "--") \
+    X(channelOpened, FreeSans9pt7b, "Opened") \
+    X(channelFailed, FreeSans9pt7b, "Failed") \
+    \
+    X(profileSectionHeader, FreeSans9pt7b, "Section") \
+    X(profileMeanHeader, FreeSans9pt7b, "Mean") \
+    X(profileMaxHeader, FreeSans9pt7b, "Max (us)") \
+    X(profileHistogramHeader, FreeSans9pt7b, "Hist.") \
+    X(profileLoop, FreeSans9pt7b, "Loop") \
+    X(profileAlgorithmRun, FreeSans9pt7b, "Algorithm") \
+    X(profileRotateOneStep, FreeSans9pt7b, "Step") \
+    X(profileTouchRead, FreeSans9pt7b, "Touch") \
+    X(profileDrawPage, FreeSans9pt7b, "Page") \
+    X(profileDrawCombination, FreeSans9pt7b, "Digits") \
+    X(profileDrawProgress, FreeSans9pt7b, "Progress") \
+    X(profileDrawChannel, FreeSans9pt7b, "Channel") \
+    X(staticRam, FreeSans9pt7b, "Static RAM : ") \
+    X(minFreeRam, FreeSans9pt7b, "    Min free : ") \
+    \
+    X(successfulCombination, FreeSans9pt7b, "Successful combination : ") \
+    X(elapsedTime, FreeSans9pt7b, "Elapsed time : ") \
+    X(attemptsPerMinute, FreeSans9pt7b, "Attempts per minute : ") \
+    X(attemptNumber, FreeSans9pt7b, "Attempt number : ") \
+    X(attemptsOutOf, FreeSans9pt7b, " out of ") \
+    X(searchPassStart, FreeSans9pt7b, " (pass ") \
+    X(searchPassOf, FreeSans9pt7b, " of ") \
+    X(searchPassEnd, FreeSans9pt7b, ")") \
+    X(expectedAttempts, FreeSans9pt7b, "Expected (profile) : ") \
+    \
+    X(errorText1, FreeSans9pt7b, "All combinations have been tried") \
+    X(errorText2, FreeSans9pt7b, "without success. Possible fixes:") \
+    X(errorText3, FreeSans9pt7b, "  - inspect limit switch") \
+    X(errorText4, FreeSans9pt7b, "  - adjust first zone's starting") \
+    X(errorText5, FreeSans9pt7b, "    position if necessary") \
+    X(errorText6, FreeSans9pt7b, "  - recalibrate servo")
+
+#define UI_STRING_ID(id, font, text) id,
+enum class UiString : unsigned char {
+    UI_STRING_LIST(UI_STRING_ID)
+    count
+};
+#undef UI_STRING_ID
+
+const __FlashStringHelper* getUiString(UiString id);
+UiFont getUiStringFont(UiString id);
+uint16_t getUiStringWidth(UiString id);
+uint8_t getUiStringHeight(UiString id);
+
+#endif
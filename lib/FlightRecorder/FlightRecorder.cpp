@@ -0,0 +1,238 @@
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "FlightRecorder.h"
+#include "Telemetry.h"
+
+#ifdef FLIGHT_RECORDER
+//printed instead of the codes, in the same order as AlgorithmCommand (Algorithm.h)
+const char algorithmCommandName_none[] PROGMEM = "none"; 
+const char algorithmCommandName_setNextValidCombination[] PROGMEM = "setNextValidCombination"; 
+const char algorithmCommandName_rotateClockwiseTwice[] PROGMEM = "rotateClockwiseTwice"; 
+const char algorithmCommandName_goToThirdPosition[] PROGMEM = "goToThirdPosition"; 
+const char algorithmCommandName_rotateCounterclockwiseOnce[] PROGMEM = "rotateCounterclockwiseOnce"; 
+const char algorithmCommandName_goToSecondPosition[] PROGMEM = "goToSecondPosition"; 
+const char algorithmCommandName_goToFirstPosition[] PROGMEM = "goToFirstPosition"; 
+const char algorithmCommandName_followManeuver[] PROGMEM = "followManeuver"; 
+const char algorithmCommandName_servoUp[] PROGMEM = "servoUp"; 
+const char algorithmCommandName_servoDown[] PROGMEM = "servoDown"; 
+const char algorithmCommandName_homeToIndex[] PROGMEM = "homeToIndex"; 
+const char* const algorithmCommandNames[] PROGMEM = {
+    algorithmCommandName_none, 
+    algorithmCommandName_setNextValidCombination, 
+    algorithmCommandName_rotateClockwiseTwice, 
+    algorithmCommandName_goToThirdPosition, 
+    algorithmCommandName_rotateCounterclockwiseOnce, 
+    algorithmCommandName_goToSecondPosition, 
+    algorithmCommandName_goToFirstPosition, 
+    algorithmCommandName_followManeuver, 
+    algorithmCommandName_servoUp, 
+    algorithmCommandName_servoDown, 
+    algorithmCommandName_homeToIndex
+}; 
+
+//in the same order as StepperCommand (StepperControl.h), the names that are the same as above are shared
+const char stepperCommandName_rotateSteps[] PROGMEM = "rotateSteps"; 
+const char stepperCommandName_measureIndex[] PROGMEM = "measureIndex"; 
+const char* const stepperCommandNames[] PROGMEM = {
+    algorithmCommandName_none, 
+    algorithmCommandName_rotateClockwiseTwice, 
+    algorithmCommandName_goToThirdPosition, 
+    algorithmCommandName_rotateCounterclockwiseOnce, 
+    algorithmCommandName_goToSecondPosition, 
+    algorithmCommandName_goToFirstPosition, 
+    stepperCommandName_rotateSteps, 
+    algorithmCommandName_homeToIndex, 
+    stepperCommandName_measureIndex
+}; 
+
+//in the same order as AlgorithmState (Algorithm.h)
+const char algorithmStateName_running[] PROGMEM = "running"; 
+const char algorithmStateName_error[] PROGMEM = "error"; 
+const char algorithmStateName_complete[] PROGMEM = "complete"; 
+const char* const algorithmStateNames[] PROGMEM = {
+    algorithmStateName_running, 
+    algorithmStateName_error, 
+    algorithmStateName_complete
+}; 
+
+#define NAME_COUNT(names) (sizeof(names) / sizeof(names[0]))
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   Starts the serial port and empties the ring buffer. This 
+ *          function should only be called once when the microcontroller 
+ *          boots (call in setup).
+ * @note    Does nothing unless -D FLIGHT_RECORDER is set. 
+ */
+/*****************************************************************************/
+void FlightRecorder::init() {
+#ifdef FLIGHT_RECORDER
+    Serial.begin(FLIGHT_RECORDER_BAUD); 
+    _nextEvent = 0; 
+    _isFull = false; 
+    _limitSwitchLevels = 0; 
+    _isSaving = false; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Starts saving the events in the ring buffer to the EEPROM, oldest
+ *          first, over the previously saved ones (call when a run ends on 
+ *          the error page). The bytes are written by update(), and the ring
+ *          buffer is frozen until they all have been. 
+ * @note    Writing all of the bytes takes about 1.7 seconds (3.3ms per 
+ *          byte), which would stop the other channels' steppers if it was 
+ *          done here. Does nothing if a save is already in progress. 
+ */
+/*****************************************************************************/
+void FlightRecorder::save() {
+#ifdef FLIGHT_RECORDER
+    if(_isSaving) {
+        return; 
+    }
+    _saveCount = _isFull ? FLIGHT_RECORDER_EVENTS : _nextEvent; 
+    _saveOldest = _isFull ? _nextEvent : 0; 
+    _saveOffset = 0; 
+    _isSaving = true; 
+    EEPROM.update(FLIGHT_LOG_EEPROM_ADDRESS, 0xFF);   //the old log is dropped first, so that a log that was cut short by a reset isn't used
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Continues the save started by save(). Up to 
+ *          FLIGHT_SAVE_BYTES_PER_UPDATE bytes are compared with the EEPROM,
+ *          and the first one that has changed is written. The write runs in
+ *          the background, so this never waits for the EEPROM (call every 
+ *          loop). 
+ */
+/*****************************************************************************/
+void FlightRecorder::update() {
+#ifdef FLIGHT_RECORDER
+    int eventBytes = _saveCount * sizeof(FlightEvent); 
+    for(unsigned char i = 0; i < FLIGHT_SAVE_BYTES_PER_UPDATE && _isSaving && eeprom_is_ready(); i++) {
+        if(_saveOffset < eventBytes) {
+            const unsigned char* pEvent = (const unsigned char*)&_events[(_saveOldest + _saveOffset / sizeof(FlightEvent)) & (FLIGHT_RECORDER_EVENTS - 1)]; 
+            EEPROM.update(FLIGHT_LOG_EEPROM_ADDRESS + 2 + _saveOffset, pEvent[_saveOffset % sizeof(FlightEvent)]); 
+        }
+        else if(_saveOffset == eventBytes) {
+            EEPROM.update(FLIGHT_LOG_EEPROM_ADDRESS + 1, _saveCount); 
+        }
+        else {
+            EEPROM.update(FLIGHT_LOG_EEPROM_ADDRESS, FLIGHT_LOG_MAGIC);   //written last
+            _isSaving = false; 
+        }
+        _saveOffset++; 
+    }
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints the events in the ring buffer to the serial port (115200 
+ *          baud), oldest first (see FlightRecorder.h for the format). 
+ * @note    Waits for the telemetry frame that is being sent to be finished 
+ *          (see Telemetry.h). 
+ */
+/*****************************************************************************/
+void FlightRecorder::print() {
+#ifdef FLIGHT_RECORDER
+    while(!telemetry.isAtFrameBoundary()) {
+        telemetry.update(); 
+    }
+    unsigned char count = _isFull ? FLIGHT_RECORDER_EVENTS : _nextEvent; 
+    unsigned char oldest = _isFull ? _nextEvent : 0; 
+    for(unsigned char i = 0; i < count; i++) {
+        printEvent(i, _events[(oldest + i) & (FLIGHT_RECORDER_EVENTS - 1)]); 
+    }
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Same as print(), but for the events that were saved to the 
+ *          EEPROM the last time a run ended on the error page. 
+ * @returns Returns false if no events have been saved (nothing is printed).
+ */
+/*****************************************************************************/
+bool FlightRecorder::printSaved() {
+#ifdef FLIGHT_RECORDER
+    if(EEPROM.read(FLIGHT_LOG_EEPROM_ADDRESS) != FLIGHT_LOG_MAGIC) {
+        return false; 
+    }
+    while(!telemetry.isAtFrameBoundary()) {
+        telemetry.update(); 
+    }
+    unsigned char count = min(EEPROM.read(FLIGHT_LOG_EEPROM_ADDRESS + 1), (unsigned char)FLIGHT_RECORDER_EVENTS); 
+    for(unsigned char i = 0; i < count; i++) {
+        FlightEvent event; 
+        EEPROM.get(FLIGHT_LOG_EEPROM_ADDRESS + 2 + i*sizeof(FlightEvent), event); 
+        printEvent(i, event); 
+    }
+    return true; 
+#else
+    return false; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints one event, with the names of the commands instead of 
+ *          their codes. 
+ * @param   number  The event's place in the printed list (0 is the oldest). 
+ * @param   event   The event. 
+ */
+/*****************************************************************************/
+void FlightRecorder::printEvent(unsigned char number, const FlightEvent& event) {
+#ifdef FLIGHT_RECORDER
+    FlightEventSource source = (FlightEventSource)((event.flags >> 4) & 0x03); 
+    Serial.print(F("flight ")); 
+    Serial.print(number); 
+    Serial.print(F(" t=")); 
+    Serial.print(event.timeMs); 
+    Serial.print(F(" ch=")); 
+    Serial.print(event.flags & 0x03); 
+    Serial.print(' '); 
+    const char* const* names = NULL; 
+    unsigned char nameCount = 0; 
+    switch(source) {
+        case FlightEventSource::algorithm: 
+            Serial.print(F("algorithm ")); 
+            names = algorithmCommandNames; 
+            nameCount = NAME_COUNT(algorithmCommandNames); 
+            break; 
+        case FlightEventSource::stepper: 
+            Serial.print(F("stepper ")); 
+            names = stepperCommandNames; 
+            nameCount = NAME_COUNT(stepperCommandNames); 
+            break; 
+        case FlightEventSource::result: 
+            Serial.print(F("result ")); 
+            names = algorithmStateNames; 
+            nameCount = NAME_COUNT(algorithmStateNames); 
+            break; 
+        case FlightEventSource::indexDrift: 
+            Serial.print(F("indexDrift ")); 
+            break; 
+    }
+    if(names == NULL) {
+        Serial.print((signed char)event.code); 
+    }
+    else if(event.code < nameCount) {
+        Serial.print((const __FlashStringHelper*)pgm_read_ptr(&names[event.code])); 
+    }
+    else {
+        Serial.print(event.code);   //from a build where the enums were different
+    }
+    Serial.print(F(" step=")); 
+    Serial.print(event.step); 
+    Serial.print(F(" limit=")); 
+    Serial.println((event.flags >> 2) & 0x01); 
+#else
+    (void)number; 
+    (void)event; 
+#endif
+}
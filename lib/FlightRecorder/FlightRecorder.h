@@ -0,0 +1,118 @@
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <Arduino.h>
+#include "Common.h"
+
+//add -D FLIGHT_RECORDER to the build flags to keep the last FLIGHT_RECORDER_EVENTS state changes of the algorithm and the
+//stepper motors in a ring buffer in SRAM. Recording an event only copies 8 bytes (no formatting, nothing is allocated),
+//the names are added when the events are printed. When a run ends on the error page, the events are saved to the EEPROM,
+//a few bytes per loop pass (see update()), so they can still be read after the board has been reset. Both are printed by the remote "flight" command (see
+//RemoteControl.h), one line per event, oldest first: 
+//    flight 12 t=123456 ch=0 algorithm servoUp step=57 limit=0
+//    flight 13 t=123460 ch=0 stepper goToThirdPosition step=57 limit=0
+//the time is millis(), the step is the stepper's dead-reckoned step (0 to NUMBER_OF_STEPS - 1), and the limit switch 
+//level is the one the algorithm last read. Without the flag, the functions are empty and record() compiles to nothing
+#define FLIGHT_RECORDER_BAUD 115200   //same as monitor_speed
+#define FLIGHT_LOG_MAGIC 0x5A         //marks a saved log in the EEPROM (erased EEPROM reads 0xFF)
+#define FLIGHT_SAVE_BYTES_PER_UPDATE 16   //bytes compared per update() while saving, at most one of them is written
+
+//what an event's code is
+enum class FlightEventSource : unsigned char {
+    algorithm,    //the algorithm switched to another command, the code is the AlgorithmCommand
+    stepper,      //a stepper command was completed, the code is the StepperCommand
+    result,       //the run ended, the code is the AlgorithmState (complete or error)
+    indexDrift    //the position was corrected at the index sensor, the code is the drift in steps (signed)
+};
+
+struct FlightEvent {
+    uint32_t timeMs;   //millis()
+    unsigned char flags;   //bits 0-1: channel, bit 2: limit switch level, bits 4-5: FlightEventSource
+    unsigned char code; 
+    int16_t step; 
+};
+static_assert(sizeof(FlightEvent) * FLIGHT_RECORDER_EVENTS + 2 == FLIGHT_LOG_BLOCK_SIZE, "FLIGHT_LOG_BLOCK_SIZE (Common.h) doesn't match FlightEvent"); 
+static_assert((FLIGHT_RECORDER_EVENTS & (FLIGHT_RECORDER_EVENTS - 1)) == 0, "FLIGHT_RECORDER_EVENTS has to be a power of 2"); 
+
+class FlightRecorder {
+public:
+    void init(); 
+    void record(FlightEventSource source, unsigned char code, unsigned char channel, int step); 
+    void updateLimitSwitch(unsigned char channel, bool state); 
+    void save(); 
+    void update(); 
+    void print(); 
+    bool printSaved(); 
+
+private:
+    void printEvent(unsigned char number, const FlightEvent& event); 
+#ifdef FLIGHT_RECORDER
+    FlightEvent _events[FLIGHT_RECORDER_EVENTS]; 
+    unsigned char _nextEvent;   //the oldest event once the buffer is full
+    bool _isFull; 
+    unsigned char _limitSwitchLevels;   //one bit per channel
+    bool _isSaving;   //no events are recorded while the ring buffer is being saved
+    unsigned char _saveCount; 
+    unsigned char _saveOldest; 
+    int _saveOffset;   //next byte of the saved block to write, after the magic byte
+#endif
+};
+extern FlightRecorder flightRecorder; 
+
+/*****************************************************************************/
+/**
+ * @brief   Adds an event to the ring buffer, over the oldest one once it's
+ *          full. Defined here so that it's inlined where the events happen.
+ *          Events are dropped while the buffer is being saved (see save()).
+ * @param   source  What the code is (see FlightEventSource). 
+ * @param   code    The command, result or drift. 
+ * @param   channel The channel (see ChannelPins.h). 
+ * @param   step    The stepper's current step. 
+ */
+/*****************************************************************************/
+inline void FlightRecorder::record(FlightEventSource source, unsigned char code, unsigned char channel, int step) {
+#ifdef FLIGHT_RECORDER
+    if(_isSaving) {
+        return; 
+    }
+    FlightEvent& event = _events[_nextEvent]; 
+    event.timeMs = millis(); 
+    event.flags = channel | (((_limitSwitchLevels >> channel) & 1) << 2) | ((unsigned char)source << 4); 
+    event.code = code; 
+    event.step = step; 
+    _nextEvent = (_nextEvent + 1) & (FLIGHT_RECORDER_EVENTS - 1); 
+    if(_nextEvent == 0) {
+        _isFull = true; 
+    }
+#else
+    (void)source; 
+    (void)code; 
+    (void)channel; 
+    (void)step; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Keeps the limit switch level that the next events are recorded 
+ *          with (call where the algorithm reads the switch). 
+ * @param   channel The channel (see ChannelPins.h). 
+ * @param   state   LIMIT_SWITCH_ACTIVATED or LIMIT_SWITCH_RELEASED. 
+ */
+/*****************************************************************************/
+inline void FlightRecorder::updateLimitSwitch(unsigned char channel, bool state) {
+#ifdef FLIGHT_RECORDER
+    if(state) {
+        _limitSwitchLevels |= (1 << channel); 
+    }
+    else {
+        _limitSwitchLevels &= ~(1 << channel); 
+    }
+#else
+    (void)channel; 
+    (void)state; 
+#endif
+}
+
+#endif
@@ -0,0 +1,223 @@
+
+#include <Arduino.h>
+#include "HeadlessDisplay.h"
+#include "Telemetry.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Starts the serial port. This function should only be called once
+ *          when the microcontroller boots (call in setup).
+ */
+/*****************************************************************************/
+void HeadlessDisplay::init() {
+    Serial.begin(HEADLESS_BAUD);
+    reconfig();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Same as Display::reconfig(), called before each run.
+ */
+/*****************************************************************************/
+void HeadlessDisplay::reconfig() {
+    _previousPage = DisplayPage::notAssigned;
+    for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+        _previousChannelState[i] = AlgorithmState::running;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   There is no LCD to bring up.
+ * @returns Always returns true.
+ */
+/*****************************************************************************/
+bool HeadlessDisplay::bringUp() {
+    return true;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints "event idle" once.
+ */
+/*****************************************************************************/
+void HeadlessDisplay::drawOnce_homePage() {
+    if(_previousPage != DisplayPage::home && isSerialFree(HEADLESS_SHORT_LINE_SIZE)) {   //if a frame is being sent (or the line doesn't fit yet), it's tried again on the next call
+        Serial.println(F("event idle"));
+        _previousPage = DisplayPage::home;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints "event running" once.
+ */
+/*****************************************************************************/
+void HeadlessDisplay::drawOnce_runProgramPage3() {
+    if(_previousPage != DisplayPage::runProgram3 && isSerialFree(HEADLESS_SHORT_LINE_SIZE)) {
+        Serial.println(F("event running"));
+        _previousPage = DisplayPage::runProgram3;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Nothing is printed for each combination, the status command (see
+ *          RemoteControl.h) and the telemetry frames give the progress.
+ */
+/*****************************************************************************/
+void HeadlessDisplay::drawOnce_updatedCombination(char firstPos, char secondPos, char thirdPos) {
+    (void)firstPos; (void)secondPos; (void)thirdPos;
+}
+
+void HeadlessDisplay::drawOnce_updatedProgress(unsigned int attemptNumber, unsigned int plannedAttempts, unsigned long remainingMs) {
+    (void)attemptNumber; (void)plannedAttempts; (void)remainingMs;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints "event running" once, and starts timing the channels.
+ */
+/*****************************************************************************/
+void HeadlessDisplay::drawOnce_channelsPage() {
+    if(_previousPage != DisplayPage::channels && isSerialFree(HEADLESS_SHORT_LINE_SIZE)) {
+        Serial.println(F("event running"));
+        _previousPage = DisplayPage::channels;
+        _startTimeMs = millis();
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints how a channel's run ended, once.
+ * @param   channel The channel.
+ * @param   firstPos    The first position.
+ * @param   secondPos   The second position.
+ * @param   thirdPos    The third position.
+ * @param   attemptNumber   The number of attempts made.
+ * @param   plannedAttempts Not used.
+ * @param   state   The channel's AlgorithmState.
+ */
+/*****************************************************************************/
+void HeadlessDisplay::drawOnce_updatedChannel(unsigned char channel, char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber, unsigned int plannedAttempts, AlgorithmState state) {
+    (void)plannedAttempts;
+    if(state == _previousChannelState[channel] || !isSerialFree(state == AlgorithmState::complete ? HEADLESS_OPENED_LINE_SIZE : HEADLESS_SHORT_LINE_SIZE)) {
+        return;
+    }
+    if(state == AlgorithmState::complete) {
+        printOpened(channel, firstPos, secondPos, thirdPos, attemptNumber);
+        Serial.println((millis() - _startTimeMs) / 1000);
+    }
+    else if(state == AlgorithmState::error) {
+        printFailed(channel);
+    }
+    _previousChannelState[channel] = state;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints the opened combination once.
+ * @param   firstPos    The first position.
+ * @param   secondPos   The second position.
+ * @param   thirdPos    The third position.
+ * @param   attemptNumber   The number of attempts made.
+ * @param   startTimeMillis When the run started.
+ * @param   expectedAttempts    Not used.
+ * @param   searchPass  Not used.
+ */
+/*****************************************************************************/
+void HeadlessDisplay::drawOnce_resultsPage(char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber, unsigned long startTimeMillis, unsigned int expectedAttempts, unsigned char searchPass) {
+    (void)expectedAttempts; (void)searchPass;
+    if(_previousPage != DisplayPage::results && isSerialFree(HEADLESS_OPENED_LINE_SIZE)) {
+        printOpened(0, firstPos, secondPos, thirdPos, attemptNumber);
+        Serial.println((millis() - startTimeMillis) / 1000);
+        _previousPage = DisplayPage::results;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints that the lock didn't open, once.
+ */
+/*****************************************************************************/
+void HeadlessDisplay::drawOnce_errorPage() {
+    if(_previousPage != DisplayPage::error && isSerialFree(HEADLESS_SHORT_LINE_SIZE)) {
+        printFailed(0);
+        _previousPage = DisplayPage::error;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   There are no buttons, so the pages are only left with the remote
+ *          control commands.
+ * @returns Returns the same page.
+ */
+/*****************************************************************************/
+DisplayPage HeadlessDisplay::monitorInputs_homePage() {
+    return DisplayPage::home;
+}
+
+DisplayPage HeadlessDisplay::monitorInputs_runProgramPage3() {
+    return DisplayPage::runProgram3;
+}
+
+DisplayPage HeadlessDisplay::monitorInputs_channelsPage() {
+    return DisplayPage::channels;
+}
+
+DisplayPage HeadlessDisplay::monitorInputs_resultsPage() {
+    return DisplayPage::results;
+}
+
+DisplayPage HeadlessDisplay::monitorInputs_errorPage() {
+    return DisplayPage::error;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if a line can be printed without ending up in the middle
+ *          of a telemetry frame, and without waiting for room in the serial
+ *          port's transmit buffer (like RemoteControl::sendReply()).
+ * @note    An "event opened" line with a long run time can be a few bytes 
+ *          longer than the transmit buffer. It waits for the buffer to be 
+ *          empty, and its last bytes go out while the first ones are sent
+ *          (under 0.5ms at 115200 baud).
+ * @param   lineSize    The longest that the line can be, with the line 
+ *          ending (HEADLESS_SHORT_LINE_SIZE or HEADLESS_OPENED_LINE_SIZE).
+ * @returns Returns true if the line can be printed now.
+ */
+/*****************************************************************************/
+bool HeadlessDisplay::isSerialFree(unsigned char lineSize) {
+    return telemetry.isAtFrameBoundary() && Serial.availableForWrite() >= lineSize;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints the start of an "event opened" line, up to "time=".
+ */
+/*****************************************************************************/
+void HeadlessDisplay::printOpened(unsigned char channel, char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber) {
+    Serial.print(F("event opened ch="));
+    Serial.print(channel);
+    Serial.print(F(" attempts="));
+    Serial.print(attemptNumber);
+    Serial.print(F(" combination="));
+    Serial.print((int)firstPos);
+    Serial.print('-');
+    Serial.print((int)secondPos);
+    Serial.print('-');
+    Serial.print((int)thirdPos);
+    Serial.print(F(" time="));
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints an "event failed" line (the status command gives the
+ *          number of attempts).
+ */
+/*****************************************************************************/
+void HeadlessDisplay::printFailed(unsigned char channel) {
+    Serial.print(F("event failed ch="));
+    Serial.println(channel);
+}
@@ -0,0 +1,60 @@
+
+#ifndef HEADLESS_DISPLAY_H
+#define HEADLESS_DISPLAY_H
+
+#include <Arduino.h>
+#include "Algorithm.h"
+#include "Common.h"
+#include "DisplayPage.h"
+
+//add -D HEADLESS to the build flags (or use the Headless environment in platformio.ini) for rigs without the LCD and the
+//touch screen. Display.h isn't included then, so the display libraries and the fonts aren't built, and main.cpp only
+//keeps the pages that a run goes through. The rig is driven with the remote control commands (see RemoteControl.h),
+//and instead of drawing the pages, HeadlessDisplay prints one line to the serial port when something changes:
+//    event idle
+//    event running
+//    event opened ch=0 attempts=123 combination=4-18-30 time=456
+//    event failed ch=0
+//the time is in seconds. Like the replies, the lines are only sent between telemetry frames (see Telemetry.h), and only
+//once the serial port's transmit buffer has room for them, so printing them never waits (see isSerialFree())
+#if defined(HEADLESS) && !defined(REMOTE_CONTROL)
+  #error "The headless build is driven over the serial port, add -D REMOTE_CONTROL"
+#endif
+
+#define HEADLESS_BAUD 115200   //same as monitor_speed
+#define HEADLESS_SHORT_LINE_SIZE 20   //the longest of the fixed lines ("event failed ch=0"), with the line ending
+#define HEADLESS_OPENED_LINE_SIZE (SERIAL_TX_BUFFER_SIZE - 1)   //an "event opened" line waits for an empty transmit buffer
+
+//has the same functions as Display for the pages that are kept, so main.cpp calls them the same way
+class HeadlessDisplay {
+public:
+    void init();
+    void reconfig();
+    bool bringUp();
+
+    void drawOnce_homePage();
+    void drawOnce_runProgramPage3();
+    void drawOnce_updatedCombination(char firstPos, char secondPos, char thirdPos);
+    void drawOnce_updatedProgress(unsigned int attemptNumber, unsigned int plannedAttempts, unsigned long remainingMs);
+    void drawOnce_channelsPage();
+    void drawOnce_updatedChannel(unsigned char channel, char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber, unsigned int plannedAttempts, AlgorithmState state);
+    void drawOnce_resultsPage(char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber, unsigned long startTimeMillis, unsigned int expectedAttempts, unsigned char searchPass);
+    void drawOnce_errorPage();
+
+    DisplayPage monitorInputs_homePage();
+    DisplayPage monitorInputs_runProgramPage3();
+    DisplayPage monitorInputs_channelsPage();
+    DisplayPage monitorInputs_resultsPage();
+    DisplayPage monitorInputs_errorPage();
+
+private:
+    bool isSerialFree(unsigned char lineSize);
+    void printOpened(unsigned char channel, char firstPos, char secondPos, char thirdPos, unsigned int attemptNumber);
+    void printFailed(unsigned char channel);
+
+    DisplayPage _previousPage;   //the event for a page is printed once, like a page is drawn once
+    unsigned long _startTimeMs;   //when the channels page was first shown
+    AlgorithmState _previousChannelState[NUMBER_OF_CHANNELS];
+};
+
+#endif
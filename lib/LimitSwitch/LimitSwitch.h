@@ -1,16 +1,21 @@
-
-#ifndef LIMIT_SWITCH_H
-#define LIMIT_SWITCH_H
-
-#define LIMIT_SWITCH_PIN 38  
-
-#define LIMIT_SWITCH_RELEASED 0
-#define LIMIT_SWITCH_ACTIVATED 1
-
-class LimitSwitch {
-public:
-    void init();
-    bool getState(); 
-};
-
-#endif
+
+#ifndef LIMIT_SWITCH_H
+#define LIMIT_SWITCH_H
+
+#include <Arduino.h>
+
+#define LIMIT_SWITCH_PIN 38   //channel 0 (see ChannelPins.h)
+
+#define LIMIT_SWITCH_RELEASED 0
+#define LIMIT_SWITCH_ACTIVATED 1
+
+class LimitSwitch {
+public:
+    void init(uint8_t pin);
+    bool getState(); 
+
+private:
+    uint8_t _pin; 
+};
+
+#endif
@@ -0,0 +1,34 @@
+
+#include <Arduino.h>
+#include "LoopRate.h"
+#include "Telemetry.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Counts a pass through loop() (call first thing in loop), and 
+ *          every LOOP_RATE_INTERVAL_MS prints the number of passes per 
+ *          second and the longest pass to the serial monitor (115200 baud). 
+ * @note    Does nothing unless -D PRINT_LOOP_RATE is set. The line is held 
+ *          back while a telemetry frame is being sent. 
+ */
+/*****************************************************************************/
+void LoopRate::update() {
+#ifdef PRINT_LOOP_RATE
+    unsigned long nowMicros = micros(); 
+    if(_passes > 0 && nowMicros - _previousPassMicros > _longestPassMicros) {
+        _longestPassMicros = nowMicros - _previousPassMicros; 
+    }
+    _previousPassMicros = nowMicros; 
+    _passes++; 
+    unsigned long elapsedMs = millis() - _intervalStartMs; 
+    if(elapsedMs >= LOOP_RATE_INTERVAL_MS && telemetry.isAtFrameBoundary()) {
+        Serial.print(F("Loop rate (passes/s, longest pass in us): ")); 
+        Serial.print(_passes * 1000UL / elapsedMs); 
+        Serial.print(F(", ")); 
+        Serial.println(_longestPassMicros); 
+        _intervalStartMs = millis(); 
+        _passes = 0;   //the print isn't counted in the next interval's longest pass
+        _longestPassMicros = 0; 
+    }
+#endif
+}
@@ -0,0 +1,22 @@
+
+#ifndef LOOP_RATE_H
+#define LOOP_RATE_H
+
+#define LOOP_RATE_INTERVAL_MS 5000   //how often the rate is printed
+
+//counts the passes through loop(), to compare builds (for example the Headless environment with CustomBoard)
+class LoopRate {
+public:
+    void update(); 
+
+private:
+#ifdef PRINT_LOOP_RATE
+    unsigned long _intervalStartMs; 
+    unsigned long _previousPassMicros; 
+    unsigned long _passes; 
+    unsigned long _longestPassMicros; 
+#endif
+};
+extern LoopRate loopRate; 
+
+#endif
@@ -0,0 +1,173 @@
+
+#include <Arduino.h>
+#include "MemoryMonitor.h"
+#include "Telemetry.h"
+
+#ifdef MEMORY_MONITOR
+//set by the linker (.data, then .bss, then the heap, which grows up towards the stack)
+extern uint8_t __data_start; 
+extern uint8_t __data_end; 
+extern uint8_t __bss_start; 
+extern uint8_t __bss_end; 
+extern uint8_t __heap_start; 
+extern char* __brkval;   //the top of the heap (avr-libc's malloc()), NULL until something has been allocated
+
+#define STRINGIFY(value) #value
+#define EXPAND_AND_STRINGIFY(value) STRINGIFY(value)
+
+void paintStack() __attribute__((naked, used, section(".init1"))); 
+
+/*****************************************************************************/
+/**
+ * @brief   Fills the SRAM from the start of the heap to the top of the stack
+ *          with STACK_CANARY. Placed in .init1, so it's run right after 
+ *          reset, before the stack is used and before .data and .bss are 
+ *          set up (they aren't filled). 
+ * @note    Written in assembly because r1 isn't cleared yet in .init1, and
+ *          a naked function can only hold basic asm. 
+ */
+/*****************************************************************************/
+void paintStack() {
+    __asm__ volatile (
+        "    ldi r30, lo8(__heap_start)\n"
+        "    ldi r31, hi8(__heap_start)\n"
+        "    ldi r24, " EXPAND_AND_STRINGIFY(STACK_CANARY) "\n"
+        "    ldi r25, hi8(" EXPAND_AND_STRINGIFY(RAMEND) ")\n"
+        "    rjmp 2f\n"
+        "1:  st Z+, r24\n"
+        "2:  cpi r30, lo8(" EXPAND_AND_STRINGIFY(RAMEND) ")\n"
+        "    cpc r31, r25\n"
+        "    brlo 1b\n"   //up to and including RAMEND
+        "    breq 1b\n"
+    ); 
+}
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   Starts the serial port. This function should only be called once
+ *          when the microcontroller boots (call in setup).
+ * @note    Does nothing unless -D MEMORY_MONITOR is set. 
+ */
+/*****************************************************************************/
+void MemoryMonitor::init() {
+#ifdef MEMORY_MONITOR
+    Serial.begin(MEMORY_MONITOR_BAUD); 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the size of the global and static variables (.data and 
+ *          .bss), which is known when linking. 
+ * @returns The size in bytes (0 unless -D MEMORY_MONITOR is set). 
+ */
+/*****************************************************************************/
+unsigned int MemoryMonitor::getStaticBytes() {
+#ifdef MEMORY_MONITOR
+    return (&__data_end - &__data_start) + (&__bss_end - &__bss_start); 
+#else
+    return 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the size of the heap, which only grows if something is 
+ *          allocated with malloc() or new. 
+ * @returns The size in bytes. 
+ */
+/*****************************************************************************/
+unsigned int MemoryMonitor::getHeapBytes() {
+#ifdef MEMORY_MONITOR
+    if(__brkval == NULL) {
+        return 0; 
+    }
+    return (uint8_t*)__brkval - &__heap_start; 
+#else
+    return 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the deepest that the stack has been since reset (the high-
+ *          water mark), from the bytes that no longer hold STACK_CANARY. 
+ * @note    Reads up to the whole free SRAM, which takes about a millisecond.
+ * @returns The size in bytes. 
+ */
+/*****************************************************************************/
+unsigned int MemoryMonitor::getMaxStackBytes() {
+#ifdef MEMORY_MONITOR
+    return (uint8_t*)RAMEND - (&__heap_start + getHeapBytes()) + 1 - getMinFreeBytes(); 
+#else
+    return 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the number of bytes between the top of the heap and the 
+ *          stack pointer right now. 
+ * @returns The size in bytes. 
+ */
+/*****************************************************************************/
+unsigned int MemoryMonitor::getFreeBytes() {
+#ifdef MEMORY_MONITOR
+    return (uint8_t*)SP - (&__heap_start + getHeapBytes()); 
+#else
+    return 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the smallest that the free SRAM has been since reset: the 
+ *          bytes above the heap that the stack has never reached. 
+ * @note    Reads up to the whole free SRAM, which takes about a millisecond.
+ * @returns The size in bytes. 
+ */
+/*****************************************************************************/
+unsigned int MemoryMonitor::getMinFreeBytes() {
+#ifdef MEMORY_MONITOR
+    const uint8_t* pByte = &__heap_start + getHeapBytes(); 
+    const uint8_t* pStackPointer = (const uint8_t*)SP;   //the byte that the next push goes to
+    unsigned int count = 0; 
+    while(pByte + count <= pStackPointer && pByte[count] == STACK_CANARY) {
+        count++; 
+    }
+    return count; 
+#else
+    return 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints the SRAM use to the serial port (see MemoryMonitor.h 
+ *          for the format). 
+ * @note    Waits for the telemetry frame that is being sent to be finished 
+ *          (see Telemetry.h). 
+ */
+/*****************************************************************************/
+void MemoryMonitor::print() {
+#ifdef MEMORY_MONITOR
+    while(!telemetry.isAtFrameBoundary()) {
+        telemetry.update(); 
+    }
+    Serial.print(F("memory data=")); 
+    Serial.print((unsigned int)(&__data_end - &__data_start)); 
+    Serial.print(F(" bss=")); 
+    Serial.print((unsigned int)(&__bss_end - &__bss_start)); 
+    Serial.print(F(" heap=")); 
+    Serial.print(getHeapBytes()); 
+    Serial.print(F(" stack=")); 
+    Serial.print(RAMEND - SP); 
+    Serial.print(F(" stackMax=")); 
+    Serial.print(getMaxStackBytes()); 
+    Serial.print(F(" free=")); 
+    Serial.print(getFreeBytes()); 
+    Serial.print(F(" minFree=")); 
+    Serial.println(getMinFreeBytes()); 
+#endif
+}
@@ -0,0 +1,29 @@
+
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+//add -D MEMORY_MONITOR to the build flags to measure how much of the SRAM (8KB) is used. Before the constructors run, the
+//SRAM between the end of the global variables (.data and .bss) and the top of the stack is filled with STACK_CANARY, and
+//the bytes that still hold it have never been used by the stack or the heap. The results are printed by the remote
+//"memory" command (see RemoteControl.h) and drawn on the diagnostics page (from the last setup page): 
+//    memory data=312 bss=3630 heap=0 stack=42 stackMax=611 free=4207 minFree=3570
+//everything is in bytes. minFree is the headroom that a new buffer can be sized against, it's a few bytes too high if the
+//stack happened to leave STACK_CANARY behind at its deepest point. tools/memory_report.py splits .data and .bss by module
+#define STACK_CANARY 0xC5
+#define MEMORY_MONITOR_BAUD 115200   //same as monitor_speed
+
+class MemoryMonitor {
+public:
+    void init(); 
+    unsigned int getStaticBytes(); 
+    unsigned int getMaxStackBytes(); 
+    unsigned int getFreeBytes(); 
+    unsigned int getMinFreeBytes(); 
+    void print(); 
+
+private:
+    unsigned int getHeapBytes(); 
+};
+extern MemoryMonitor memoryMonitor; 
+
+#endif
@@ -0,0 +1,112 @@
+
+#include <EEPROM.h>
+#include "PriorHistogram.h"
+#include "Common.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Loads the histogram of previously opened combinations for a lock
+ *          profile from the EEPROM. If the profile has never been written
+ *          (or NO_LOCK_PROFILE is selected), every count is zero, which
+ *          gives a uniform prior.
+ * @param   lockProfile The lock profile (1 to NUMBER_OF_LOCK_PROFILES), or
+ *          NO_LOCK_PROFILE.
+ */
+/*****************************************************************************/
+void PriorHistogram::load(unsigned char lockProfile) {
+    if(lockProfile > NUMBER_OF_LOCK_PROFILES) {
+        lockProfile = NO_LOCK_PROFILE;
+    }
+    _lockProfile = lockProfile;
+
+    bool isBlockValid = (_lockProfile != NO_LOCK_PROFILE && EEPROM.read(getEepromAddress()) == PRIOR_HISTOGRAM_MAGIC);
+    for(unsigned char wheel = 0; wheel < 3; wheel++) {
+        for(unsigned char zone = 0; zone < NUMBER_OF_ZONES; zone++) {
+            _zoneCounts[wheel][zone] = isBlockValid ? EEPROM.read(getEepromAddress() + 1 + wheel*NUMBER_OF_ZONES + zone) : 0;
+        }
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Adds an opened combination to the histogram and saves it to the
+ *          EEPROM. When a count would overflow, every count of that wheel is
+ *          halved so that older results slowly lose weight.
+ * @note    Nothing is saved if no lock profile is selected.
+ * @param   firstPos    The first position that opened the lock.
+ * @param   secondPos   The second position that opened the lock.
+ * @param   thirdPos    The third position that opened the lock.
+ */
+/*****************************************************************************/
+void PriorHistogram::recordSuccess(char firstPos, char secondPos, char thirdPos) {
+    if(_lockProfile == NO_LOCK_PROFILE) {
+        return;
+    }
+    const char positions[3] = {firstPos, secondPos, thirdPos};
+    for(unsigned char wheel = 0; wheel < 3; wheel++) {
+        unsigned char zone = positionToZoneIndex(positions[wheel]);
+        if(_zoneCounts[wheel][zone] == MAX_ZONE_COUNT) {
+            for(unsigned char i = 0; i < NUMBER_OF_ZONES; i++) {
+                _zoneCounts[wheel][i] /= 2;
+            }
+        }
+        _zoneCounts[wheel][zone]++;
+    }
+
+    EEPROM.update(getEepromAddress(), PRIOR_HISTOGRAM_MAGIC);
+    for(unsigned char wheel = 0; wheel < 3; wheel++) {
+        for(unsigned char zone = 0; zone < NUMBER_OF_ZONES; zone++) {
+            EEPROM.update(getEepromAddress() + 1 + wheel*NUMBER_OF_ZONES + zone, _zoneCounts[wheel][zone]);   //only writes to eeprom if the value is different
+        }
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the (unnormalized) prior weight of a combination. The wheels
+ *          are treated as independent, and each count is incremented by one
+ *          so that zones that have never opened a lock are still tried.
+ * @param   firstZoneIndex  Zone index (0 to NUMBER_OF_ZONES - 1) of the first
+ *          position.
+ * @param   secondZoneIndex Zone index of the second position.
+ * @param   thirdZoneIndex  Zone index of the third position.
+ * @returns Returns the weight. Combinations with a higher weight are more
+ *          likely to open the lock.
+ */
+/*****************************************************************************/
+unsigned long PriorHistogram::getWeight(unsigned char firstZoneIndex, unsigned char secondZoneIndex, unsigned char thirdZoneIndex) {
+    return (unsigned long)(_zoneCounts[0][firstZoneIndex] + 1) * (_zoneCounts[1][secondZoneIndex] + 1) * (_zoneCounts[2][thirdZoneIndex] + 1);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the lock profile that is loaded.
+ * @returns Returns the lock profile, or NO_LOCK_PROFILE.
+ */
+/*****************************************************************************/
+unsigned char PriorHistogram::getLockProfile() {
+    return _lockProfile;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Converts a dial position to the zone that it belongs to. Zones are
+ *          counted from dial position 0, so the index doesn't depend on the
+ *          first zone's starting position.
+ * @param   position    The dial position.
+ * @returns Returns the zone index (0 to NUMBER_OF_ZONES - 1).
+ */
+/*****************************************************************************/
+unsigned char PriorHistogram::positionToZoneIndex(char position) {
+    return (position % NUMBER_OF_POSITIONS) / ZONE_OFFSET;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the EEPROM address of the loaded lock profile's block.
+ * @returns Returns the address of the block's magic byte.
+ */
+/*****************************************************************************/
+int PriorHistogram::getEepromAddress() {
+    return PRIOR_HISTOGRAM_EEPROM_ADDRESS + (_lockProfile - 1)*PRIOR_HISTOGRAM_BLOCK_SIZE;
+}
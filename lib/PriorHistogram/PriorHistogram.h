@@ -0,0 +1,24 @@
+
+#ifndef PRIOR_HISTOGRAM_H
+#define PRIOR_HISTOGRAM_H
+
+#include "Common.h"
+
+#define PRIOR_HISTOGRAM_MAGIC 0xA5   //marks a histogram block that has been written at least once (erased EEPROM reads 0xFF)
+#define MAX_ZONE_COUNT 255
+
+class PriorHistogram {
+public:
+    void load(unsigned char lockProfile);
+    void recordSuccess(char firstPos, char secondPos, char thirdPos);
+    unsigned long getWeight(unsigned char firstZoneIndex, unsigned char secondZoneIndex, unsigned char thirdZoneIndex);
+    unsigned char getLockProfile();
+    static unsigned char positionToZoneIndex(char position);
+
+private:
+    int getEepromAddress();
+    unsigned char _lockProfile;
+    unsigned char _zoneCounts[3][NUMBER_OF_ZONES];   //[wheel][zone]
+};
+
+#endif
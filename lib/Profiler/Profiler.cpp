@@ -0,0 +1,248 @@
+
+#include <Arduino.h>
+#include <util/atomic.h>
+#include "Profiler.h"
+#include "Telemetry.h"
+
+#ifdef PROFILER_ENABLED
+#define PROFILER_TICKS_PER_MICROSECOND (F_CPU / 8000000UL)   //Timer3 runs at clk/8
+
+//printed next to the results, in the same order as ProfileSection
+const char profileSectionName_loop[] PROGMEM = "loop"; 
+const char profileSectionName_algorithmRun[] PROGMEM = "algorithmRun"; 
+const char profileSectionName_rotateOneStep[] PROGMEM = "rotateOneStep"; 
+const char profileSectionName_touchRead[] PROGMEM = "touchRead"; 
+const char profileSectionName_drawPage[] PROGMEM = "drawPage"; 
+const char profileSectionName_drawCombination[] PROGMEM = "drawCombination"; 
+const char profileSectionName_drawProgress[] PROGMEM = "drawProgress"; 
+const char profileSectionName_drawChannel[] PROGMEM = "drawChannel"; 
+const char* const profileSectionNames[(unsigned char)ProfileSection::count] PROGMEM = {
+    profileSectionName_loop, 
+    profileSectionName_algorithmRun, 
+    profileSectionName_rotateOneStep, 
+    profileSectionName_touchRead, 
+    profileSectionName_drawPage, 
+    profileSectionName_drawCombination, 
+    profileSectionName_drawProgress, 
+    profileSectionName_drawChannel
+}; 
+
+//the upper 16 bits of the tick count. A page draw takes longer than the 32ms that Timer3 covers on its own
+static volatile unsigned int timer3Overflows; 
+
+ISR(TIMER3_OVF_vect) {
+    timer3Overflows++; 
+}
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   Starts Timer3 counting at clk/8, with the overflow interrupt 
+ *          extending the count to 32 bits, and clears the results. 
+ * @note    Does nothing unless -D PROFILER_ENABLED is set. Timer3 isn't 
+ *          used by anything else (the servos use Timer5, the steps Timer1). 
+ */
+/*****************************************************************************/
+void Profiler::init() {
+#ifdef PROFILER_ENABLED
+    Serial.begin(PROFILER_BAUD); 
+    TCCR3A = 0;             //normal mode, counts up to 0xFFFF and wraps
+    TCCR3B = _BV(CS31);     //clk/8
+    TIFR3 = _BV(TOV3);      //clears any overflow flag left from before
+    TIMSK3 |= _BV(TOIE3); 
+    reset(); 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the time since init() in Timer3 ticks (8 CPU cycles each). 
+ * @note    Wraps after about 35 minutes, which the differences taken by 
+ *          ProfileScope don't mind. 
+ * @returns The tick count, or 0 if the profiler isn't enabled. 
+ */
+/*****************************************************************************/
+unsigned long Profiler::getTicks() {
+#ifdef PROFILER_ENABLED
+    unsigned int count; 
+    unsigned int overflows; 
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        count = TCNT3; 
+        overflows = timer3Overflows; 
+        if((TIFR3 & _BV(TOV3)) && count < 0x8000) {   //wrapped after the interrupts were turned off, but not counted yet
+            overflows++; 
+        }
+    }
+    return ((unsigned long)overflows << 16) | count; 
+#else
+    return 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Adds one duration to the results of a section. 
+ * @param   section The section that was timed. 
+ * @param   ticks   How long it took, in Timer3 ticks. 
+ */
+/*****************************************************************************/
+void Profiler::record(ProfileSection section, unsigned long ticks) {
+#ifdef PROFILER_ENABLED
+    SectionStats& stats = _stats[(unsigned char)section]; 
+    if(stats.count == 0 || ticks < stats.minTicks) {
+        stats.minTicks = ticks; 
+    }
+    if(ticks > stats.maxTicks) {
+        stats.maxTicks = ticks; 
+    }
+    stats.count++; 
+    stats.sumTicks += ticks; 
+
+    unsigned long micros = ticks / PROFILER_TICKS_PER_MICROSECOND; 
+    unsigned char bucket = 0; 
+    while(micros != 0 && bucket < PROFILER_BUCKETS - 1) {   //the number of bits in micros
+        micros >>= 1; 
+        bucket++; 
+    }
+    if(stats.histogram[bucket] != 0xFFFF) {   //stops at the largest count rather than wrapping
+        stats.histogram[bucket]++; 
+    }
+#else
+    (void)section; 
+    (void)ticks; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Clears the results of all sections. 
+ */
+/*****************************************************************************/
+void Profiler::reset() {
+#ifdef PROFILER_ENABLED
+    memset(_stats, 0, sizeof(_stats)); 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Prints the results to the serial port (115200 baud), two lines 
+ *          per section that has been timed: 
+ *              profile loop n=1234 min=52 mean=180 max=41230 us
+ *              profile loop hist <64us:1000 <128us:200 <256us:30 ...
+ *          the histogram only lists the buckets that aren't empty. 
+ * @note    Waits for the telemetry frame that is being sent to be finished 
+ *          (see Telemetry.h). Printing takes longer than a pass through 
+ *          loop() normally does, so it shows up in the loop's max. 
+ */
+/*****************************************************************************/
+void Profiler::print() {
+#ifdef PROFILER_ENABLED
+    while(!telemetry.isAtFrameBoundary()) {
+        telemetry.update(); 
+    }
+    for(unsigned char i = 0; i < (unsigned char)ProfileSection::count; i++) {
+        ProfileSection section = (ProfileSection)i; 
+        if(_stats[i].count == 0) {
+            continue; 
+        }
+        const __FlashStringHelper* name = (const __FlashStringHelper*)pgm_read_ptr(&profileSectionNames[i]); 
+        Serial.print(F("profile ")); 
+        Serial.print(name); 
+        Serial.print(F(" n=")); 
+        Serial.print(_stats[i].count); 
+        Serial.print(F(" min=")); 
+        Serial.print(_stats[i].minTicks / PROFILER_TICKS_PER_MICROSECOND); 
+        Serial.print(F(" mean=")); 
+        Serial.print(getMeanMicros(section)); 
+        Serial.print(F(" max=")); 
+        Serial.print(getMaxMicros(section)); 
+        Serial.println(F(" us")); 
+
+        Serial.print(F("profile ")); 
+        Serial.print(name); 
+        Serial.print(F(" hist")); 
+        for(unsigned char bucket = 0; bucket < PROFILER_BUCKETS; bucket++) {
+            if(_stats[i].histogram[bucket] != 0) {
+                Serial.print(F(" <")); 
+                Serial.print(1UL << bucket); 
+                Serial.print(F("us:")); 
+                Serial.print(_stats[i].histogram[bucket]); 
+            }
+        }
+        Serial.println(); 
+    }
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets how many times a section has been timed. 
+ * @param   section The section. 
+ * @returns The count (0 if the profiler isn't enabled). 
+ */
+/*****************************************************************************/
+unsigned long Profiler::getCount(ProfileSection section) {
+#ifdef PROFILER_ENABLED
+    return _stats[(unsigned char)section].count; 
+#else
+    (void)section; 
+    return 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the mean duration of a section. 
+ * @param   section The section. 
+ * @returns The mean in microseconds (0 if the section hasn't been timed). 
+ */
+/*****************************************************************************/
+unsigned long Profiler::getMeanMicros(ProfileSection section) {
+#ifdef PROFILER_ENABLED
+    const SectionStats& stats = _stats[(unsigned char)section]; 
+    if(stats.count == 0) {
+        return 0; 
+    }
+    return (unsigned long)(stats.sumTicks / stats.count / PROFILER_TICKS_PER_MICROSECOND); 
+#else
+    (void)section; 
+    return 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the longest duration of a section. 
+ * @param   section The section. 
+ * @returns The max in microseconds (0 if the section hasn't been timed). 
+ */
+/*****************************************************************************/
+unsigned long Profiler::getMaxMicros(ProfileSection section) {
+#ifdef PROFILER_ENABLED
+    return _stats[(unsigned char)section].maxTicks / PROFILER_TICKS_PER_MICROSECOND; 
+#else
+    (void)section; 
+    return 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the number of durations in one histogram bucket of a 
+ *          section. 
+ * @param   section The section. 
+ * @param   bucket  The bucket, bucket k counts durations shorter than 2^k us
+ *                  (and longer than the previous bucket's). 
+ * @returns The count, which stops at 0xFFFF. 
+ */
+/*****************************************************************************/
+unsigned int Profiler::getBucket(ProfileSection section, unsigned char bucket) {
+#ifdef PROFILER_ENABLED
+    return _stats[(unsigned char)section].histogram[bucket]; 
+#else
+    (void)section; 
+    (void)bucket; 
+    return 0; 
+#endif
+}
@@ -0,0 +1,70 @@
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+//add -D PROFILER_ENABLED to the build flags to time sections of the program on the board. Timer3 is left running at
+//clk/8 (0.5us per tick at 16MHz), and each section that is marked with PROFILE_SCOPE() records how long it took, from
+//the marker to the end of the enclosing block. Without the flag, PROFILE_SCOPE() expands to nothing, Timer3 isn't
+//touched, and the other functions are empty
+//the results are printed to the serial port by the remote "profile" command (see RemoteControl.h) and when the 
+//diagnostics page is opened (from the last setup page), which also draws them
+#define PROFILER_BAUD 115200   //same as monitor_speed
+#define PROFILER_BUCKETS 24    //bucket k counts durations shorter than 2^k us (the last one also counts anything longer)
+
+//the marked sections, in the order they are printed
+enum class ProfileSection : unsigned char {
+    loop,              //one pass through loop() in main.cpp
+    algorithmRun,      //Algorithm::run(), including the steps and the servo moves it starts
+    rotateOneStep,     //StepperControl::rotateOneStep()
+    touchRead,         //DisplayBus::readRawTouch() (under readTouch()), when the touch screen is sampled
+    drawPage,          //the first draw of a page (the drawOnce_...Page() functions in Display.cpp)
+    drawCombination,   //Display::drawOnce_updatedCombination(), when the combination changed
+    drawProgress,      //Display::drawOnce_updatedProgress(), when the progress is redrawn
+    drawChannel,       //Display::drawOnce_updatedChannel(), when the row is redrawn
+    count
+};
+
+class Profiler {
+public:
+    void init(); 
+    unsigned long getTicks(); 
+    void record(ProfileSection section, unsigned long ticks); 
+    void reset(); 
+    void print(); 
+
+    unsigned long getCount(ProfileSection section); 
+    unsigned long getMeanMicros(ProfileSection section); 
+    unsigned long getMaxMicros(ProfileSection section); 
+    unsigned int getBucket(ProfileSection section, unsigned char bucket); 
+
+private:
+#ifdef PROFILER_ENABLED
+    struct SectionStats {
+        unsigned long count; 
+        unsigned long minTicks; 
+        unsigned long maxTicks; 
+        unsigned long long sumTicks; 
+        unsigned int histogram[PROFILER_BUCKETS]; 
+    }; 
+    SectionStats _stats[(unsigned char)ProfileSection::count]; 
+#endif
+};
+extern Profiler profiler; 
+
+#ifdef PROFILER_ENABLED
+//records the time from its construction to the end of the block it's declared in
+class ProfileScope {
+public:
+    ProfileScope(ProfileSection section) : _section(section), _startTicks(profiler.getTicks()) {}
+    ~ProfileScope() { profiler.record(_section, profiler.getTicks() - _startTicks); }
+
+private:
+    ProfileSection _section; 
+    unsigned long _startTicks; 
+};
+  #define PROFILE_SCOPE(section) ProfileScope profileScope(section)
+#else
+  #define PROFILE_SCOPE(section)
+#endif
+
+#endif
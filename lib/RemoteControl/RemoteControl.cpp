@@ -0,0 +1,193 @@
+
+#include <Arduino.h>
+#include "RemoteControl.h"
+#include "Telemetry.h"
+
+//the command words, in the same order as RemoteCommandType (after none)
+const char remoteCommandWord_start[] PROGMEM = "start";
+const char remoteCommandWord_stop[] PROGMEM = "stop";
+const char remoteCommandWord_pause[] PROGMEM = "pause";
+const char remoteCommandWord_resume[] PROGMEM = "resume";
+const char remoteCommandWord_seek[] PROGMEM = "seek";
+const char remoteCommandWord_zone[] PROGMEM = "zone";
+const char remoteCommandWord_servo[] PROGMEM = "servo";
+const char remoteCommandWord_status[] PROGMEM = "status";
+const char remoteCommandWord_profile[] PROGMEM = "profile";
+const char remoteCommandWord_flight[] PROGMEM = "flight";
+const char remoteCommandWord_memory[] PROGMEM = "memory";
+const char* const remoteCommandWords[] PROGMEM = {
+    remoteCommandWord_start,
+    remoteCommandWord_stop,
+    remoteCommandWord_pause,
+    remoteCommandWord_resume,
+    remoteCommandWord_seek,
+    remoteCommandWord_zone,
+    remoteCommandWord_servo,
+    remoteCommandWord_status,
+    remoteCommandWord_profile,
+    remoteCommandWord_flight,
+    remoteCommandWord_memory
+};
+#define NUMBER_OF_REMOTE_COMMANDS (sizeof(remoteCommandWords) / sizeof(remoteCommandWords[0]))
+
+/*****************************************************************************/
+/**
+ * @brief   Starts the serial port. This function should only be called once
+ *          when the microcontroller boots (call in setup).
+ */
+/*****************************************************************************/
+void RemoteControl::init() {
+    Serial.begin(REMOTE_BAUD);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Reads the characters that have been received, and returns a
+ *          command once a whole line is in. This never waits for the serial
+ *          port, so it can be called on every pass of loop(). Lines that
+ *          aren't a valid command are answered here.
+ * @note    While a reply is waiting to be sent, no more characters are
+ *          read (they wait in Serial's receive buffer), so each command is
+ *          answered before the next one is parsed.
+ * @param   pCommand    The command is written here.
+ * @returns Returns true if a command was received. It should be answered
+ *          with beginReply().
+ */
+/*****************************************************************************/
+bool RemoteControl::update(RemoteCommand* pCommand) {
+    if(_isReplyPending) {
+        sendReply();
+        if(_isReplyPending) {
+            return false;
+        }
+    }
+    while(Serial.available() > 0) {
+        char character = Serial.read();
+        if(character == '\r') {
+            continue;
+        }
+        if(character != '\n') {
+            if(_lineLength < REMOTE_LINE_SIZE - 1) {
+                _line[_lineLength] = character;
+                _lineLength++;
+            }
+            else {
+                _isLineTooLong = true;
+            }
+            continue;
+        }
+        _line[_lineLength] = '\0';
+        bool isLineTooLong = _isLineTooLong;
+        _lineLength = 0;
+        _isLineTooLong = false;
+        if(isLineTooLong) {
+            beginReply(F("err line too long"));
+            return false;
+        }
+        if(parseLine(pCommand)) {
+            return true;
+        }
+        if(_isReplyPending) {
+            return false;
+        }
+    }
+    return false;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Splits the line into the command word and its numbers.
+ * @param   pCommand    The command is written here.
+ * @returns Returns true if the line is a command. Empty lines are skipped,
+ *          anything else is answered with an error.
+ */
+/*****************************************************************************/
+bool RemoteControl::parseLine(RemoteCommand* pCommand) {
+    char* word = strtok(_line, " \t");
+    if(word == NULL) {
+        return false;
+    }
+    pCommand->type = RemoteCommandType::none;
+    for(unsigned char i = 0; i < NUMBER_OF_REMOTE_COMMANDS; i++) {
+        if(strcmp_P(word, (const char*)pgm_read_ptr(&remoteCommandWords[i])) == 0) {
+            pCommand->type = (RemoteCommandType)(i + 1);
+            break;
+        }
+    }
+    if(pCommand->type == RemoteCommandType::none) {
+        beginReply(F("err unknown command"));
+        return false;
+    }
+    pCommand->argumentCount = 0;
+    char* argument = strtok(NULL, " \t");
+    while(argument != NULL) {
+        char* argumentEnd;
+        long value = strtol(argument, &argumentEnd, 10);
+        if(*argumentEnd != '\0' || pCommand->argumentCount == REMOTE_MAX_ARGUMENTS) {
+            beginReply(F("err bad argument"));
+            return false;
+        }
+        pCommand->arguments[pCommand->argumentCount] = value;
+        pCommand->argumentCount++;
+        argument = strtok(NULL, " \t");
+    }
+    return true;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Starts the reply to a command. More can be added with addText()
+ *          and addNumber(), and the reply is sent on the next update(). Text
+ *          past REMOTE_REPLY_SIZE is left out.
+ * @param   text    The start of the reply ("ok", "err ...", "status").
+ */
+/*****************************************************************************/
+void RemoteControl::beginReply(const __FlashStringHelper* text) {
+    _replyLength = 0;
+    _isReplyPending = true;
+    addText(text);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Adds text from flash to the reply.
+ */
+/*****************************************************************************/
+void RemoteControl::addText(const __FlashStringHelper* text) {
+    PGM_P character = (PGM_P)text;
+    while(_replyLength < REMOTE_REPLY_SIZE && pgm_read_byte(character) != '\0') {
+        _reply[_replyLength] = pgm_read_byte(character);
+        _replyLength++;
+        character++;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Adds a number to the reply.
+ */
+/*****************************************************************************/
+void RemoteControl::addNumber(long value) {
+    char numberBuffer[12];   //"-2147483648" + '\0'
+    ltoa(value, numberBuffer, 10);
+    for(unsigned char i = 0; numberBuffer[i] != '\0' && _replyLength < REMOTE_REPLY_SIZE; i++) {
+        _reply[_replyLength] = numberBuffer[i];
+        _replyLength++;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sends the reply once it can be handed to Serial in one go, and
+ *          not in the middle of a telemetry frame. Otherwise it's tried
+ *          again on the next update().
+ */
+/*****************************************************************************/
+void RemoteControl::sendReply() {
+    if(!telemetry.isAtFrameBoundary() || Serial.availableForWrite() < _replyLength + 1) {
+        return;
+    }
+    Serial.write((const uint8_t*)_reply, _replyLength);
+    Serial.write('\n');
+    _isReplyPending = false;
+}
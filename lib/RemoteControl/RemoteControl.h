@@ -0,0 +1,66 @@
+
+#ifndef REMOTE_CONTROL_H
+#define REMOTE_CONTROL_H
+
+#include <Arduino.h>
+
+//add -D REMOTE_CONTROL to the build flags (platformio.ini) to run the rig from a computer over the serial port (115200 baud),
+//with tools/rig_cli.py or any terminal. One command per line, the words are separated by spaces:
+//    start [profile [lockId]]   same as going through the run program pages (the profile and the lock ID are saved, as on the pages)
+//    stop                       same as the exit button
+//    pause / resume             the dial stops at the next step, the motors keep holding
+//    seek <attempt> [channel]   skips ahead in the search, up to the planned attempts (see Algorithm::seekAttempt())
+//    zone <0-5>                 the first zone's starting position (setup page 3)
+//    servo <angle>              the servo's bottom position (setup page 5)
+//    status [channel]           for example "status ch=0 running attempts=12/1000 combination=4-18--1"
+//    profile                    prints the profiler's "profile ..." lines before the reply (see Profiler.h)
+//    flight [1]                 prints the flight recorder's "flight ..." lines, 1 for the ones saved at the last error (see FlightRecorder.h)
+//    memory                     prints the memory monitor's "memory ..." line before the reply (see MemoryMonitor.h)
+//every command gets one line back, starting with "ok", "err" or "status". The replies are only sent between telemetry
+//frames (see Telemetry.h), so both can be used at the same time
+#define REMOTE_BAUD 115200   //same as monitor_speed
+#define REMOTE_LINE_SIZE 32    //longest command + '\0', longer lines are answered with an error
+#define REMOTE_REPLY_SIZE 62   //with the newline, fits in Serial's empty transmit buffer (63 bytes), so a reply is handed over in one go
+#define REMOTE_MAX_ARGUMENTS 2
+
+enum class RemoteCommandType : unsigned char {
+    none,
+    start,
+    stop,
+    pause,
+    resume,
+    seek,
+    zone,
+    servo,
+    status,
+    profile,
+    flight,
+    memory
+};
+
+struct RemoteCommand {
+    RemoteCommandType type;
+    unsigned char argumentCount;
+    long arguments[REMOTE_MAX_ARGUMENTS];
+};
+
+class RemoteControl {
+public:
+    void init();
+    bool update(RemoteCommand* pCommand);
+    void beginReply(const __FlashStringHelper* text);
+    void addText(const __FlashStringHelper* text);
+    void addNumber(long value);
+
+private:
+    bool parseLine(RemoteCommand* pCommand);
+    void sendReply();
+    char _line[REMOTE_LINE_SIZE];
+    unsigned char _lineLength;
+    bool _isLineTooLong;
+    char _reply[REMOTE_REPLY_SIZE];
+    unsigned char _replyLength;
+    bool _isReplyPending;
+};
+
+#endif
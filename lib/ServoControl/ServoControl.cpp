@@ -1,108 +1,138 @@
-
-#include <Servo.h>
-#include <EEPROM.h>  
-#include "ServoControl.h"
-#include "Common.h"  
-
-Servo servo; 
-
-/*****************************************************************************/
-/**
- * @brief   Initializes the servo and the servo position variable. The servo
- *          should be moved to the top potion.     
- */
-/*****************************************************************************/
-void ServoControl::init() {
-    servo.attach(SIGNAL_PIN);
-    reconfig();  
-    moveBottomPosition();  
-}
-
-/*****************************************************************************/
-/**
- * @brief   Similar to init(), but only reconfigures variables and/or states 
- *          that need to be. This function can be used any time after the 
- *          program has been initialized with the init() function. This
- *          function is intended to be used when retarting the program 
- *          without power-cycling.
- * @note    This function should be called once before the servo motor is
- *          moved.      
- */
-/*****************************************************************************/
-void ServoControl::reconfig() {
-    _servoBottomPosition = EEPROM.read(SERVO_BOTTOM_POSITION_EEPROM_ADDRESS);
-    _servoTopPosition = _servoBottomPosition - DISTANCE_BETWEEN_TOP_AND_BOTTOM_POSITIONS;   //note that top position should have a value that is lower than bottom position
-
-    if(_servoBottomPosition > SERVO_BOTTOM_LIMIT || _servoTopPosition < SERVO_TOP_LIMIT) {   //this is the safe motion range (avoid servo motor stall) 
-        _servoBottomPosition = DEFAULT_SERVO_BOTTOM_POSITION;   //this value may not be perfect, but it puts the servo motor in the general position so the servo doesn't hit motion limits and stall 
-        _servoTopPosition = _servoBottomPosition - DISTANCE_BETWEEN_TOP_AND_BOTTOM_POSITIONS; 
-        EEPROM.update(SERVO_BOTTOM_POSITION_EEPROM_ADDRESS, DEFAULT_SERVO_BOTTOM_POSITION); 
-    }
-}
-
-/*****************************************************************************/
-/**
- * @brief   Moves the servo motor to the top position. Keeps track of the
- *          servo position. 
- */
-/*****************************************************************************/
-void ServoControl::moveTopPosition() {
-    _currentServoPosition = _servoTopPosition;     
-    servo.write(_servoTopPosition);
-}
-
-/*****************************************************************************/
-/**
- * @brief   Moves the servo motor to the bottom position. 
- */
-/*****************************************************************************/
-void ServoControl::moveBottomPosition() {
-    _currentServoPosition = _servoBottomPosition;     
-    servo.write(_servoBottomPosition); 
-}
-
-/*****************************************************************************/
-/**
- * @brief   Moves the servo motor up by one increment. Keeps track of the
- *          servo position. 
- * @note    This function should be called after moveTopPosition or 
- *          moveBottomPosition because _currentServoPosition might not
- *          be in sync with the actual servo position. This function is 
- *          intended to be used for calibrating the servo motor.        
- */
-/*****************************************************************************/
-void ServoControl::moveUpOneIncrement() {
-    _currentServoPosition -= SERVO_INCREMENT_DISTANCE;   //note that moving up means _currentServoPosition will decrease in value
-    if(_currentServoPosition <= SERVO_TOP_LIMIT) {   //so that the servo motor doesn't move higher than the top limit 
-        _currentServoPosition = SERVO_TOP_LIMIT; 
-    }
-    servo.write(_currentServoPosition); 
-}
-
-/*****************************************************************************/
-/**
- * @brief   Moves the servo motor down by one increment. Keeps track of the 
- *          servo position. 
- * @note    This function should be called after moveTopPosition or 
- *          moveBottomPosition because _currentServoPosition might not
- *          be in sync with the actual servo position. This function is 
- *          intended to be used for calibrating the servo motor.     
- */
-/*****************************************************************************/
-void ServoControl::moveDownOneIncrement() {
-    _currentServoPosition += SERVO_INCREMENT_DISTANCE;   //note that moving down means _currentServoPosition will increase in value
-    if(_currentServoPosition >= SERVO_BOTTOM_LIMIT) {   //so that the servo motor doesn't move lower than the bottom limit 
-        _currentServoPosition = SERVO_BOTTOM_LIMIT; 
-    }
-    servo.write(_currentServoPosition);    
-}
-
-/*****************************************************************************/
-/**
- * @brief   Gets the current servo motor position.
- * @returns _currentServoPosition
- */
-/*****************************************************************************/
-unsigned char ServoControl::getCurrentPosition() {
-    return _currentServoPosition; 
-}
+
+#include <EEPROM.h>  
+#include "ServoControl.h"
+#include "Common.h"  
+
+/*****************************************************************************/
+/**
+ * @brief   Initializes the servo and the servo position variable. The servo
+ *          is held at the bottom position from the first pulse. This should
+ *          be called first thing in setup(), so the servo signal isn't 
+ *          floating for long. 
+ * @note    The first pulse is already at the bottom position, so the servo
+ *          doesn't move at boot if it's already there. 
+ * @param   signalPin   The servo signal pin of the channel (see 
+ *          ChannelPins.h). 
+ * @param   bottomPosition  The saved bottom position (from the EEPROM 
+ *          configuration that was loaded at boot, see StoredConfig.h). 
+ */
+/*****************************************************************************/
+void ServoControl::init(uint8_t signalPin, unsigned char bottomPosition) {
+    setBottomPosition(bottomPosition); 
+    _currentServoPosition = _servoBottomPosition; 
+    _servoPwm.attach(signalPin, servoAngleToPulseUs(_servoBottomPosition));
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Similar to init(), but only reconfigures variables and/or states 
+ *          that need to be. This function can be used any time after the 
+ *          program has been initialized with the init() function. This
+ *          function is intended to be used when retarting the program 
+ *          without power-cycling.
+ * @note    This function should be called once before the servo motor is
+ *          moved.      
+ */
+/*****************************************************************************/
+void ServoControl::reconfig() {
+    setBottomPosition(EEPROM.read(SERVO_BOTTOM_POSITION_EEPROM_ADDRESS));
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sets the bottom and top positions from the saved bottom position.
+ *          If it's outside of the safe motion range (or was never saved),
+ *          the default position is used and saved instead. 
+ * @param   bottomPosition  The saved bottom position. 
+ */
+/*****************************************************************************/
+void ServoControl::setBottomPosition(unsigned char bottomPosition) {
+    _servoBottomPosition = bottomPosition;
+    _servoTopPosition = _servoBottomPosition - DISTANCE_BETWEEN_TOP_AND_BOTTOM_POSITIONS;   //note that top position should have a value that is lower than bottom position
+
+    if(_servoBottomPosition > SERVO_BOTTOM_LIMIT || _servoTopPosition < SERVO_TOP_LIMIT) {   //this is the safe motion range (avoid servo motor stall) 
+        _servoBottomPosition = DEFAULT_SERVO_BOTTOM_POSITION;   //this value may not be perfect, but it puts the servo motor in the general position so the servo doesn't hit motion limits and stall 
+        _servoTopPosition = _servoBottomPosition - DISTANCE_BETWEEN_TOP_AND_BOTTOM_POSITIONS; 
+        EEPROM.update(SERVO_BOTTOM_POSITION_EEPROM_ADDRESS, DEFAULT_SERVO_BOTTOM_POSITION); 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Moves the servo motor to the top position. Keeps track of the
+ *          servo position. 
+ */
+/*****************************************************************************/
+void ServoControl::moveTopPosition() {
+    _currentServoPosition = _servoTopPosition;     
+    _servoPwm.moveTo(servoAngleToPulseUs(_servoTopPosition));
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Moves the servo motor to the bottom position. 
+ */
+/*****************************************************************************/
+void ServoControl::moveBottomPosition() {
+    _currentServoPosition = _servoBottomPosition;     
+    _servoPwm.moveTo(servoAngleToPulseUs(_servoBottomPosition)); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Moves the servo motor up by one increment. Keeps track of the
+ *          servo position. 
+ * @note    This function should be called after moveTopPosition or 
+ *          moveBottomPosition because _currentServoPosition might not
+ *          be in sync with the actual servo position. This function is 
+ *          intended to be used for calibrating the servo motor.        
+ */
+/*****************************************************************************/
+void ServoControl::moveUpOneIncrement() {
+    _currentServoPosition -= SERVO_INCREMENT_DISTANCE;   //note that moving up means _currentServoPosition will decrease in value
+    if(_currentServoPosition <= SERVO_TOP_LIMIT) {   //so that the servo motor doesn't move higher than the top limit 
+        _currentServoPosition = SERVO_TOP_LIMIT; 
+    }
+    _servoPwm.moveTo(servoAngleToPulseUs(_currentServoPosition)); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Moves the servo motor down by one increment. Keeps track of the 
+ *          servo position. 
+ * @note    This function should be called after moveTopPosition or 
+ *          moveBottomPosition because _currentServoPosition might not
+ *          be in sync with the actual servo position. This function is 
+ *          intended to be used for calibrating the servo motor.     
+ */
+/*****************************************************************************/
+void ServoControl::moveDownOneIncrement() {
+    _currentServoPosition += SERVO_INCREMENT_DISTANCE;   //note that moving down means _currentServoPosition will increase in value
+    if(_currentServoPosition >= SERVO_BOTTOM_LIMIT) {   //so that the servo motor doesn't move lower than the bottom limit 
+        _currentServoPosition = SERVO_BOTTOM_LIMIT; 
+    }
+    _servoPwm.moveTo(servoAngleToPulseUs(_currentServoPosition));    
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if the servo horn has (most likely) arrived at the last 
+ *          position it was moved to and stopped. This is an estimate from
+ *          the commanded motion and the servo's speed (see ServoPwm.h), 
+ *          the servo doesn't report its position. 
+ * @returns Returns true once the horn has arrived. 
+ */
+/*****************************************************************************/
+bool ServoControl::hasArrived() {
+    return _servoPwm.hasArrived(); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the current servo motor position.
+ * @returns _currentServoPosition
+ */
+/*****************************************************************************/
+unsigned char ServoControl::getCurrentPosition() {
+    return _currentServoPosition; 
+}
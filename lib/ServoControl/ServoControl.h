@@ -1,30 +1,39 @@
-
-#ifndef SERVO_CONTROL_H
-#define SERVO_CONTROL_H
- 
-#define DISTANCE_BETWEEN_TOP_AND_BOTTOM_POSITIONS 40  
-#define SERVO_INCREMENT_DISTANCE 20  
-#define SERVO_BOTTOM_LIMIT 160  
-#define SERVO_TOP_LIMIT 80   
-#define DEFAULT_SERVO_BOTTOM_POSITION 140 
-
-#define SIGNAL_PIN 41   
-
-class ServoControl {
-public:
-    void init(); 
-    void reconfig(); 
-    void moveTopPosition(); 
-    void moveBottomPosition(); 
-    void moveUpOneIncrement();
-    void moveDownOneIncrement(); 
-    unsigned char getCurrentPosition(); 
-
-private:
-    unsigned char _currentServoPosition; 
-    unsigned char _servoBottomPosition;   //during early testing, bottom position was 140
-    unsigned char _servoTopPosition;      //during early testing, top position was 100
-};
-extern ServoControl servoControl; 
-
-#endif
+
+#ifndef SERVO_CONTROL_H
+#define SERVO_CONTROL_H
+
+#include "ServoPwm.h"
+ 
+#define DISTANCE_BETWEEN_TOP_AND_BOTTOM_POSITIONS 40  
+#define SERVO_INCREMENT_DISTANCE 20  
+#define SERVO_BOTTOM_LIMIT 160  
+#define SERVO_TOP_LIMIT 80   
+#define DEFAULT_SERVO_BOTTOM_POSITION 140 
+
+#ifdef ARDUINO_MEGA_ENV
+  #define SIGNAL_PIN 53   //channel 0 (see ChannelPins.h), PB0, port G (pin 41) has an LCD data line on the Mega's shield
+#else
+  #define SIGNAL_PIN 41   //channel 0 (see ChannelPins.h)
+#endif
+
+class ServoControl {
+public:
+    void init(uint8_t signalPin, unsigned char bottomPosition); 
+    void reconfig(); 
+    void moveTopPosition(); 
+    void moveBottomPosition(); 
+    void moveUpOneIncrement();
+    void moveDownOneIncrement(); 
+    unsigned char getCurrentPosition(); 
+    bool hasArrived(); 
+
+private:
+    void setBottomPosition(unsigned char bottomPosition); 
+    unsigned char _currentServoPosition; 
+    unsigned char _servoBottomPosition;   //during early testing, bottom position was 140
+    unsigned char _servoTopPosition;      //during early testing, top position was 100
+    ServoPwm _servoPwm; 
+};
+extern ServoControl& servoControl;   //channel 0, which is the one that the setup pages calibrate
+
+#endif
@@ -0,0 +1,245 @@
+
+#include <Arduino.h>
+#include <util/atomic.h>
+#include "ServoPwm.h"
+
+ServoPwm* servoPwmChannels[MAX_SERVO_CHANNELS];   //the servos that the Timer5 interrupts drive, in pulse order
+volatile uint8_t numberOfServoPwmChannels = 0; 
+volatile uint8_t pulsingServoPwmChannel = 0;   //the servo whose pulse ends at the next compare B
+
+/*****************************************************************************/
+/**
+ * @brief   Starts sending the servo signal on a pin, at a fixed pulse width.
+ *          Timer5 is used for the timing, the pin is toggled from its
+ *          compare interrupts (so it can be any digital pin). Timer5 is 
+ *          started when the first servo is attached, the other servos are
+ *          added to the same period. 
+ * @note    Timer5 can't be used by anything else (the Servo library used it
+ *          as well). Up to MAX_SERVO_CHANNELS servos are supported, more are
+ *          ignored.
+ * @param   pin The signal pin.
+ * @param   pulseUs The first pulse width (microseconds), the servo is held
+ *          there until moveTo() is called.
+ */
+/*****************************************************************************/
+void ServoPwm::attach(uint8_t pin, uint16_t pulseUs) {
+    _signalPort = portOutputRegister(digitalPinToPort(pin));
+    _signalMask = digitalPinToBitMask(pin);
+    digitalWrite(pin, LOW);
+    pinMode(pin, OUTPUT);
+
+    setProfile(SERVO_PROFILE_MAX_SPEED_US, SERVO_PROFILE_ACCELERATION_US);
+    pulseUs = constrain(pulseUs, (uint16_t)SERVO_MIN_PULSE_US, (uint16_t)SERVO_MAX_PULSE_US);
+    _targetUs = pulseUs;
+    _commandedUs = pulseUs;
+    _hornUs = pulseUs;   //unknown at power-up, the first move from here will be estimated from this position
+    _speedUs = 0;
+    _settledPeriods = SERVO_SETTLE_PERIODS;
+
+    if(numberOfServoPwmChannels == MAX_SERVO_CHANNELS) {
+        return; 
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        servoPwmChannels[numberOfServoPwmChannels] = this; 
+        numberOfServoPwmChannels++; 
+        if(numberOfServoPwmChannels == 1) {
+            TCCR5A = 0;
+            TCCR5B = _BV(WGM52) | _BV(CS51);   //CTC (top = OCR5A), clk/8
+            OCR5A = (uint16_t)SERVO_PERIOD_US * SERVO_TICKS_PER_US - 1;
+            OCR5B = 0xFFFF;   //above top, so compare B can't match until the first compare A sets it
+            TCNT5 = OCR5A - 1;   //the first period starts right away
+            TIFR5 = _BV(OCF5A) | _BV(OCF5B);   //clears old flags
+            TIMSK5 = _BV(OCIE5A) | _BV(OCIE5B);
+        }
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sets the velocity profile used by the next moves.
+ * @param   maxSpeedUs  The largest change of the pulse width per period
+ *          (microseconds per 20 ms).
+ * @param   accelerationUs  How much the speed changes per period when
+ *          speeding up and slowing down.
+ */
+/*****************************************************************************/
+void ServoPwm::setProfile(uint16_t maxSpeedUs, uint16_t accelerationUs) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        _maxSpeedUs = (maxSpeedUs > 0) ? maxSpeedUs : 1;
+        _accelerationUs = (accelerationUs > 0) ? accelerationUs : 1;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Moves the servo to a pulse width. The pulse width speeds up,
+ *          moves at the profile's maximum speed, and slows down before the
+ *          target, one step per period.
+ * @param   pulseUs The target pulse width (microseconds).
+ */
+/*****************************************************************************/
+void ServoPwm::moveTo(uint16_t pulseUs) {
+    pulseUs = constrain(pulseUs, (uint16_t)SERVO_MIN_PULSE_US, (uint16_t)SERVO_MAX_PULSE_US);
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        bool isReversing = (_targetUs > _commandedUs) != (pulseUs > _commandedUs);
+        if(isReversing) {
+            _speedUs = 0;
+        }
+        _targetUs = pulseUs;
+        if(_commandedUs != pulseUs || _hornUs != pulseUs) {
+            _settledPeriods = 0;
+        }
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the pulse width that the servo is moving to.
+ * @returns Returns the target pulse width (microseconds).
+ */
+/*****************************************************************************/
+uint16_t ServoPwm::getTargetUs() {
+    uint16_t targetUs;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        targetUs = _targetUs;
+    }
+    return targetUs;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if the horn is estimated to have physically arrived at the
+ *          target and stopped. The estimate follows the commanded pulse
+ *          width at SERVO_HORN_SPEED_US per period, then waits
+ *          SERVO_SETTLE_PERIODS.
+ * @returns Returns true once the horn has arrived.
+ */
+/*****************************************************************************/
+bool ServoPwm::hasArrived() {
+    return _settledPeriods >= SERVO_SETTLE_PERIODS;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Moves the commanded pulse width and the horn estimate by one 
+ *          period. Called from the Timer5 compare A interrupt, every 
+ *          SERVO_PERIOD_US. 
+ */
+/*****************************************************************************/
+void ServoPwm::handlePeriodStart() {
+    updateProfile();
+    updateHornEstimate();
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Starts a pulse. Called from the Timer5 interrupts, when it's this
+ *          servo's turn. 
+ * @returns Returns the pulse width (timer ticks). 
+ */
+/*****************************************************************************/
+uint16_t ServoPwm::startPulse() {
+    *_signalPort |= _signalMask;
+    return _commandedUs * SERVO_TICKS_PER_US; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Ends the pulse. Called from the Timer5 compare B interrupt.
+ */
+/*****************************************************************************/
+void ServoPwm::endPulse() {
+    *_signalPort &= ~_signalMask;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Moves the commanded pulse width one period toward the target,
+ *          following the velocity profile (trapezoid, or triangle for short
+ *          moves).
+ */
+/*****************************************************************************/
+void ServoPwm::updateProfile() {
+    if(_commandedUs == _targetUs) {
+        _speedUs = 0;
+        return;
+    }
+    uint16_t remainingUs = (_targetUs > _commandedUs) ? _targetUs - _commandedUs : _commandedUs - _targetUs;
+    //slows down once the remaining distance is within the braking distance, speed*(speed + acceleration)/(2*acceleration) (compared without dividing, this runs in the interrupt)
+    if((uint32_t)remainingUs * 2 * _accelerationUs <= (uint32_t)_speedUs * (_speedUs + _accelerationUs)) {
+        _speedUs = (_speedUs > _accelerationUs) ? _speedUs - _accelerationUs : _accelerationUs;
+    }
+    else if(_speedUs < _maxSpeedUs) {
+        _speedUs = min((uint16_t)(_speedUs + _accelerationUs), _maxSpeedUs);
+    }
+    uint16_t stepUs = min(_speedUs, remainingUs);
+    _commandedUs = (_targetUs > _commandedUs) ? _commandedUs + stepUs : _commandedUs - stepUs;
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Moves the estimated horn position one period toward the
+ *          commanded pulse width, and counts the periods since it got to
+ *          the target.
+ */
+/*****************************************************************************/
+void ServoPwm::updateHornEstimate() {
+    if(_hornUs + SERVO_HORN_SPEED_US < _commandedUs) {
+        _hornUs += SERVO_HORN_SPEED_US;
+    }
+    else if(_hornUs > _commandedUs + SERVO_HORN_SPEED_US) {
+        _hornUs -= SERVO_HORN_SPEED_US;
+    }
+    else {
+        _hornUs = _commandedUs;
+    }
+
+    if(_hornUs == _targetUs && _commandedUs == _targetUs) {
+        if(_settledPeriods < SERVO_SETTLE_PERIODS) {
+            _settledPeriods++;
+        }
+    }
+    else {
+        _settledPeriods = 0;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Converts a servo angle to a pulse width, the same way as the
+ *          Servo library's write(), so the saved positions don't change.
+ * @param   angle   The angle (0 to 180 degrees).
+ * @returns Returns the pulse width (microseconds).
+ */
+/*****************************************************************************/
+uint16_t servoAngleToPulseUs(unsigned char angle) {
+    if(angle > 180) {
+        angle = 180;
+    }
+    return map(angle, 0, 180, SERVO_MIN_PULSE_US, SERVO_MAX_PULSE_US);
+}
+
+//a period starts: the first servo's pulse starts, then every servo's profile is moved by one period
+ISR(TIMER5_COMPA_vect) {
+    uint16_t firstPulseTicks = servoPwmChannels[0]->startPulse();   //started before the updates, so they don't shorten it
+    uint8_t count = numberOfServoPwmChannels; 
+    for(uint8_t i = 0; i < count; i++) {
+        servoPwmChannels[i]->handlePeriodStart(); 
+    }
+    pulsingServoPwmChannel = 0; 
+    OCR5B = firstPulseTicks;   //the timer has just restarted at 0, compare B is at least SERVO_MIN_PULSE_US away
+}
+
+//a pulse ends, and the next servo's pulse starts right away
+ISR(TIMER5_COMPB_vect) {
+    uint8_t channel = pulsingServoPwmChannel; 
+    if(channel >= numberOfServoPwmChannels) {
+        return;   //all the pulses of this period are done
+    }
+    servoPwmChannels[channel]->endPulse(); 
+    channel++; 
+    pulsingServoPwmChannel = channel; 
+    if(channel < numberOfServoPwmChannels) {
+        OCR5B += servoPwmChannels[channel]->startPulse(); 
+    }
+}
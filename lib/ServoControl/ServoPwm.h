@@ -0,0 +1,50 @@
+
+#ifndef SERVO_PWM_H
+#define SERVO_PWM_H
+
+#include <Arduino.h>
+
+//Timer5 runs at clk/8 in CTC mode: a period starts at compare A, and the servos' pulses follow each other, each one ending
+//(and the next one starting) at compare B. This is how the Servo library shares one timer between several servos
+#define SERVO_TICKS_PER_US 2   //16 MHz / 8
+#define SERVO_PERIOD_US 20000   //50 Hz, same as the Servo library
+#define SERVO_MIN_PULSE_US 544    //0 degrees, same as the Servo library
+#define SERVO_MAX_PULSE_US 2400   //180 degrees, same as the Servo library
+#define MAX_SERVO_CHANNELS (SERVO_PERIOD_US / SERVO_MAX_PULSE_US)   //8, so the longest pulses still fit in one period
+
+//default velocity profile, in pulse width (us) per period (20 ms). One degree is about 10 us
+#define SERVO_PROFILE_MAX_SPEED_US 100   //about 500 degrees/s
+#define SERVO_PROFILE_ACCELERATION_US 25   //full speed is reached after 4 periods (80 ms)
+
+//used to estimate when the horn has arrived, which is later than the commanded pulse width (the servo can't follow a jump)
+#define SERVO_HORN_SPEED_US 60   //how far the horn is assumed to move per period at most (about 0.2 s per 60 degrees, a hobby servo under load)
+#define SERVO_SETTLE_PERIODS 3   //periods after the estimated horn position reaches the target, before the horn is assumed to be still (60 ms)
+
+class ServoPwm {
+public:
+    void attach(uint8_t pin, uint16_t pulseUs);
+    void setProfile(uint16_t maxSpeedUs, uint16_t accelerationUs);
+    void moveTo(uint16_t pulseUs);
+    uint16_t getTargetUs();
+    bool hasArrived();
+    void handlePeriodStart();
+    uint16_t startPulse();
+    void endPulse();
+
+private:
+    void updateProfile();
+    void updateHornEstimate();
+    volatile uint8_t* _signalPort;
+    uint8_t _signalMask;
+    uint16_t _maxSpeedUs;
+    uint16_t _accelerationUs;
+    volatile uint16_t _targetUs;
+    volatile uint16_t _commandedUs;   //the pulse width that is being sent, which moves toward the target following the profile
+    volatile uint16_t _speedUs;   //how much the commanded pulse width changes in the current period
+    volatile uint16_t _hornUs;   //estimated position of the horn (as a pulse width)
+    volatile uint8_t _settledPeriods;
+};
+
+uint16_t servoAngleToPulseUs(unsigned char angle);
+
+#endif
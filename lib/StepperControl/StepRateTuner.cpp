@@ -0,0 +1,179 @@
+
+#include <Arduino.h>
+#include "StepRateTuner.h"
+
+//step periods that are tried, slowest first (500 to 2500 steps/s)
+const unsigned int trialPeriodsUs[NUMBER_OF_STEP_RATE_TRIALS] PROGMEM = {2000, 1500, 1200, 1000, 800, 600, 500, 400}; 
+
+/*****************************************************************************/
+/**
+ * @brief   Starts over with the slowest trial. The dial should be at zero, 
+ *          unless the index position has been measured (then the dial is 
+ *          homed first). 
+ * @note    The step period of the stepper is changed for each trial, it's 
+ *          set to the tuned period in main.cpp once all the trials are done. 
+ */ 
+/*****************************************************************************/
+void StepRateTuner::start() {
+    _trialIndex = 0; 
+    _phase = StepRateTrialPhase::clockwise; 
+    _passedPeriodUs = 0; 
+#ifdef INDEX_SENSOR
+    _isVerifiedByIndex = stepperControl.hasIndexStep(); 
+    if(_isVerifiedByIndex) {
+        _phase = StepRateTrialPhase::homing; 
+    }
+#endif
+    setTrialPeriod(); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Runs the current trial: STEP_RATE_TEST_TURNS turns clockwise,
+ *          then the same number counterclockwise, at the trial's step
+ *          period. With the index sensor, the dial is then turned clockwise
+ *          to the index, and the trial passes if the index is where it was
+ *          measured (see isTrialPassed()). This function is designed to be 
+ *          synchronous (see StepperControl.cpp), each call moves the 
+ *          stepper one step. 
+ * @returns Returns StepperState::incomplete until the dial is back at its 
+ *          starting position (or at the index), then ::complete. 
+ */ 
+/*****************************************************************************/
+StepperState StepRateTuner::runTrial() {
+    switch(_phase) {
+#ifdef INDEX_SENSOR
+        case StepRateTrialPhase::homing: 
+            if(stepperControl.homeToIndex() != StepperState::incomplete) {
+                _phase = StepRateTrialPhase::clockwise; 
+            }
+            break; 
+        case StepRateTrialPhase::verifying: {
+            StepperState state = stepperControl.homeToIndex(); 
+            if(state == StepperState::incomplete) {
+                break; 
+            }
+            _isTrialPassed = (state == StepperState::complete && abs(stepperControl.getIndexDrift()) <= STEP_RATE_INDEX_TOLERANCE_STEPS); 
+            _phase = StepRateTrialPhase::clockwise;   //homing also zeroed the position for the next trial
+            return StepperState::complete; 
+        }
+#endif
+        case StepRateTrialPhase::clockwise: 
+            if(stepperControl.rotateSteps(StepperDirection::clockwise, STEP_RATE_TEST_TURNS*NUMBER_OF_STEPS) == StepperState::complete) {
+                _phase = StepRateTrialPhase::counterclockwise; 
+            }
+            break; 
+        case StepRateTrialPhase::counterclockwise: 
+            if(stepperControl.rotateSteps(StepperDirection::counterclockwise, STEP_RATE_TEST_TURNS*NUMBER_OF_STEPS) == StepperState::complete) {
+                _phase = StepRateTrialPhase::clockwise; 
+#ifdef INDEX_SENSOR
+                if(_isVerifiedByIndex) {
+                    _phase = StepRateTrialPhase::verifying; 
+                    break; 
+                }
+#endif
+                return StepperState::complete; 
+            }
+            break; 
+        default: 
+            break; 
+    }
+    return StepperState::incomplete; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Records whether the dial was still at zero after the current 
+ *          trial, and moves on to the next (faster) trial if it was. 
+ * @param   isDialAtZero    True if the user confirmed that no steps were 
+ *          lost (or isTrialPassed() with the index sensor). 
+ * @returns Returns true if there's another trial to run, or false if the 
+ *          tuning is done. 
+ */ 
+/*****************************************************************************/
+bool StepRateTuner::recordResult(bool isDialAtZero) {
+    if(!isDialAtZero) {
+        return false; 
+    }
+    _passedPeriodUs = pgm_read_word(&trialPeriodsUs[_trialIndex]); 
+    _trialIndex++; 
+    if(_trialIndex == NUMBER_OF_STEP_RATE_TRIALS) {
+        return false; 
+    }
+    setTrialPeriod(); 
+    return true; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sets the stepper to the current trial's period. The acceleration
+ *          ramp is the one of the period that would be saved if the trial 
+ *          passed (STEP_RATE_MARGIN_PERCENT longer), so the trial speeds up 
+ *          like a run would, then keeps speeding up to the trial's period. 
+ */ 
+/*****************************************************************************/
+void StepRateTuner::setTrialPeriod() {
+    unsigned int periodUs = pgm_read_word(&trialPeriodsUs[_trialIndex]); 
+    stepperControl.setStepPeriod(periodUs); 
+    stepperControl.setRampPeriod((unsigned long)periodUs*(100 + STEP_RATE_MARGIN_PERCENT)/100); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the step rate of the current trial (to be displayed). 
+ * @returns Returns the rate (steps per second). 
+ */ 
+/*****************************************************************************/
+unsigned int StepRateTuner::getTrialStepsPerSecond() {
+    return 1000000UL / pgm_read_word(&trialPeriodsUs[_trialIndex]); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the period to be saved: the shortest period that passed, 
+ *          made STEP_RATE_MARGIN_PERCENT longer. 
+ * @returns Returns the period (microseconds), or DEFAULT_STEP_PERIOD_US if 
+ *          no trial passed. 
+ */ 
+/*****************************************************************************/
+unsigned int StepRateTuner::getTunedPeriod() {
+    if(!isTuned()) {
+        return DEFAULT_STEP_PERIOD_US; 
+    }
+    return (unsigned long)_passedPeriodUs*(100 + STEP_RATE_MARGIN_PERCENT)/100; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if at least one trial passed. 
+ * @returns Returns true if a tuned period is available. 
+ */ 
+/*****************************************************************************/
+bool StepRateTuner::isTuned() {
+    return _passedPeriodUs != 0; 
+}
+
+#ifdef INDEX_SENSOR
+/*****************************************************************************/
+/**
+ * @brief   Checks if the trials are checked with the index sensor, instead 
+ *          of asking the user (step rate page 3). 
+ * @returns Returns true if the index position has been measured. 
+ */ 
+/*****************************************************************************/
+bool StepRateTuner::isVerifiedByIndex() {
+    return _isVerifiedByIndex; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks the result of the trial that runTrial() just completed, 
+ *          when isVerifiedByIndex(). 
+ * @returns Returns true if the index was found within 
+ *          STEP_RATE_INDEX_TOLERANCE_STEPS of where it was measured. 
+ */ 
+/*****************************************************************************/
+bool StepRateTuner::isTrialPassed() {
+    return _isTrialPassed; 
+}
+#endif
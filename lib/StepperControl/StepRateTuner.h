@@ -0,0 +1,45 @@
+
+#ifndef STEP_RATE_TUNER_H
+#define STEP_RATE_TUNER_H
+
+#include "StepperControl.h"
+
+#define STEP_RATE_TEST_TURNS 3   //full turns in each direction per trial, the dial ends where it started
+#define STEP_RATE_MARGIN_PERCENT 25   //the saved period is this much longer than the shortest one that passed
+#define NUMBER_OF_STEP_RATE_TRIALS 8
+#ifdef INDEX_SENSOR
+  #define STEP_RATE_INDEX_TOLERANCE_STEPS 1   //a trial passes if the index is found within this many steps of where it was measured
+#endif
+
+//without an index sensor, there's nothing that can tell where the dial is, so after each trial the user checks that the 
+//dial is still at zero (a lost step moves it by more than a third of a mark, 200 steps for 60 marks). With -D INDEX_SENSOR
+//(and a measured index position), the dial is homed before the first trial, and each trial ends by turning clockwise to 
+//the index, where the drift shows if any steps were lost. The trials get faster, but each one accelerates like a run at
+//the period that would be saved if it passed, so the margin is only on the speed.
+enum class StepRateTrialPhase { homing, clockwise, counterclockwise, verifying }; 
+
+class StepRateTuner {
+public:
+    void start(); 
+    StepperState runTrial(); 
+    bool recordResult(bool isDialAtZero); 
+    unsigned int getTrialStepsPerSecond(); 
+    unsigned int getTunedPeriod(); 
+    bool isTuned(); 
+#ifdef INDEX_SENSOR
+    bool isVerifiedByIndex(); 
+    bool isTrialPassed(); 
+#endif
+
+private:
+    void setTrialPeriod(); 
+    unsigned char _trialIndex; 
+    StepRateTrialPhase _phase; 
+    unsigned int _passedPeriodUs;   //the shortest period that passed, 0 if none did
+#ifdef INDEX_SENSOR
+    bool _isVerifiedByIndex;   //false if the index position hasn't been measured (the user checks the dial)
+    bool _isTrialPassed; 
+#endif
+};
+
+#endif
@@ -1,278 +1,784 @@
-
-#include <Arduino.h>  
-#include "StepperControl.h"
-#include "Common.h" 
-
-/*****************************************************************************/
-/**
- * @brief   Initializations are done here. This function should only be called
- *          once when the microcontroller boots (call in setup).
- */ 
-/*****************************************************************************/
-void StepperControl::init() {
-    //Easy Driver pins
-    pinMode(STEP_PIN, OUTPUT);
-    pinMode(DIR_PIN, OUTPUT);
-    pinMode(MS1_PIN, OUTPUT);
-    pinMode(MS2_PIN, OUTPUT);
-    pinMode(EN_PIN, OUTPUT); 
-    disableStepperMotor(); 
-    reconfig(); 
-}
-
-/*****************************************************************************/
-/**
- * @brief   Similar to init(), but only reconfigures variables and/or states 
- *          that need to be. This function can be used any time after the 
- *          program has been initialized with the init() function. This
- *          function is intended to be used when retarting the program 
- *          without power-cycling.  
- */
-/*****************************************************************************/
-void StepperControl::reconfig() {
-    //Reset Easy Driver pins to default states
-    digitalWrite(STEP_PIN, LOW);
-    digitalWrite(DIR_PIN, HIGH); //clockwise
-    digitalWrite(MS1_PIN, LOW);
-    digitalWrite(MS2_PIN, LOW);
-
-    _currentStepperCommand = StepperCommand::none;  
-    _previousStepperCommand = StepperCommand::none; 
-    _targetStepCount = 0; 
-    _stepCounter = 0;    
-    _currentStep = 0;   
-}
-
-/*****************************************************************************/
-/**
- * @brief   Rotates clockwise until it gets to the first position. This
- *          function is designed to be synchronous, meaning that it is
- *          non-blocking and will be called many times before the stepper
- *          motor gets to the first position. Each time this function is 
- *          called, the stepper should move one step until it gets to the 
- *          target position. 
- * @note    Uses rotateOneStep() function.    
- * @param   targetFirstPosition    This is the target position. 
- * @returns Returns StepperState::incomplete or ::complete depending on 
- *          if the stepper motor has reached the target position. If 
- *          there is already another stepper motor command being
- *          executed synchronously, this function will return
- *          ::commandConflict
- */ 
-/*****************************************************************************/
-StepperState StepperControl::goToFirstPosition(char targetFirstPosition) {
-    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::goToFirstPosition) {
-        //converts dial position to step number (decimal numbers are truncated)
-        unsigned int firstPositionStepNumber = map(targetFirstPosition, 0, NUMBER_OF_POSITIONS, 0, NUMBER_OF_STEPS);
-        _previousStepperCommand = StepperCommand::goToFirstPosition;
-        if(abs(firstPositionStepNumber - _currentStep) > 0) {   
-            rotateOneStep(StepperDirection::clockwise);    
-            _currentStepperCommand = StepperCommand::goToFirstPosition; 
-            return StepperState::incomplete; 
-        }
-        else {
-            _currentStepperCommand = StepperCommand::none; 
-            return StepperState::complete; 
-        }         
-    }
-    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
-}
-
-/*****************************************************************************/
-/**
- * @brief   Rotates counterclockwise until it gets to the second position. 
- *          This function is designed to be synchronous, meaning that it is
- *          non-blocking and will be called many times before the stepper
- *          motor gets to the second position. Each time this function is 
- *          called, the stepper should move one step until it gets to the 
- *          target position.  
- * @note    Uses rotateOneStep() function.
- * @note    rotateCounterclockwiseOnce() should be called before 
- *          goToSecondPosition() is called (this will be done in 
- *          the Algorithm.cpp file).  
- * @param   targetSecondPosition   This is the target position. 
- * @returns Returns StepperState::incomplete or ::complete depending on 
- *          if the stepper motor has reached the target position. If 
- *          there is already another stepper motor command being
- *          executed synchronously, this function will return
- *          ::commandConflict     
- */ 
-/*****************************************************************************/
-StepperState StepperControl::goToSecondPosition(char targetSecondPosition) {
-    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::goToSecondPosition) {
-        //converts dial position to step number (decimal numbers are truncated)
-        unsigned int secondPositionStepNumber = map(targetSecondPosition, 0, NUMBER_OF_POSITIONS, 0, NUMBER_OF_STEPS);
-        _previousStepperCommand = StepperCommand::goToSecondPosition;
-        if(abs(secondPositionStepNumber - _currentStep) > 0) {   
-            rotateOneStep(StepperDirection::counterclockwise);    
-            _currentStepperCommand = StepperCommand::goToSecondPosition; 
-            return StepperState::incomplete; 
-        }
-        else {
-            _currentStepperCommand = StepperCommand::none; 
-            return StepperState::complete; 
-        } 
-    }
-    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
-}
-
-/*****************************************************************************/
-/**
- * @brief   Rotates clockwise until it gets to the third position. 
- *          This function is designed to be synchronous, meaning that it is
- *          non-blocking and will be called many times before the stepper
- *          motor gets to the third position. Each time this function is 
- *          called, the stepper should move one step until it gets to the 
- *          target position. 
- * @note    Uses rotateOneStep() function.
- * @param   targetThirdPosition   This is the target position.  
- * @returns Returns StepperState::incomplete or ::complete depending on 
- *          if the stepper motor has reached the target position. If 
- *          there is already another stepper motor command being
- *          executed synchronously, this function will return
- *          ::commandConflict
- */ 
-/*****************************************************************************/
-StepperState StepperControl::goToThirdPosition(char targetThirdPosition) {
-    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::goToThirdPosition) {
-        //converts dial position to step number (decimal numbers are truncated)
-        unsigned int thirdPositionStepNumber = map(targetThirdPosition, 0, NUMBER_OF_POSITIONS, 0, NUMBER_OF_STEPS);
-        _previousStepperCommand = StepperCommand::goToThirdPosition;
-        if(abs(thirdPositionStepNumber - _currentStep) > 0) {   
-            rotateOneStep(StepperDirection::clockwise);    
-            _currentStepperCommand = StepperCommand::goToThirdPosition; 
-            return StepperState::incomplete; 
-        }
-        else {
-            _currentStepperCommand = StepperCommand::none; 
-            return StepperState::complete; 
-        } 
-    }
-    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
-}
-
-/*****************************************************************************/
-/**
- * @brief   Resets the lock by rotating clockwise two full rotations. 
- *          This function is designed to be synchronous, meaning that it is
- *          non-blocking and will be called many times before the target
- *          step count is reached. Each time this function is called, the 
- *          stepper should move one step until it gets to the target 
- *          position.   
- * @note    Uses rotateOneStep() function.
- * @returns Returns StepperState::incomplete or ::complete depending on 
- *          if the stepper motor has reached the target position. If 
- *          there is already another stepper motor command being
- *          executed synchronously, this function will return
- *          ::commandConflict
- */ 
-/*****************************************************************************/
-StepperState StepperControl::rotateClockwiseTwice() {
-    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::rotateClockwiseTwice) {   //only allows one command to be executed at a time
-        if(_previousStepperCommand != StepperCommand::rotateClockwiseTwice) {   //if it is the first time this function has been called since the beginning of this synchronous execution
-            _targetStepCount = 2*NUMBER_OF_STEPS;
-            _stepCounter = 0; 
-        }
-        rotateOneStep(StepperDirection::clockwise); 
-        _stepCounter++; 
-        _previousStepperCommand = StepperCommand::rotateClockwiseTwice;
-        if(_stepCounter < _targetStepCount) {
-            _currentStepperCommand = StepperCommand::rotateClockwiseTwice; 
-            return StepperState::incomplete;
-        } 
-        else if(_stepCounter == _targetStepCount) {
-            _currentStepperCommand = StepperCommand::none; 
-            return StepperState::complete;  
-        }            
-    }
-    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
-} 
-
-/*****************************************************************************/
-/**
- * @brief   Rotates counterclockwise one full rotation. This function is 
- *          designed to be synchronous, meaning that it is non-blocking and 
- *          will be called many times before the target step count is 
- *          reached. Each time this function is called, the stepper should 
- *          move one step until it gets to the target position. 
- * @note    Uses rotateOneStep() function.
- * @note    This function should be called before goToSecondPosition() is
- *          called (this will be done in the Algorithm.cpp file). 
- * @returns Returns StepperState::incomplete or ::complete depending on 
- *          if the stepper motor has reached the target position. If 
- *          there is already another stepper motor command being
- *          executed synchronously, this function will return
- *          ::commandConflict
- */ 
-/*****************************************************************************/
-StepperState StepperControl::rotateCounterclockwiseOnce() {
-    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::rotateCounterclockwiseOnce) {   //only allows one command to be executed at a time
-        if(_previousStepperCommand != StepperCommand::rotateCounterclockwiseOnce) {   //if it is the first time this function has been called since the beginning of this synchronous execution
-            _targetStepCount = NUMBER_OF_STEPS;
-            _stepCounter = 0; 
-        }
-        rotateOneStep(StepperDirection::counterclockwise); 
-        _stepCounter++; 
-        _previousStepperCommand = StepperCommand::rotateCounterclockwiseOnce;
-        if(_stepCounter < _targetStepCount) {
-            _currentStepperCommand = StepperCommand::rotateCounterclockwiseOnce; 
-            return StepperState::incomplete;
-        } 
-        else if(_stepCounter == _targetStepCount) {
-            _currentStepperCommand = StepperCommand::none; 
-            return StepperState::complete;  
-        }            
-    }
-    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
-}
-
-/*****************************************************************************/
-/**
- * @brief   Rotates the stepper motor one step in the requested direction. 
- * @note    A small delay may be required to get the motor to step properly. 
- * @param   direction   The direction that the motor should turn.
- *          Options: 
- *          StepperDirection::clockwise, StepperDirection::counterclockwise
- */ 
-/*****************************************************************************/
-void StepperControl::rotateOneStep(StepperDirection direction) {
-    if(direction == StepperDirection::clockwise) {
-        digitalWrite(DIR_PIN, HIGH);   //clockwise
-        _currentStep++; 
-        if(_currentStep == NUMBER_OF_STEPS) {
-            _currentStep = 0; 
-        }
-    }
-    else if(direction == StepperDirection::counterclockwise) {
-        digitalWrite(DIR_PIN, LOW);   //counterclockwise
-        _currentStep--; 
-        if(_currentStep < 0) {
-            _currentStep = NUMBER_OF_STEPS - 1; 
-        }
-    }
-    digitalWrite(STEP_PIN, HIGH);   //trigger one step
-    delay(1);   
-    digitalWrite(STEP_PIN, LOW);   //pull step pin low so it can be triggered again
-    delay(1);   
-} 
-
-/*****************************************************************************/
-/**
- * @brief   Enables the stepper motor so it can move and hold. 
- */ 
-/*****************************************************************************/
-void StepperControl::enableStepperMotor() {
-    digitalWrite(EN_PIN, LOW);  //enabled
-}
-
-/*****************************************************************************/
-/**
- * @brief   Disables the stepper motor, preventing it from moving or holding.
- *          When the stepper motor is disabled, the shaft can be rotated 
- *          freely. 
- */ 
-/*****************************************************************************/
-void StepperControl::disableStepperMotor() {
-    digitalWrite(EN_PIN, HIGH);  //disable
-}
-
+
+#include <Arduino.h>  
+#include <EEPROM.h>
+#include <util/atomic.h>
+#include "StepperControl.h"
+#include "ChannelPins.h"
+#include "Profiler.h"
+#include "FlightRecorder.h"
+#include "Common.h" 
+
+StepperControl* stepperChannels[MAX_NUMBER_OF_CHANNELS];   //the steppers that the Timer1 interrupt drives
+uint8_t numberOfStepperChannels = 0; 
+
+/*****************************************************************************/
+/**
+ * @brief   Initializations are done here. This function should only be called
+ *          once when the microcontroller boots (call in setup).
+ * @note    The driver is disabled first. The enable pin is set high before
+ *          it becomes an output, so it never drives low (enabled) on the 
+ *          way. 
+ * @param   channel The channel (see ChannelPins.h), which selects the pins.
+ */ 
+/*****************************************************************************/
+void StepperControl::init(unsigned char channel) {
+    _channel = channel; 
+    ChannelPins pins; 
+    getChannelPins(channel, &pins); 
+    _dirPin = pins.dir; 
+    _ms1Pin = pins.ms1; 
+    _ms2Pin = pins.ms2; 
+    _enPin = pins.en; 
+    _stepPort = portOutputRegister(digitalPinToPort(pins.step)); 
+    _stepMask = digitalPinToBitMask(pins.step); 
+
+    disableStepperMotor(); 
+    pinMode(_enPin, OUTPUT); 
+
+    //Easy Driver pins
+    pinMode(pins.step, OUTPUT);
+    pinMode(_dirPin, OUTPUT);
+    pinMode(_ms1Pin, OUTPUT);
+    pinMode(_ms2Pin, OUTPUT);
+
+    unsigned int periodUs = DEFAULT_STEP_PERIOD_US; 
+    if(EEPROM.read(STEP_PERIOD_EEPROM_ADDRESS) == STEP_PERIOD_MAGIC) {
+        EEPROM.get(STEP_PERIOD_EEPROM_ADDRESS + 1, periodUs);
+    }
+    setStepPeriod(periodUs); 
+
+#ifdef INDEX_SENSOR
+    _indexInputRegister = NULL; 
+    if(channel == 0) {
+        pinMode(INDEX_SENSOR_PIN, INPUT_PULLUP); 
+        _indexInputRegister = portInputRegister(digitalPinToPort(INDEX_SENSOR_PIN)); 
+        _indexMask = digitalPinToBitMask(INDEX_SENSOR_PIN); 
+    }
+    _hasIndexStep = (channel == 0 && EEPROM.read(INDEX_STEP_EEPROM_ADDRESS) == INDEX_STEP_MAGIC); 
+    _indexStep = EEPROM.read(INDEX_STEP_EEPROM_ADDRESS + 1); 
+    if(_indexStep >= NUMBER_OF_STEPS) {
+        _hasIndexStep = false; 
+    }
+    _correctedDriftSteps = 0; 
+#endif
+    reconfig(); 
+
+    if(numberOfStepperChannels < MAX_NUMBER_OF_CHANNELS) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            stepperChannels[numberOfStepperChannels] = this; 
+            numberOfStepperChannels++; 
+        }
+    }
+    if(numberOfStepperChannels == 1) {
+        TCCR1A = 0; 
+        TCCR1B = _BV(WGM12) | _BV(CS11);   //CTC (top = OCR1A), clk/8
+        OCR1A = STEP_TICK_US * STEP_TIMER_TICKS_PER_US - 1; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Similar to init(), but only reconfigures variables and/or states 
+ *          that need to be. This function can be used any time after the 
+ *          program has been initialized with the init() function. This
+ *          function is intended to be used when retarting the program 
+ *          without power-cycling.  
+ */
+/*****************************************************************************/
+void StepperControl::reconfig() {
+    //Reset Easy Driver pins to default states
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        *_stepPort &= ~_stepMask; 
+        _isStepPinHigh = false; 
+        _isStepPending = false;   //a step that wasn't sent before the program stopped
+        _ticksSinceStep = 0xFFFF;   //the next step starts the ramp
+    }
+    digitalWrite(_dirPin, HIGH); //clockwise
+    digitalWrite(_ms1Pin, LOW);
+    digitalWrite(_ms2Pin, LOW);
+
+    _currentStepperCommand = StepperCommand::none;  
+    _previousStepperCommand = StepperCommand::none; 
+    _targetStepCount = 0; 
+    _stepCounter = 0;    
+    _currentStep = 0;   
+    _previousDirection = StepperDirection::clockwise; 
+#ifdef INDEX_SENSOR
+    _wasAtIndex = isAtIndex();   //no edge if the flag is already in front of the sensor
+    _isAtIndexBeforeStep = _wasAtIndex; 
+    _isIndexEdge = false; 
+    _isResyncing = false; 
+    _resyncCounter = 0; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Rotates clockwise until it gets to the first position. This
+ *          function is designed to be synchronous, meaning that it is
+ *          non-blocking and will be called many times before the stepper
+ *          motor gets to the first position. Each time this function is 
+ *          called, the stepper should move one step until it gets to the 
+ *          target position. 
+ * @note    Uses rotateOneStep() function.    
+ * @param   targetFirstPosition    This is the target position. 
+ * @returns Returns StepperState::incomplete or ::complete depending on 
+ *          if the stepper motor has reached the target position. If 
+ *          there is already another stepper motor command being
+ *          executed synchronously, this function will return
+ *          ::commandConflict
+ */ 
+/*****************************************************************************/
+StepperState StepperControl::goToFirstPosition(char targetFirstPosition) {
+    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::goToFirstPosition) {
+        if(isStepPending()) {
+            return StepperState::incomplete;   //the previous step hasn't been sent yet
+        }
+        //converts dial position to step number (decimal numbers are truncated)
+        unsigned int firstPositionStepNumber = map(targetFirstPosition, 0, NUMBER_OF_POSITIONS, 0, NUMBER_OF_STEPS);
+        _previousStepperCommand = StepperCommand::goToFirstPosition;
+        if(abs(firstPositionStepNumber - _currentStep) > 0) {   
+            rotateOneStep(StepperDirection::clockwise);    
+            _currentStepperCommand = StepperCommand::goToFirstPosition; 
+            return StepperState::incomplete; 
+        }
+        else {
+            _currentStepperCommand = StepperCommand::none; 
+            flightRecorder.record(FlightEventSource::stepper, (unsigned char)StepperCommand::goToFirstPosition, _channel, _currentStep); 
+            return StepperState::complete; 
+        }         
+    }
+    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Rotates counterclockwise until it gets to the second position. 
+ *          This function is designed to be synchronous, meaning that it is
+ *          non-blocking and will be called many times before the stepper
+ *          motor gets to the second position. Each time this function is 
+ *          called, the stepper should move one step until it gets to the 
+ *          target position.  
+ * @note    Uses rotateOneStep() function.
+ * @note    rotateCounterclockwiseOnce() should be called before 
+ *          goToSecondPosition() is called (this will be done in 
+ *          the Algorithm.cpp file).  
+ * @param   targetSecondPosition   This is the target position. 
+ * @returns Returns StepperState::incomplete or ::complete depending on 
+ *          if the stepper motor has reached the target position. If 
+ *          there is already another stepper motor command being
+ *          executed synchronously, this function will return
+ *          ::commandConflict     
+ */ 
+/*****************************************************************************/
+StepperState StepperControl::goToSecondPosition(char targetSecondPosition) {
+    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::goToSecondPosition) {
+        if(isStepPending()) {
+            return StepperState::incomplete;   //the previous step hasn't been sent yet
+        }
+        //converts dial position to step number (decimal numbers are truncated)
+        unsigned int secondPositionStepNumber = map(targetSecondPosition, 0, NUMBER_OF_POSITIONS, 0, NUMBER_OF_STEPS);
+        _previousStepperCommand = StepperCommand::goToSecondPosition;
+        if(abs(secondPositionStepNumber - _currentStep) > 0) {   
+            rotateOneStep(StepperDirection::counterclockwise);    
+            _currentStepperCommand = StepperCommand::goToSecondPosition; 
+            return StepperState::incomplete; 
+        }
+        else {
+            _currentStepperCommand = StepperCommand::none; 
+            flightRecorder.record(FlightEventSource::stepper, (unsigned char)StepperCommand::goToSecondPosition, _channel, _currentStep); 
+            return StepperState::complete; 
+        } 
+    }
+    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Rotates clockwise until it gets to the third position. 
+ *          This function is designed to be synchronous, meaning that it is
+ *          non-blocking and will be called many times before the stepper
+ *          motor gets to the third position. Each time this function is 
+ *          called, the stepper should move one step until it gets to the 
+ *          target position. 
+ * @note    Uses rotateOneStep() function.
+ * @param   targetThirdPosition   This is the target position.  
+ * @returns Returns StepperState::incomplete or ::complete depending on 
+ *          if the stepper motor has reached the target position. If 
+ *          there is already another stepper motor command being
+ *          executed synchronously, this function will return
+ *          ::commandConflict
+ */ 
+/*****************************************************************************/
+StepperState StepperControl::goToThirdPosition(char targetThirdPosition) {
+    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::goToThirdPosition) {
+        if(isStepPending()) {
+            return StepperState::incomplete;   //the previous step hasn't been sent yet
+        }
+        //converts dial position to step number (decimal numbers are truncated)
+        unsigned int thirdPositionStepNumber = map(targetThirdPosition, 0, NUMBER_OF_POSITIONS, 0, NUMBER_OF_STEPS);
+        _previousStepperCommand = StepperCommand::goToThirdPosition;
+        if(abs(thirdPositionStepNumber - _currentStep) > 0) {   
+            rotateOneStep(StepperDirection::clockwise);    
+            _currentStepperCommand = StepperCommand::goToThirdPosition; 
+            return StepperState::incomplete; 
+        }
+        else {
+            _currentStepperCommand = StepperCommand::none; 
+            flightRecorder.record(FlightEventSource::stepper, (unsigned char)StepperCommand::goToThirdPosition, _channel, _currentStep); 
+            return StepperState::complete; 
+        } 
+    }
+    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Resets the lock by rotating clockwise two full rotations. 
+ *          This function is designed to be synchronous, meaning that it is
+ *          non-blocking and will be called many times before the target
+ *          step count is reached. Each time this function is called, the 
+ *          stepper should move one step until it gets to the target 
+ *          position.   
+ * @note    Uses rotateOneStep() function.
+ * @note    With -D INDEX_SENSOR, the position is re-synchronized whenever
+ *          the flag passes the sensor (see correctDrift()), on every 
+ *          INDEX_RESYNC_INTERVAL calls. 
+ * @returns Returns StepperState::incomplete or ::complete depending on 
+ *          if the stepper motor has reached the target position. If 
+ *          there is already another stepper motor command being
+ *          executed synchronously, this function will return
+ *          ::commandConflict
+ */ 
+/*****************************************************************************/
+StepperState StepperControl::rotateClockwiseTwice() {
+    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::rotateClockwiseTwice) {   //only allows one command to be executed at a time
+        if(isStepPending()) {
+            return StepperState::incomplete;   //the previous step hasn't been sent yet
+        }
+        if(_previousStepperCommand != StepperCommand::rotateClockwiseTwice) {   //if it is the first time this function has been called since the beginning of this synchronous execution
+            _targetStepCount = 2*NUMBER_OF_STEPS;
+            _stepCounter = 0; 
+#ifdef INDEX_SENSOR
+            _resyncCounter++; 
+            _isResyncing = (_resyncCounter >= INDEX_RESYNC_INTERVAL); 
+            if(_isResyncing) {
+                _resyncCounter = 0; 
+            }
+#endif
+        }
+        rotateOneStep(StepperDirection::clockwise); 
+        _stepCounter++; 
+#ifdef INDEX_SENSOR
+        if(_isResyncing && _isIndexEdge) {
+            correctDrift(); 
+        }
+#endif
+        _previousStepperCommand = StepperCommand::rotateClockwiseTwice;
+        if(_stepCounter < _targetStepCount) {
+            _currentStepperCommand = StepperCommand::rotateClockwiseTwice; 
+            return StepperState::incomplete;
+        } 
+        else if(_stepCounter == _targetStepCount) {
+            _currentStepperCommand = StepperCommand::none; 
+            flightRecorder.record(FlightEventSource::stepper, (unsigned char)StepperCommand::rotateClockwiseTwice, _channel, _currentStep); 
+            return StepperState::complete;  
+        }            
+    }
+    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
+} 
+
+/*****************************************************************************/
+/**
+ * @brief   Rotates counterclockwise one full rotation. This function is 
+ *          designed to be synchronous, meaning that it is non-blocking and 
+ *          will be called many times before the target step count is 
+ *          reached. Each time this function is called, the stepper should 
+ *          move one step until it gets to the target position. 
+ * @note    Uses rotateOneStep() function.
+ * @note    This function should be called before goToSecondPosition() is
+ *          called (this will be done in the Algorithm.cpp file). 
+ * @returns Returns StepperState::incomplete or ::complete depending on 
+ *          if the stepper motor has reached the target position. If 
+ *          there is already another stepper motor command being
+ *          executed synchronously, this function will return
+ *          ::commandConflict
+ */ 
+/*****************************************************************************/
+StepperState StepperControl::rotateCounterclockwiseOnce() {
+    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::rotateCounterclockwiseOnce) {   //only allows one command to be executed at a time
+        if(isStepPending()) {
+            return StepperState::incomplete;   //the previous step hasn't been sent yet
+        }
+        if(_previousStepperCommand != StepperCommand::rotateCounterclockwiseOnce) {   //if it is the first time this function has been called since the beginning of this synchronous execution
+            _targetStepCount = NUMBER_OF_STEPS;
+            _stepCounter = 0; 
+        }
+        rotateOneStep(StepperDirection::counterclockwise); 
+        _stepCounter++; 
+        _previousStepperCommand = StepperCommand::rotateCounterclockwiseOnce;
+        if(_stepCounter < _targetStepCount) {
+            _currentStepperCommand = StepperCommand::rotateCounterclockwiseOnce; 
+            return StepperState::incomplete;
+        } 
+        else if(_stepCounter == _targetStepCount) {
+            _currentStepperCommand = StepperCommand::none; 
+            flightRecorder.record(FlightEventSource::stepper, (unsigned char)StepperCommand::rotateCounterclockwiseOnce, _channel, _currentStep); 
+            return StepperState::complete;  
+        }            
+    }
+    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Rotates a given number of steps in the requested direction. This
+ *          function is designed to be synchronous, meaning that it is 
+ *          non-blocking and will be called many times before the target 
+ *          step count is reached. Each time this function is called, the 
+ *          stepper should move one step until it gets to the target position. 
+ * @note    Uses rotateOneStep() function.
+ * @note    This function is used to follow the maneuvers planned by the dial
+ *          model (see DialModel.cpp). Unlike the other commands, the step
+ *          count is latched whenever no command is in progress, so that two
+ *          moves can be executed back to back. 
+ * @param   direction   The direction that the motor should turn.
+ * @param   steps   The number of steps to rotate. 
+ * @returns Returns StepperState::incomplete or ::complete depending on 
+ *          if the stepper motor has reached the target position. If 
+ *          there is already another stepper motor command being
+ *          executed synchronously, this function will return
+ *          ::commandConflict
+ */ 
+/*****************************************************************************/
+StepperState StepperControl::rotateSteps(StepperDirection direction, int steps) {
+    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::rotateSteps) {   //only allows one command to be executed at a time
+        if(isStepPending()) {
+            return StepperState::incomplete;   //the previous step hasn't been sent yet
+        }
+        if(_currentStepperCommand == StepperCommand::none) {   //if it is the first time this function has been called since the beginning of this synchronous execution
+            _targetStepCount = steps;
+            _stepCounter = 0; 
+        }
+        _previousStepperCommand = StepperCommand::rotateSteps;
+        if(_stepCounter < _targetStepCount) {
+            rotateOneStep(direction); 
+            _stepCounter++; 
+            _currentStepperCommand = StepperCommand::rotateSteps; 
+            return StepperState::incomplete;   //complete on the next call, once the step has been sent (the servo may move right after)
+        } 
+        else {
+            _currentStepperCommand = StepperCommand::none; 
+            flightRecorder.record(FlightEventSource::stepper, (unsigned char)StepperCommand::rotateSteps, _channel, _currentStep); 
+            return StepperState::complete;  
+        }            
+    }
+    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Rotates the stepper motor one step in the requested direction. 
+ *          The step is handed to the Timer1 interrupt, which sends it once 
+ *          the step period has passed since the previous one, so this 
+ *          doesn't wait (and the time spent by the caller between two calls
+ *          is part of the period). After stopping or changing direction, 
+ *          the period starts at START_STEP_PERIOD_US and gets shorter by 
+ *          the same amount on each step, until it reaches the tuned period. 
+ * @note    The commands only call this once the previous step has been 
+ *          sent (see isStepPending()), and the motor has to be enabled. 
+ * @param   direction   The direction that the motor should turn.
+ *          Options: 
+ *          StepperDirection::clockwise, StepperDirection::counterclockwise
+ */ 
+/*****************************************************************************/
+void StepperControl::rotateOneStep(StepperDirection direction) {
+    PROFILE_SCOPE(ProfileSection::rotateOneStep); 
+    uint16_t ticksSinceStep; 
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ticksSinceStep = _ticksSinceStep; 
+    }
+    if(direction != _previousDirection || ticksSinceStep >= STOPPED_GAP_TICKS) {
+        _rampPeriodUs = max(_stepPeriodUs, (unsigned int)START_STEP_PERIOD_US); 
+    }
+    else if(_rampPeriodUs > _stepPeriodUs + _rampDecrementUs) {
+        _rampPeriodUs -= _rampDecrementUs; 
+    }
+    else {
+        _rampPeriodUs = _stepPeriodUs; 
+    }
+
+#ifdef INDEX_SENSOR
+    bool isFlagAtSensor = _isAtIndexBeforeStep;   //sampled right before the previous step was sent, when the rotor had had the whole period to settle
+    _isIndexEdge = (isFlagAtSensor && !_wasAtIndex && _previousDirection == StepperDirection::clockwise); 
+    _indexEdgeStep = (_currentStep + NUMBER_OF_STEPS - 1) % NUMBER_OF_STEPS;   //before the previous (clockwise) step
+    _wasAtIndex = isFlagAtSensor; 
+#endif
+    _previousDirection = direction; 
+    _stepCount++; 
+
+    if(direction == StepperDirection::clockwise) {
+        digitalWrite(_dirPin, HIGH);   //clockwise
+        _currentStep++; 
+        if(_currentStep == NUMBER_OF_STEPS) {
+            _currentStep = 0; 
+        }
+    }
+    else if(direction == StepperDirection::counterclockwise) {
+        digitalWrite(_dirPin, LOW);   //counterclockwise
+        _currentStep--; 
+        if(_currentStep < 0) {
+            _currentStep = NUMBER_OF_STEPS - 1; 
+        }
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        _pendingPeriodTicks = (_rampPeriodUs + STEP_TICK_US/2) / STEP_TICK_US; 
+        _isStepPending = true; 
+    }
+} 
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if the last step is still waiting to be sent by the 
+ *          interrupt. 
+ * @returns Returns true until the step has been sent. 
+ */ 
+/*****************************************************************************/
+bool StepperControl::isStepPending() {
+    return _isStepPending; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Ends the step pulse, and sends the pending step once its period
+ *          is over. Called from the Timer1 compare interrupt, every 
+ *          STEP_TICK_US. 
+ */ 
+/*****************************************************************************/
+void StepperControl::handleStepTick() {
+    if(_isStepPinHigh) {
+        *_stepPort &= ~_stepMask;   //pull step pin low so it can be triggered again
+        _isStepPinHigh = false; 
+    }
+    if(_ticksSinceStep < 0xFFFF) {
+        _ticksSinceStep++; 
+    }
+    if(_isStepPending && _isEnabled && _ticksSinceStep >= _pendingPeriodTicks) {
+#ifdef INDEX_SENSOR
+        if(_indexInputRegister != NULL) {
+            _isAtIndexBeforeStep = (((*_indexInputRegister & _indexMask) != 0) == (INDEX_SENSOR_ACTIVE == HIGH)); 
+        }
+#endif
+        *_stepPort |= _stepMask;   //trigger one step
+        _isStepPinHigh = true; 
+        _ticksSinceStep = 0; 
+        _isStepPending = false; 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Runs the Timer1 interrupt while any of the stepper motors is 
+ *          enabled, and stops it otherwise (so it doesn't take time from 
+ *          the display while nothing is moving). 
+ */ 
+/*****************************************************************************/
+void StepperControl::updateStepTimer() {
+    bool isAnyEnabled = false; 
+    for(uint8_t i = 0; i < numberOfStepperChannels; i++) {
+        if(stepperChannels[i]->_isEnabled) {
+            isAnyEnabled = true; 
+        }
+    }
+    if(isAnyEnabled) {
+        TIMSK1 |= _BV(OCIE1A); 
+    }
+    else {
+        TIMSK1 &= ~_BV(OCIE1A); 
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sets the step period at full speed. The acceleration ramp is
+ *          recalculated, so it always takes STEP_RAMP_STEPS to get from 
+ *          START_STEP_PERIOD_US to the new period. 
+ * @param   periodUs    The period (microseconds). Values outside
+ *          MIN_STEP_PERIOD_US to MAX_STEP_PERIOD_US are ignored and 
+ *          DEFAULT_STEP_PERIOD_US is used instead. 
+ */ 
+/*****************************************************************************/
+void StepperControl::setStepPeriod(unsigned int periodUs) {
+    if(periodUs < MIN_STEP_PERIOD_US || periodUs > MAX_STEP_PERIOD_US) {
+        periodUs = DEFAULT_STEP_PERIOD_US; 
+    }
+    _stepPeriodUs = periodUs; 
+    setRampPeriod(periodUs); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Recalculates the acceleration ramp as if the step period was 
+ *          rampPeriodUs, without changing the step period. With a longer 
+ *          rampPeriodUs, the motor speeds up at the same rate as it would 
+ *          at that period, and keeps going for more steps (used by the 
+ *          step rate trials, see StepRateTuner.h). setStepPeriod() sets the
+ *          ramp back to the step period's. 
+ * @param   rampPeriodUs    The period (microseconds). 
+ */ 
+/*****************************************************************************/
+void StepperControl::setRampPeriod(unsigned int rampPeriodUs) {
+    rampPeriodUs = min(rampPeriodUs, (unsigned int)START_STEP_PERIOD_US - 1);   //still speeds up (by 1us per step) if the step period is shorter than START_STEP_PERIOD_US
+    _rampDecrementUs = (_stepPeriodUs < START_STEP_PERIOD_US) ? (START_STEP_PERIOD_US - rampPeriodUs + STEP_RAMP_STEPS - 1)/STEP_RAMP_STEPS : 0; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the step period at full speed. 
+ * @returns Returns the period (microseconds). 
+ */ 
+/*****************************************************************************/
+unsigned int StepperControl::getStepPeriod() {
+    return _stepPeriodUs; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the number of steps taken since boot (both directions), 
+ *          which is used to count the steps of an attempt (see 
+ *          Telemetry.h). 
+ * @returns Returns the step count. 
+ */ 
+/*****************************************************************************/
+unsigned long StepperControl::getStepCount() {
+    return _stepCount; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the dead-reckoned step that the dial is at (0 at the dial's
+ *          zero), which is recorded with the flight recorder's events (see 
+ *          FlightRecorder.h). 
+ * @returns Returns the step (0 to NUMBER_OF_STEPS - 1). 
+ */ 
+/*****************************************************************************/
+int StepperControl::getCurrentStep() {
+    return _currentStep; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Saves the step period to the EEPROM, so it's used after the next 
+ *          boot. 
+ */ 
+/*****************************************************************************/
+void StepperControl::saveStepPeriod() {
+    EEPROM.put(STEP_PERIOD_EEPROM_ADDRESS + 1, _stepPeriodUs);   //only writes the bytes that are different
+    EEPROM.update(STEP_PERIOD_EEPROM_ADDRESS, STEP_PERIOD_MAGIC);
+}
+
+#ifdef INDEX_SENSOR
+/*****************************************************************************/
+/**
+ * @brief   Turns clockwise until the index sensor sees the flag, then sets 
+ *          the current step from the measured index position. This function
+ *          is designed to be synchronous (one step per call), like the 
+ *          other commands. 
+ * @returns Returns StepperState::incomplete until the flag is found, then 
+ *          ::complete. Returns ::indexNotFound if the index position hasn't
+ *          been measured, or if the flag wasn't seen within 
+ *          INDEX_SEARCH_STEPS (the dial is back where it started, so the 
+ *          dead-reckoned position is still good). If there is already 
+ *          another stepper motor command being executed synchronously, 
+ *          this function will return ::commandConflict
+ */ 
+/*****************************************************************************/
+StepperState StepperControl::homeToIndex() {
+    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::homeToIndex) {   //only allows one command to be executed at a time
+        if(isStepPending()) {
+            return StepperState::incomplete;   //the previous step hasn't been sent yet
+        }
+        _previousStepperCommand = StepperCommand::homeToIndex;
+        if(!_hasIndexStep) {
+            return StepperState::indexNotFound; 
+        }
+        if(_currentStepperCommand == StepperCommand::none) {   //if it is the first time this function has been called since the beginning of this synchronous execution
+            _targetStepCount = INDEX_SEARCH_STEPS;
+            _stepCounter = 0; 
+            _wasAtIndex = isAtIndex(); 
+            _isAtIndexBeforeStep = _wasAtIndex; 
+        }
+        rotateOneStep(StepperDirection::clockwise); 
+        _stepCounter++; 
+        if(_isIndexEdge) {
+            _currentStep = (_currentStep - getIndexDrift() + 2*NUMBER_OF_STEPS) % NUMBER_OF_STEPS; 
+            _currentStepperCommand = StepperCommand::none; 
+            flightRecorder.record(FlightEventSource::stepper, (unsigned char)StepperCommand::homeToIndex, _channel, _currentStep); 
+            return StepperState::complete; 
+        }
+        if(_stepCounter < _targetStepCount) {
+            _currentStepperCommand = StepperCommand::homeToIndex; 
+            return StepperState::incomplete;
+        } 
+        _currentStepperCommand = StepperCommand::none; 
+        return StepperState::indexNotFound;  
+    }
+    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Measures where the index sensor is. The dial has to be at zero 
+ *          (setup page 7), it's turned clockwise one full turn and the step
+ *          at which the flag is reached is saved to the EEPROM. The dial 
+ *          ends at zero again. This function is designed to be synchronous 
+ *          (one step per call), like the other commands. 
+ * @note    The flag can't be found if it's already in front of the sensor 
+ *          when the dial is at zero. The sensor should be mounted so that 
+ *          it isn't. 
+ * @returns Returns StepperState::incomplete until the turn is done, then 
+ *          ::complete, or ::indexNotFound if the flag wasn't seen. If 
+ *          there is already another stepper motor command being executed 
+ *          synchronously, this function will return ::commandConflict
+ */ 
+/*****************************************************************************/
+StepperState StepperControl::measureIndex() {
+    if(_currentStepperCommand == StepperCommand::none || _currentStepperCommand == StepperCommand::measureIndex) {   //only allows one command to be executed at a time
+        if(isStepPending()) {
+            return StepperState::incomplete;   //the previous step hasn't been sent yet
+        }
+        if(_currentStepperCommand == StepperCommand::none) {   //if it is the first time this function has been called since the beginning of this synchronous execution
+            _targetStepCount = NUMBER_OF_STEPS;
+            _stepCounter = 0; 
+            _currentStep = 0; 
+            _wasAtIndex = isAtIndex(); 
+            _isAtIndexBeforeStep = _wasAtIndex; 
+            _hasIndexStep = false; 
+        }
+        _previousStepperCommand = StepperCommand::measureIndex;
+        if(_stepCounter < _targetStepCount) {
+            rotateOneStep(StepperDirection::clockwise); 
+            _stepCounter++; 
+            if(_isIndexEdge && !_hasIndexStep) {
+                _indexStep = _indexEdgeStep; 
+                _hasIndexStep = true; 
+            }
+            _currentStepperCommand = StepperCommand::measureIndex; 
+            return StepperState::incomplete;   //finished on the next call, once the last step has been sent (the motor is disabled right after)
+        } 
+        _currentStepperCommand = StepperCommand::none; 
+        if(!_hasIndexStep) {
+            EEPROM.update(INDEX_STEP_EEPROM_ADDRESS, 0xFF);   //forgets the old position, the sensor may have been moved
+            return StepperState::indexNotFound; 
+        }
+        EEPROM.update(INDEX_STEP_EEPROM_ADDRESS + 1, (unsigned char)_indexStep); 
+        EEPROM.update(INDEX_STEP_EEPROM_ADDRESS, INDEX_STEP_MAGIC); 
+        flightRecorder.record(FlightEventSource::stepper, (unsigned char)StepperCommand::measureIndex, _channel, _indexStep);   //the measured position instead of the current step (which is back at 0)
+#ifdef PRINT_INDEX_DRIFT
+        Serial.print(F("index step: ")); 
+        Serial.println(_indexStep); 
+#endif
+        return StepperState::complete;  
+    }
+    return StepperState::commandConflict;   //another stepper command is in the process of being executed (synchronously)
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Reads the index sensor. 
+ * @returns Returns true if the flag is in front of the sensor. 
+ */ 
+/*****************************************************************************/
+bool StepperControl::isAtIndex() {
+    return digitalRead(INDEX_SENSOR_PIN) == INDEX_SENSOR_ACTIVE; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if the index position has been measured (see 
+ *          measureIndex()), without which homeToIndex() can't be used. 
+ * @returns Returns true if the index position is known. 
+ */ 
+/*****************************************************************************/
+bool StepperControl::hasIndexStep() {
+    return _hasIndexStep; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Gets the difference between the dead-reckoned step where the flag
+ *          was just reached and the measured index position. After 
+ *          homeToIndex(), this is the drift that it corrected. 
+ * @returns Returns the drift (steps, -NUMBER_OF_STEPS/2 to 
+ *          NUMBER_OF_STEPS/2), positive if the dead-reckoned position is 
+ *          ahead of the dial (steps were lost turning clockwise). 
+ */ 
+/*****************************************************************************/
+int StepperControl::getIndexDrift() {
+    int driftSteps = _indexEdgeStep - _indexStep; 
+    if(driftSteps > NUMBER_OF_STEPS/2) {
+        driftSteps -= NUMBER_OF_STEPS; 
+    }
+    else if(driftSteps < -NUMBER_OF_STEPS/2) {
+        driftSteps += NUMBER_OF_STEPS; 
+    }
+    return driftSteps; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Compares the dead-reckoned step where the flag was just reached
+ *          with the measured index position, and moves the current step by
+ *          the difference (the drift from lost or extra steps). 
+ * @note    Called right after rotateOneStep() when _isIndexEdge is set. 
+ */ 
+/*****************************************************************************/
+void StepperControl::correctDrift() {
+    if(!_hasIndexStep) {
+        return; 
+    }
+    int driftSteps = getIndexDrift(); 
+    if(driftSteps == 0 || abs(driftSteps) > MAX_INDEX_DRIFT_STEPS) {
+        return; 
+    }
+    _currentStep = (_currentStep - driftSteps + NUMBER_OF_STEPS) % NUMBER_OF_STEPS; 
+    _correctedDriftSteps += abs(driftSteps); 
+    flightRecorder.record(FlightEventSource::indexDrift, (unsigned char)driftSteps, _channel, _currentStep);   //MAX_INDEX_DRIFT_STEPS fits in a signed char
+#ifdef PRINT_INDEX_DRIFT
+    Serial.print(F("index drift (steps): ")); 
+    Serial.print(driftSteps); 
+    Serial.print(F(", corrected in total: ")); 
+    Serial.println(_correctedDriftSteps); 
+#endif
+}
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   Enables the stepper motor so it can move and hold. 
+ */ 
+/*****************************************************************************/
+void StepperControl::enableStepperMotor() {
+    digitalWrite(_enPin, LOW);  //enabled
+    _isEnabled = true; 
+    updateStepTimer(); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Disables the stepper motor, preventing it from moving or holding.
+ *          When the stepper motor is disabled, the shaft can be rotated 
+ *          freely. 
+ */ 
+/*****************************************************************************/
+void StepperControl::disableStepperMotor() {
+    digitalWrite(_enPin, HIGH);  //disable
+    _isEnabled = false; 
+    updateStepTimer(); 
+}
+
+ISR(TIMER1_COMPA_vect) {
+    for(uint8_t i = 0; i < numberOfStepperChannels; i++) {
+        stepperChannels[i]->handleStepTick(); 
+    }
+}
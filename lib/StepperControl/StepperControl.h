@@ -1,53 +1,132 @@
-
-#ifndef STEPPER_CONTROL_H
-#define STEPPER_CONTROL_H
-
-//to use STEP and DIR pins, the MegaCore needs to be used, and the "Arduino MEGA pinout" needs to be used
-#define STEP_PIN 79
-#define DIR_PIN 78
-#define MS1_PIN 12
-#define MS2_PIN 10
-#define EN_PIN  11
-
-#define NUMBER_OF_STEPS 200
-
-enum class StepperDirection { clockwise, counterclockwise };
-enum class StepperState {
-    incomplete,
-    complete, 
-    commandConflict   //another stepper command is in the process of being executed (synchronously)
-}; 
-
-enum class StepperCommand {
-    none,
-    rotateClockwiseTwice,
-    goToThirdPosition,
-    rotateCounterclockwiseOnce,
-    goToSecondPosition,
-    goToFirstPosition,  
-};
-
-class StepperControl {
-public: 
-    void init(); 
-    void reconfig(); 
-    StepperState goToFirstPosition(char targetFirstPosition); 
-    StepperState goToSecondPosition(char targetSecondPosition);
-    StepperState goToThirdPosition(char targetThirdPosition); 
-    StepperState rotateClockwiseTwice(); 
-    StepperState rotateCounterclockwiseOnce(); 
-    void enableStepperMotor();
-    void disableStepperMotor();  
-
-private:
-    void rotateOneStep(StepperDirection direction); 
-    StepperCommand _currentStepperCommand;
-    StepperCommand _previousStepperCommand; 
-    int _currentStep; 
-    int _targetStepCount; 
-    int _stepCounter; 
-};
-extern StepperControl stepperControl; 
-
-#endif
-
+
+#ifndef STEPPER_CONTROL_H
+#define STEPPER_CONTROL_H
+
+#include <Arduino.h>
+
+//channel 0 (see ChannelPins.h). To use STEP and DIR pins, the MegaCore needs to be used, and the "Arduino MEGA pinout" needs to be used
+#ifdef ARDUINO_MEGA_ENV
+  #define STEP_PIN 52   //PB1, port E (pin 79) has LCD data lines on the Mega's shield (see ChannelPins.h)
+#else
+  #define STEP_PIN 79
+#endif
+#define DIR_PIN 78
+#define MS1_PIN 12
+#define MS2_PIN 10
+#define EN_PIN  11
+
+#define NUMBER_OF_STEPS 200
+
+//step timing (the step period is tuned on the setup pages, see StepRateTuner.h)
+#define STEP_PERIOD_MAGIC 0xA5   //marks a tuned step period in the EEPROM (erased EEPROM reads 0xFF)
+#define DEFAULT_STEP_PERIOD_US 2000   //500 steps/s, used until the step rate has been tuned
+#define MIN_STEP_PERIOD_US 250   //a saved period outside this range is ignored
+#define MAX_STEP_PERIOD_US 5000
+#define START_STEP_PERIOD_US 2000   //period of the first step after stopping or changing direction
+#define STEP_RAMP_STEPS 16   //steps it takes to speed up from START_STEP_PERIOD_US to the step period
+#define STOPPED_GAP_US 10000   //if there was no step for this long, the motor is assumed to have stopped (the ramp starts over)
+
+//the steps of every channel are sent from one Timer1 interrupt (CTC, clk/8), which runs while any stepper motor is enabled
+#define STEP_TICK_US 100   //step periods are rounded to this, and the step pulse is this long (the Easy Driver needs at least 1 us)
+#define STEP_TIMER_TICKS_PER_US 2   //16 MHz / 8
+#define STOPPED_GAP_TICKS (STOPPED_GAP_US / STEP_TICK_US)
+
+//optional home/index sensor (optical slot or hall sensor) that sees a flag on the drive once per turn, enabled with -D INDEX_SENSOR
+#ifdef INDEX_SENSOR
+  #define INDEX_SENSOR_PIN 40   //spare pin next to the limit switch, only channel 0 has an index sensor
+  #define INDEX_SENSOR_ACTIVE LOW   //the internal pull-up is used, an open collector sensor pulls the pin low at the flag
+  #define INDEX_STEP_MAGIC 0xC3   //marks a measured index position in the EEPROM (erased EEPROM reads 0xFF)
+  #define INDEX_SEARCH_STEPS (2*NUMBER_OF_STEPS)   //homing gives up after two turns, which leaves the dial where it started
+  #define INDEX_RESYNC_INTERVAL 1   //the position is re-synchronized on every Nth rotateClockwiseTwice() (each one passes the index twice)
+  #define MAX_INDEX_DRIFT_STEPS 20   //a larger difference is assumed to be a bad reading (or a slipping coupling) and isn't corrected
+#endif
+
+enum class StepperDirection { clockwise, counterclockwise };
+enum class StepperState {
+    incomplete,
+    complete, 
+    commandConflict,   //another stepper command is in the process of being executed (synchronously)
+    indexNotFound   //the index sensor didn't see the flag (or the index position hasn't been measured)
+}; 
+
+enum class StepperCommand {
+    none,
+    rotateClockwiseTwice,
+    goToThirdPosition,
+    rotateCounterclockwiseOnce,
+    goToSecondPosition,
+    goToFirstPosition,  
+    rotateSteps,
+    homeToIndex,
+    measureIndex,
+};
+
+class StepperControl {
+public: 
+    void init(unsigned char channel); 
+    void reconfig(); 
+    StepperState goToFirstPosition(char targetFirstPosition); 
+    StepperState goToSecondPosition(char targetSecondPosition);
+    StepperState goToThirdPosition(char targetThirdPosition); 
+    StepperState rotateClockwiseTwice(); 
+    StepperState rotateCounterclockwiseOnce(); 
+    StepperState rotateSteps(StepperDirection direction, int steps); 
+    void enableStepperMotor();
+    void disableStepperMotor();  
+    void setStepPeriod(unsigned int periodUs); 
+    void setRampPeriod(unsigned int rampPeriodUs); 
+    unsigned int getStepPeriod(); 
+    unsigned long getStepCount(); 
+    int getCurrentStep(); 
+    void saveStepPeriod(); 
+#ifdef INDEX_SENSOR
+    StepperState homeToIndex(); 
+    StepperState measureIndex(); 
+    bool hasIndexStep(); 
+    int getIndexDrift(); 
+#endif
+    void handleStepTick(); 
+
+private:
+    void rotateOneStep(StepperDirection direction); 
+    bool isStepPending(); 
+    static void updateStepTimer(); 
+    unsigned char _channel; 
+    uint8_t _dirPin, _ms1Pin, _ms2Pin, _enPin; 
+    volatile uint8_t* _stepPort;   //the step pin is written directly by the interrupt
+    uint8_t _stepMask; 
+    volatile bool _isEnabled; 
+    volatile bool _isStepPending;   //a step has been requested, and the interrupt sends it once the period is over
+    volatile bool _isStepPinHigh; 
+    volatile uint16_t _pendingPeriodTicks; 
+    volatile uint16_t _ticksSinceStep;   //stops counting at 0xFFFF
+#ifdef INDEX_SENSOR
+    bool isAtIndex(); 
+    void correctDrift(); 
+    volatile uint8_t* _indexInputRegister;   //NULL if the channel has no index sensor
+    uint8_t _indexMask; 
+    volatile bool _isAtIndexBeforeStep;   //sampled by the interrupt right before it sends a step
+    bool _hasIndexStep;   //false until the index position has been measured (see measureIndex())
+    int _indexStep;   //the step (dial zero = 0) at which the flag is first seen when turning clockwise
+    bool _wasAtIndex; 
+    bool _isIndexEdge;   //the flag was reached (clockwise) right before the previous step was sent
+    int _indexEdgeStep;   //the dead-reckoned step where that happened
+    bool _isResyncing; 
+    unsigned char _resyncCounter; 
+    unsigned int _correctedDriftSteps;   //total of all the corrections since the program started
+#endif
+    unsigned int _stepPeriodUs;   //period at full speed
+    unsigned long _stepCount;   //steps since boot, in both directions
+    unsigned int _rampPeriodUs;   //period of the last step (longer while speeding up)
+    unsigned int _rampDecrementUs;   //how much shorter each step of the ramp is
+    StepperDirection _previousDirection; 
+    StepperCommand _currentStepperCommand;
+    StepperCommand _previousStepperCommand; 
+    int _currentStep; 
+    int _targetStepCount; 
+    int _stepCounter; 
+};
+extern StepperControl& stepperControl;   //channel 0, which is the one that the setup pages use
+
+#endif
+
@@ -0,0 +1,268 @@
+
+#include <Arduino.h>
+#ifdef TELEMETRY
+  #include <util/crc16.h>
+#endif
+#include "Telemetry.h"
+#include "LimitSwitch.h"
+
+#if (TELEMETRY_BUFFER_SIZE & (TELEMETRY_BUFFER_SIZE - 1)) != 0 || TELEMETRY_BUFFER_SIZE > 256
+  #error "TELEMETRY_BUFFER_SIZE has to be a power of two, up to 256"
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   Starts the serial port. This function should only be called once
+ *          when the microcontroller boots (call in setup).
+ * @note    Does nothing unless -D TELEMETRY is set. The text printed by the
+ *          PRINT_* flags goes to the same port, the decoder skips it (the
+ *          CRC doesn't match).
+ */
+/*****************************************************************************/
+void Telemetry::init() {
+#ifdef TELEMETRY
+    Serial.begin(TELEMETRY_BAUD);
+    for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+        _limitSwitchState[i] = LIMIT_SWITCH_RELEASED;
+    }
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Hands the buffered frames to Serial, but only as many bytes as
+ *          its transmit buffer has room for, so Serial.write() never waits.
+ *          The bytes are then sent by Serial's transmit interrupt. Should be
+ *          called often (in loop), it's also called after each frame.
+ */
+/*****************************************************************************/
+void Telemetry::update() {
+#ifdef TELEMETRY
+    int room = Serial.availableForWrite();
+    while(room > 0 && _tail != _head) {
+        Serial.write(_buffer[_tail]);
+        _isInsideFrame = (_buffer[_tail] != 0);   //0 is the delimiter at the end of each frame
+        _tail = (_tail + 1) & (TELEMETRY_BUFFER_SIZE - 1);
+        room--;
+    }
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if text can be sent to the serial port without ending up
+ *          in the middle of a frame (see RemoteControl.h).
+ * @returns Returns true if the last byte handed to Serial ended a frame,
+ *          or if -D TELEMETRY isn't set.
+ */
+/*****************************************************************************/
+bool Telemetry::isAtFrameBoundary() {
+#ifdef TELEMETRY
+    return !_isInsideFrame;
+#else
+    return true;
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sends the combination that is about to be dialed, and starts
+ *          timing the attempt.
+ * @param   channel The channel (0 to NUMBER_OF_CHANNELS - 1).
+ * @param   attemptNumber   The number of attempts made before this one.
+ * @param   firstPos    The first position.
+ * @param   secondPos   The second position.
+ * @param   thirdPos    The third position.
+ * @param   kind    Why the combination is tried.
+ * @param   stepCount   The channel's step count (see
+ *          StepperControl::getStepCount()).
+ */
+/*****************************************************************************/
+void Telemetry::sendAttemptStart(unsigned char channel, unsigned int attemptNumber, char firstPos, char secondPos, char thirdPos, TelemetryAttemptKind kind, unsigned long stepCount) {
+#ifdef TELEMETRY
+    _attemptStartMicros[channel] = micros();
+    _attemptStartStepCount[channel] = stepCount;
+    _isAttemptOpened[channel] = false;
+    beginFrame(TelemetryFrame::attemptStart, channel);
+    addUint16(attemptNumber);
+    addByte(firstPos);
+    addByte(secondPos);
+    addByte(thirdPos);
+    addByte((uint8_t)kind);
+    endFrame();
+#else
+    (void)channel; (void)attemptNumber; (void)firstPos; (void)secondPos; (void)thirdPos; (void)kind; (void)stepCount;
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sends the steps and the time it took to dial the combination,
+ *          and starts timing the dwell (the shackle being pulled).
+ * @param   channel The channel.
+ * @param   stepCount   The channel's step count.
+ */
+/*****************************************************************************/
+void Telemetry::sendDialed(unsigned char channel, unsigned long stepCount) {
+#ifdef TELEMETRY
+    _dwellStartMicros[channel] = micros();
+    beginFrame(TelemetryFrame::dialed, channel);
+    addUint16(stepCount - _attemptStartStepCount[channel]);
+    addUint32(_dwellStartMicros[channel] - _attemptStartMicros[channel]);
+    endFrame();
+#else
+    (void)channel; (void)stepCount;
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sends how long the shackle was pulled and released, and if the
+ *          lock opened (the limit switch was activated since the attempt
+ *          started, see updateLimitSwitch()).
+ * @param   channel The channel.
+ */
+/*****************************************************************************/
+void Telemetry::sendAttemptEnd(unsigned char channel) {
+#ifdef TELEMETRY
+    unsigned long dwellMicros = micros() - _dwellStartMicros[channel];
+    beginFrame(TelemetryFrame::attemptEnd, channel);
+    addUint32(dwellMicros);
+    addByte(_isAttemptOpened[channel]);
+    endFrame();
+#else
+    (void)channel;
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sends the limit switch state when it has changed since the last
+ *          call.
+ * @param   channel The channel.
+ * @param   state   The state read from the limit switch.
+ */
+/*****************************************************************************/
+void Telemetry::updateLimitSwitch(unsigned char channel, bool state) {
+#ifdef TELEMETRY
+    if(state == _limitSwitchState[channel]) {
+        return;
+    }
+    _limitSwitchState[channel] = state;
+    if(state == LIMIT_SWITCH_ACTIVATED) {
+        _isAttemptOpened[channel] = true;
+    }
+    beginFrame(TelemetryFrame::limitSwitch, channel);
+    addByte(state);
+    endFrame();
+#else
+    (void)channel; (void)state;
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Sends how the run ended.
+ * @param   channel The channel.
+ * @param   state   The AlgorithmState returned by Algorithm::run().
+ * @param   attempts    The number of attempts made.
+ */
+/*****************************************************************************/
+void Telemetry::sendRunEnd(unsigned char channel, uint8_t state, unsigned int attempts) {
+#ifdef TELEMETRY
+    beginFrame(TelemetryFrame::runEnd, channel);
+    addByte(state);
+    addUint16(attempts);
+    endFrame();
+#else
+    (void)channel; (void)state; (void)attempts;
+#endif
+}
+
+#ifdef TELEMETRY
+/*****************************************************************************/
+/**
+ * @brief   Starts a frame with the header (sequence, type, channel and
+ *          timestamp).
+ */
+/*****************************************************************************/
+void Telemetry::beginFrame(TelemetryFrame type, unsigned char channel) {
+    _payloadLength = 0;
+    addByte(_sequence);
+    _sequence++;
+    addByte((uint8_t)type);
+    addByte(channel);
+    addUint32(micros());
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Adds a byte to the frame's payload (bytes past
+ *          TELEMETRY_MAX_PAYLOAD are left out).
+ */
+/*****************************************************************************/
+void Telemetry::addByte(uint8_t value) {
+    if(_payloadLength < TELEMETRY_MAX_PAYLOAD) {
+        _payload[_payloadLength] = value;
+        _payloadLength++;
+    }
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Adds a number to the frame's payload, low byte first.
+ */
+/*****************************************************************************/
+void Telemetry::addUint16(uint16_t value) {
+    addByte(value);
+    addByte(value >> 8);
+}
+
+void Telemetry::addUint32(uint32_t value) {
+    addUint16(value);
+    addUint16(value >> 16);
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Adds the CRC, then COBS encodes the frame into the buffer (each
+ *          0 byte is replaced by the distance to the next one, so 0 only
+ *          appears as the delimiter at the end). If the buffer doesn't have
+ *          room for the whole frame, the frame is dropped.
+ * @note    The payload is shorter than 254 bytes, so the encoding only adds
+ *          one byte (plus the delimiter).
+ */
+/*****************************************************************************/
+void Telemetry::endFrame() {
+    uint16_t crc = TELEMETRY_CRC_INIT;
+    for(uint8_t i = 0; i < _payloadLength; i++) {
+        crc = _crc_ccitt_update(crc, _payload[i]);
+    }
+    addUint16(crc);
+
+    uint8_t used = (_head - _tail) & (TELEMETRY_BUFFER_SIZE - 1);
+    if(used + _payloadLength + 2 >= TELEMETRY_BUFFER_SIZE) {   //one byte is always left free, so a full buffer doesn't look empty
+        return;
+    }
+    uint8_t codeIndex = _head;   //where the distance to the next 0 is written once it's known
+    uint8_t code = 1;
+    _head = (_head + 1) & (TELEMETRY_BUFFER_SIZE - 1);
+    for(uint8_t i = 0; i < _payloadLength; i++) {
+        if(_payload[i] == 0) {
+            _buffer[codeIndex] = code;
+            codeIndex = _head;
+            code = 1;
+        }
+        else {
+            _buffer[_head] = _payload[i];
+            code++;
+        }
+        _head = (_head + 1) & (TELEMETRY_BUFFER_SIZE - 1);
+    }
+    _buffer[codeIndex] = code;
+    _buffer[_head] = 0;   //delimiter
+    _head = (_head + 1) & (TELEMETRY_BUFFER_SIZE - 1);
+
+    update();
+}
+#endif
@@ -0,0 +1,65 @@
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "Common.h"
+
+//add -D TELEMETRY to the build flags (platformio.ini) to send the attempts to the serial port as binary frames, decoded
+//on the computer with tools/telemetry_decode.py. Each frame is COBS encoded and ends with a 0 byte:
+//    sequence (1 byte), type (1), channel (1), timestamp (4, micros()), fields (see TelemetryFrame), CRC (2)
+//numbers are little endian, and the CRC is avr-libc's _crc_ccitt_update() over everything before it, starting at 0xFFFF
+#define TELEMETRY_BAUD 115200   //same as monitor_speed
+#define TELEMETRY_BUFFER_SIZE 128   //bytes waiting to be handed to Serial, has to be a power of two
+#define TELEMETRY_MAX_PAYLOAD 16   //header, largest field set and CRC
+#define TELEMETRY_CRC_INIT 0xFFFF
+
+//the type byte, and the fields that follow the header
+enum class TelemetryFrame : uint8_t {
+    attemptStart = 1,   //attempt number (2 bytes), first, second, third position (1 each), TelemetryAttemptKind (1)
+    dialed,             //steps since the attempt started (2), dialing time in microseconds (4)
+    attemptEnd,         //time the shackle was pulled and released in microseconds (4), opened (1)
+    limitSwitch,        //LIMIT_SWITCH_RELEASED or LIMIT_SWITCH_ACTIVATED (1)
+    runEnd              //AlgorithmState (1), attempts (2)
+};
+
+enum class TelemetryAttemptKind : uint8_t {
+    search,
+    fastOpen,          //the cached combination (see CombinationCache.h)
+    refinementProbe    //not counted as an attempt (see REFINE_COMBINATION)
+};
+
+class Telemetry {
+public:
+    void init();
+    void update();
+    bool isAtFrameBoundary();
+    void sendAttemptStart(unsigned char channel, unsigned int attemptNumber, char firstPos, char secondPos, char thirdPos, TelemetryAttemptKind kind, unsigned long stepCount);
+    void sendDialed(unsigned char channel, unsigned long stepCount);
+    void sendAttemptEnd(unsigned char channel);
+    void updateLimitSwitch(unsigned char channel, bool state);
+    void sendRunEnd(unsigned char channel, uint8_t state, unsigned int attempts);
+
+private:
+#ifdef TELEMETRY
+    void beginFrame(TelemetryFrame type, unsigned char channel);
+    void addByte(uint8_t value);
+    void addUint16(uint16_t value);
+    void addUint32(uint32_t value);
+    void endFrame();
+    uint8_t _buffer[TELEMETRY_BUFFER_SIZE];   //encoded frames, handed to Serial by update() as its own buffer empties
+    uint8_t _head, _tail;
+    bool _isInsideFrame;   //part of a frame has been handed to Serial, so other text can't be sent yet
+    uint8_t _payload[TELEMETRY_MAX_PAYLOAD];
+    uint8_t _payloadLength;
+    uint8_t _sequence;   //the decoder sees a gap when a frame was dropped (the buffer was full)
+    unsigned long _attemptStartMicros[NUMBER_OF_CHANNELS];
+    unsigned long _attemptStartStepCount[NUMBER_OF_CHANNELS];
+    unsigned long _dwellStartMicros[NUMBER_OF_CHANNELS];
+    bool _limitSwitchState[NUMBER_OF_CHANNELS];
+    bool _isAttemptOpened[NUMBER_OF_CHANNELS];   //the limit switch was activated since the attempt started
+#endif
+};
+extern Telemetry telemetry;
+
+#endif
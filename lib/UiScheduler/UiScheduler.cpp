@@ -0,0 +1,30 @@
+
+#include <Arduino.h>
+#include "UiScheduler.h"
+
+/*****************************************************************************/
+/**
+ * @brief   Starts counting the deferral from now. Call when a run starts. 
+ */
+/*****************************************************************************/
+void UiScheduler::reset() {
+    _previousWindowMs = millis(); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if the display can be redrawn and the touch screen read 
+ *          on this pass of loop(). 
+ * @param   isDialMoving    True if a dial is being turned (a channel is 
+ *          running and isn't dwelling, see Algorithm::isDwelling()). 
+ * @returns Returns true if no dial is moving, or if the UI work has been 
+ *          put off for UI_MAX_DEFERRAL_MS. 
+ */
+/*****************************************************************************/
+bool UiScheduler::isWindowOpen(bool isDialMoving) {
+    if(isDialMoving && millis() - _previousWindowMs < UI_MAX_DEFERRAL_MS) {
+        return false; 
+    }
+    _previousWindowMs = millis(); 
+    return true; 
+}
@@ -0,0 +1,21 @@
+
+#ifndef UI_SCHEDULER_H
+#define UI_SCHEDULER_H
+
+//Each step is requested by Algorithm::run() and sent by the timer interrupt once the step period is over (see
+//StepperControl.h), so time spent redrawing the display or reading the touch screen between two run() calls delays the
+//next step. While a run is going, that work is only done in the windows where no dial is moving (the servo dwell, about
+//800 ms of each attempt). With several channels the dials don't always stop at the same time, so a window is forced
+//(for one pass of loop()) if there hasn't been one for UI_MAX_DEFERRAL_MS
+#define UI_MAX_DEFERRAL_MS 3000
+
+class UiScheduler {
+public:
+    void reset(); 
+    bool isWindowOpen(bool isDialMoving); 
+
+private:
+    unsigned long _previousWindowMs; 
+};
+
+#endif
@@ -1,122 +1,627 @@
-
-#include <Arduino.h>
-#include <EEPROM.h> 
-#include "ServoControl.h"
-#include "StepperControl.h"
-#include "Display.h" 
-#include "Algorithm.h"  
-
-DisplayPage currentPage = DisplayPage::home;
-
-//these position variables are assigned proper values when the program starts
-char firstPosition = NO_POSITION_ASSIGNED;
-char secondPosition = NO_POSITION_ASSIGNED; 
-char thirdPosition = NO_POSITION_ASSIGNED; 
-
-unsigned int attemptsCounter = 0; 
-unsigned long startTimeMs = 0;   
-
-StepperControl stepperControl; 
-ServoControl servoControl; 
-Algorithm algorithm;   
-Display display; 
-
-void setup() {
-  servoControl.init(); 
-  stepperControl.init(); 
-  algorithm.init(&firstPosition, &secondPosition, &thirdPosition); 
-  display.init();  
-}
-
-void loop() {
-  if(currentPage == DisplayPage::home) {
-    display.drawOnce_homePage(); 
-    stepperControl.disableStepperMotor(); 
-    currentPage = display.monitorInputs_homePage(); 
-    if(currentPage == DisplayPage::runProgram1) {
-      servoControl.reconfig(); 
-      stepperControl.reconfig(); 
-      algorithm.reconfig();  
-      display.reconfig();  
-      firstPosition = NO_POSITION_ASSIGNED;  
-      secondPosition = NO_POSITION_ASSIGNED;   
-      thirdPosition = NO_POSITION_ASSIGNED; 
-      attemptsCounter = 0; 
-    }
-  }
-  else if(currentPage == DisplayPage::runProgram1) {
-    display.drawOnce_runProgramPage1();
-    currentPage = display.monitorInputs_runProgramPage1(); 
-    if(currentPage == DisplayPage::runProgram2) {      
-      servoControl.moveBottomPosition();    
-    } 
-  }  
-  else if(currentPage == DisplayPage::runProgram2) {
-    display.drawOnce_runProgramPage2();
-    currentPage = display.monitorInputs_runProgramPage2();  
-    if(currentPage == DisplayPage::runProgram3) {    //(re)initializations that need to be done before the program (re)starts running go here        
-      startTimeMs = millis(); 
-      stepperControl.enableStepperMotor();   
-    }
-  }  
-  else if(currentPage == DisplayPage::runProgram3) {
-    AlgorithmState state = algorithm.run(&attemptsCounter);   
-    if(state == AlgorithmState::complete) {
-      currentPage = DisplayPage::results; 
-    }
-    else if(state == AlgorithmState::error) {
-      currentPage = DisplayPage::error; 
-    }
-    else if(state == AlgorithmState::running) {
-      display.drawOnce_runProgramPage3();
-      display.drawOnce_updatedCombination(firstPosition, secondPosition, thirdPosition);  
-      currentPage = display.monitorInputs_runProgramPage3();
-    }
-  }  
-  else if(currentPage == DisplayPage::setup1) {
-    display.drawOnce_setupPage1(); 
-    currentPage = display.monitorInputs_setupPage1();
-    if(currentPage == DisplayPage::setup2) {
-      servoControl.reconfig(); 
-      servoControl.moveBottomPosition(); 
-    } 
-  }
-  else if(currentPage == DisplayPage::setup2) {
-    display.drawOnce_setupPage2(); 
-    currentPage = display.monitorInputs_setupPage2(); 
-  }
-  else if(currentPage == DisplayPage::setup3) {
-    display.drawOnce_setupPage3(); 
-    currentPage = display.monitorInputs_setupPage3(); 
-  }  
-  else if(currentPage == DisplayPage::setup4) {
-    display.drawOnce_setupPage4(); 
-    currentPage = display.monitorInputs_setupPage4(); 
-  }
-  else if(currentPage == DisplayPage::setup5) {
-    display.drawOnce_setupPage5(); 
-    currentPage = display.monitorInputs_setupPage5(); 
-  }
-  else if(currentPage == DisplayPage::setup6) {
-    display.drawOnce_setupPage6(); 
-    currentPage = display.monitorInputs_setupPage6(); 
-  }
-  else if(currentPage == DisplayPage::setup7) {
-    display.drawOnce_setupPage7(); 
-    currentPage = display.monitorInputs_setupPage7(); 
-  }
-  else if(currentPage == DisplayPage::setup8) {
-    display.drawOnce_setupPage8(); 
-    currentPage = display.monitorInputs_setupPage8(); 
-  }
-  else if(currentPage == DisplayPage::results) {
-    display.drawOnce_resultsPage(firstPosition, secondPosition, thirdPosition, attemptsCounter, startTimeMs); 
-    currentPage = display.monitorInputs_resultsPage(); 
-  }
-  else if(currentPage == DisplayPage::error) {
-    display.drawOnce_errorPage(); 
-    currentPage = display.monitorInputs_errorPage(); 
-  }
-}
-
-
+
+#include <Arduino.h>
+#include <EEPROM.h> 
+#include "ServoControl.h"
+#include "StepperControl.h"
+#ifdef HEADLESS
+  #include "HeadlessDisplay.h"
+#else
+  #include "StepRateTuner.h"
+  #include "Display.h" 
+#endif
+#include "Algorithm.h"  
+#include "StoredConfig.h"
+#include "BootTimer.h"
+#include "LoopRate.h"
+#include "Profiler.h"
+#include "FlightRecorder.h"
+#include "MemoryMonitor.h"
+#include "UiScheduler.h"
+#include "ChannelPins.h"
+#include "Telemetry.h"
+#ifdef REMOTE_CONTROL
+  #include "RemoteControl.h"
+#endif
+
+DisplayPage currentPage = DisplayPage::home;
+
+//one of each per channel (see ChannelPins.h), the position variables are assigned proper values when the program starts
+char firstPositions[NUMBER_OF_CHANNELS];
+char secondPositions[NUMBER_OF_CHANNELS]; 
+char thirdPositions[NUMBER_OF_CHANNELS]; 
+unsigned int attemptsCounters[NUMBER_OF_CHANNELS]; 
+AlgorithmState channelStates[NUMBER_OF_CHANNELS]; 
+
+StepperControl stepperControls[NUMBER_OF_CHANNELS]; 
+ServoControl servoControls[NUMBER_OF_CHANNELS]; 
+Algorithm algorithms[NUMBER_OF_CHANNELS]; 
+
+//channel 0 is the one that the setup pages and the single lock pages use
+char& firstPosition = firstPositions[0];
+char& secondPosition = secondPositions[0]; 
+char& thirdPosition = thirdPositions[0]; 
+unsigned int& attemptsCounter = attemptsCounters[0]; 
+StepperControl& stepperControl = stepperControls[0]; 
+ServoControl& servoControl = servoControls[0]; 
+Algorithm& algorithm = algorithms[0];   
+
+unsigned int expectedAttempts = 0; 
+unsigned char searchPass = 0; 
+unsigned long startTimeMs = 0;   
+bool isPaused = false;   //the algorithms aren't run (see RemoteControl.h), the motors keep holding the dial and the shackle
+#ifdef INDEX_SENSOR
+bool isMeasuringIndex = false;   //setup page 8 turns the dial one step per pass until the index position has been measured
+#endif
+
+#ifdef HEADLESS
+HeadlessDisplay display; 
+#else
+StepRateTuner stepRateTuner; 
+Display display; 
+#endif
+BootTimer bootTimer; 
+LoopRate loopRate; 
+Profiler profiler; 
+FlightRecorder flightRecorder; 
+MemoryMonitor memoryMonitor; 
+UiScheduler uiScheduler; 
+Telemetry telemetry; 
+#ifdef REMOTE_CONTROL
+RemoteControl remoteControl; 
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief   (Re)initializations that need to be done before a new run, when 
+ *          leaving the home page. 
+ */
+/*****************************************************************************/
+void resetRun() {
+  for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+    servoControls[i].reconfig(); 
+    stepperControls[i].reconfig(); 
+    algorithms[i].reconfig();  
+    firstPositions[i] = NO_POSITION_ASSIGNED;  
+    secondPositions[i] = NO_POSITION_ASSIGNED;   
+    thirdPositions[i] = NO_POSITION_ASSIGNED; 
+    attemptsCounters[i] = 0; 
+    channelStates[i] = AlgorithmState::running; 
+  }
+  isPaused = false; 
+  display.reconfig();  
+}
+
+/*****************************************************************************/
+/**
+ * @brief   (Re)initializations that need to be done right before the 
+ *          program (re)starts running. 
+ * @returns Returns the page that runs the program. 
+ */
+/*****************************************************************************/
+DisplayPage startRun() {
+  startTimeMs = millis(); 
+  uiScheduler.reset(); 
+  for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+    stepperControls[i].enableStepperMotor();   
+  }
+#if NUMBER_OF_CHANNELS > 1
+  return DisplayPage::channels; 
+#else
+  return DisplayPage::runProgram3; 
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Runs the algorithm of every channel that is still running, and 
+ *          updates the channels page. Each call moves each running channel 
+ *          by (at most) one step, so the locks are opened in parallel. 
+ * @returns Returns the updated enumeration for the current page. 
+ */
+/*****************************************************************************/
+DisplayPage runChannels() {
+  for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+    if(channelStates[i] == AlgorithmState::running && !isPaused) {
+      channelStates[i] = algorithms[i].run(&attemptsCounters[i]); 
+      if(channelStates[i] != AlgorithmState::running) {
+        telemetry.sendRunEnd(i, (uint8_t)channelStates[i], attemptsCounters[i]); 
+        stepperControls[i].disableStepperMotor();   //the other channels keep going
+      }
+    }
+  }
+  display.drawOnce_channelsPage(); 
+  bool isDialMoving = false; 
+  for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+    if(channelStates[i] == AlgorithmState::running && !algorithms[i].isDwelling() && !isPaused) {
+      isDialMoving = true; 
+    }
+  }
+  if(!uiScheduler.isWindowOpen(isDialMoving)) {   //the rows are redrawn and the touch screen is read while no dial is moving
+    return DisplayPage::channels; 
+  }
+  for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+    display.drawOnce_updatedChannel(i, firstPositions[i], secondPositions[i], thirdPositions[i], attemptsCounters[i], algorithms[i].getPlannedAttempts(), channelStates[i]); 
+  }
+  return display.monitorInputs_channelsPage(); 
+}
+
+#ifndef HEADLESS
+/*****************************************************************************/
+/**
+ * @brief   Ends the step rate trials: the tuned period is used by every 
+ *          channel and saved to the EEPROM (step rate page 4 shows it). 
+ */
+/*****************************************************************************/
+void finishStepRateTuning() {
+  stepperControl.disableStepperMotor(); 
+  for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+    stepperControls[i].setStepPeriod(stepRateTuner.getTunedPeriod());   //the rate is tuned on channel 0, and used for all of them
+  }
+  stepperControl.saveStepPeriod(); 
+}
+#endif
+
+#ifdef REMOTE_CONTROL
+/*****************************************************************************/
+/**
+ * @brief   Checks if a run has been started, and a lock is still being 
+ *          opened. 
+ */
+/*****************************************************************************/
+bool isRunning() {
+  if(currentPage == DisplayPage::runProgram3) {
+    return true; 
+  }
+  if(currentPage == DisplayPage::channels) {
+    for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+      if(channelStates[i] == AlgorithmState::running) {
+        return true; 
+      }
+    }
+  }
+  return false; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Checks if a run has been started, including one that has ended 
+ *          and whose results are still shown. 
+ */
+/*****************************************************************************/
+bool hasRunStarted() {
+  return currentPage == DisplayPage::runProgram3 || currentPage == DisplayPage::channels 
+      || currentPage == DisplayPage::results || currentPage == DisplayPage::error; 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Answers the status command with a channel's state, progress and 
+ *          combination, for example: 
+ *          status ch=0 running attempts=12/1000 combination=4-18--1 
+ * @note    The positions that haven't been assigned yet are -1. The reply 
+ *          has to fit in REMOTE_REPLY_SIZE. 
+ * @param   channel The channel. 
+ */
+/*****************************************************************************/
+void replyRemoteStatus(unsigned char channel) {
+  remoteControl.beginReply(F("status ch=")); 
+  remoteControl.addNumber(channel); 
+  if(!hasRunStarted()) {
+    remoteControl.addText(F(" idle")); 
+  }
+  else if(channelStates[channel] == AlgorithmState::complete) {
+    remoteControl.addText(F(" opened")); 
+  }
+  else if(channelStates[channel] == AlgorithmState::error) {
+    remoteControl.addText(F(" failed")); 
+  }
+  else if(isPaused) {
+    remoteControl.addText(F(" paused")); 
+  }
+  else {
+    remoteControl.addText(F(" running")); 
+  }
+  remoteControl.addText(F(" attempts=")); 
+  remoteControl.addNumber(attemptsCounters[channel]); 
+  remoteControl.addText(F("/")); 
+  remoteControl.addNumber(algorithms[channel].getPlannedAttempts()); 
+  remoteControl.addText(F(" combination=")); 
+  remoteControl.addNumber(firstPositions[channel]); 
+  remoteControl.addText(F("-")); 
+  remoteControl.addNumber(secondPositions[channel]); 
+  remoteControl.addText(F("-")); 
+  remoteControl.addNumber(thirdPositions[channel]); 
+}
+
+/*****************************************************************************/
+/**
+ * @brief   Carries out a command received over the serial port (see 
+ *          RemoteControl.h), and answers it. The commands do the same as 
+ *          the buttons on the pages. 
+ * @param   command The command. 
+ * @returns Returns the updated enumeration for the current page. 
+ */
+/*****************************************************************************/
+DisplayPage handleRemoteCommand(const RemoteCommand& command) {
+  long firstArgument = command.argumentCount > 0 ? command.arguments[0] : 0; 
+  long secondArgument = command.argumentCount > 1 ? command.arguments[1] : 0; 
+  switch(command.type) {
+    case RemoteCommandType::start: 
+      if(isRunning()) {
+        remoteControl.beginReply(F("err busy")); 
+        return currentPage; 
+      }
+      if(firstArgument < NO_LOCK_PROFILE || firstArgument > NUMBER_OF_LOCK_PROFILES || secondArgument < NO_LOCK_ID || secondArgument > MAX_LOCK_ID) {
+        remoteControl.beginReply(F("err bad argument")); 
+        return currentPage; 
+      }
+      EEPROM.update(LOCK_PROFILE_EEPROM_ADDRESS, firstArgument);   //only writes to eeprom if the value is different
+      EEPROM.update(LOCK_ID_EEPROM_ADDRESS, secondArgument); 
+      resetRun(); 
+      for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+        servoControls[i].moveBottomPosition();    
+        algorithms[i].loadLockProfile(); 
+      }
+      algorithm.loadLockId(); 
+      remoteControl.beginReply(F("ok")); 
+      return startRun(); 
+
+    case RemoteCommandType::stop: 
+      for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+        stepperControls[i].disableStepperMotor(); 
+      }
+      isPaused = false; 
+      remoteControl.beginReply(F("ok")); 
+      return DisplayPage::home; 
+
+    case RemoteCommandType::pause: 
+    case RemoteCommandType::resume: 
+      if(!isRunning()) {
+        remoteControl.beginReply(F("err not running")); 
+        return currentPage; 
+      }
+      isPaused = (command.type == RemoteCommandType::pause); 
+      remoteControl.beginReply(F("ok")); 
+      return currentPage; 
+
+    case RemoteCommandType::seek: 
+      if(!isRunning()) {
+        remoteControl.beginReply(F("err not running")); 
+        return currentPage; 
+      }
+      if(command.argumentCount == 0 || secondArgument < 0 || secondArgument >= NUMBER_OF_CHANNELS 
+         || channelStates[secondArgument] != AlgorithmState::running || firstArgument <= attemptsCounters[secondArgument]
+         || firstArgument > algorithms[secondArgument].getPlannedAttempts()) {
+        remoteControl.beginReply(F("err bad argument"));   //the search can only be moved forward, and not past its last attempt (the skipped combinations aren't dialed)
+        return currentPage; 
+      }
+      algorithms[secondArgument].seekAttempt(firstArgument); 
+      remoteControl.beginReply(F("ok")); 
+      return currentPage; 
+
+    case RemoteCommandType::zone: 
+      if(isRunning()) {
+        remoteControl.beginReply(F("err busy")); 
+        return currentPage; 
+      }
+      if(command.argumentCount == 0 || firstArgument < 0 || firstArgument > 5) {
+        remoteControl.beginReply(F("err bad argument")); 
+        return currentPage; 
+      }
+      firstArgument += CENTER_OFFSET; 
+      if(firstArgument >= ZONE_OFFSET) firstArgument -= ZONE_OFFSET;   //same as the buttons on setup page 3
+      EEPROM.update(FIRST_ZONE_EEPROM_ADDRESS, firstArgument); 
+      remoteControl.beginReply(F("ok")); 
+      return currentPage; 
+
+    case RemoteCommandType::servo: 
+      if(isRunning()) {
+        remoteControl.beginReply(F("err busy")); 
+        return currentPage; 
+      }
+      if(command.argumentCount == 0 || firstArgument > SERVO_BOTTOM_LIMIT || firstArgument - DISTANCE_BETWEEN_TOP_AND_BOTTOM_POSITIONS < SERVO_TOP_LIMIT) {
+        remoteControl.beginReply(F("err bad argument")); 
+        return currentPage; 
+      }
+      EEPROM.update(SERVO_BOTTOM_POSITION_EEPROM_ADDRESS, firstArgument); 
+      for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+        servoControls[i].reconfig(); 
+        servoControls[i].moveBottomPosition(); 
+      }
+      remoteControl.beginReply(F("ok")); 
+      return currentPage; 
+
+    case RemoteCommandType::status: 
+      if(firstArgument < 0 || firstArgument >= NUMBER_OF_CHANNELS) {
+        remoteControl.beginReply(F("err bad argument")); 
+        return currentPage; 
+      }
+      replyRemoteStatus(firstArgument); 
+      return currentPage; 
+
+    case RemoteCommandType::profile: 
+#ifdef PROFILER_ENABLED
+      profiler.print(); 
+      remoteControl.beginReply(F("ok")); 
+#else
+      remoteControl.beginReply(F("err profiler not enabled")); 
+#endif
+      return currentPage; 
+
+    case RemoteCommandType::flight: 
+#ifdef FLIGHT_RECORDER
+      if(firstArgument == 1) {
+        remoteControl.beginReply(flightRecorder.printSaved() ? F("ok") : F("err nothing saved")); 
+      }
+      else if(firstArgument == 0) {
+        flightRecorder.print(); 
+        remoteControl.beginReply(F("ok")); 
+      }
+      else {
+        remoteControl.beginReply(F("err bad argument")); 
+      }
+#else
+      remoteControl.beginReply(F("err flight recorder not enabled")); 
+#endif
+      return currentPage; 
+
+    case RemoteCommandType::memory: 
+#ifdef MEMORY_MONITOR
+      memoryMonitor.print(); 
+      remoteControl.beginReply(F("ok")); 
+#else
+      remoteControl.beginReply(F("err memory monitor not enabled")); 
+#endif
+      return currentPage; 
+
+    default: 
+      return currentPage; 
+  }
+}
+#endif
+
+#ifndef HEADLESS
+/*****************************************************************************/
+/**
+ * @brief   Checks, when building, if a channel's step or servo pin (which 
+ *          are written by interrupts) is on a port that the LCD uses (see 
+ *          ChannelPins.h). 
+ * @param   channel The channel, the channels that aren't built pass. 
+ */
+/*****************************************************************************/
+constexpr bool isChannelOnLcdPort(unsigned char channel) {
+  return channel < NUMBER_OF_CHANNELS 
+      && (Display::isOnLcdPort(channelPinTable[channel].step) || Display::isOnLcdPort(channelPinTable[channel].servoSignal)); 
+}
+static_assert(!isChannelOnLcdPort(0), "Channel 0's step or servo pin is on a port that the LCD uses, change it in StepperControl.h or ServoControl.h"); 
+static_assert(!isChannelOnLcdPort(1), "Channel 1's step or servo pin is on a port that the LCD uses, change it in ChannelPins.h"); 
+static_assert(!isChannelOnLcdPort(2), "Channel 2's step or servo pin is on a port that the LCD uses, change it in ChannelPins.h"); 
+#endif
+
+//the actuators are made safe first, the display is brought up afterwards in loop() (see Display::bringUp())
+void setup() {
+  StoredConfig storedConfig; 
+  loadStoredConfig(&storedConfig);   //one EEPROM read for all the saved settings
+  bootTimer.mark(BootStage::config); 
+  ChannelPins pins[NUMBER_OF_CHANNELS]; 
+  for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+    getChannelPins(i, &pins[i]); 
+    servoControls[i].init(pins[i].servoSignal, storedConfig.servoBottomPosition);   //holds the servo at the bottom position from the first pulse (the channels share the calibration)
+  }
+  bootTimer.mark(BootStage::servo); 
+  for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+    stepperControls[i].init(i); 
+  }
+  bootTimer.mark(BootStage::stepper); 
+  for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+    algorithms[i].init(i, &stepperControls[i], &servoControls[i], pins[i].limitSwitch, &firstPositions[i], &secondPositions[i], &thirdPositions[i]); 
+  }
+  bootTimer.mark(BootStage::algorithm); 
+  telemetry.init(); 
+  profiler.init(); 
+  flightRecorder.init(); 
+  memoryMonitor.init(); 
+#ifdef REMOTE_CONTROL
+  remoteControl.init(); 
+#endif
+  display.init();  
+  bootTimer.mark(BootStage::touch); 
+}
+
+void loop() {
+  PROFILE_SCOPE(ProfileSection::loop); 
+  loopRate.update(); 
+  telemetry.update();   //hands the buffered frames to the serial port, without waiting for it
+  flightRecorder.update();   //writes the next byte of a saved flight log, without waiting for the EEPROM
+  if(!display.bringUp()) {
+    return;   //the LCD is still being initialized
+  }
+  bootTimer.mark(BootStage::display); 
+#ifdef REMOTE_CONTROL
+  RemoteCommand command; 
+  if(remoteControl.update(&command)) {
+    currentPage = handleRemoteCommand(command); 
+  }
+#endif
+
+  if(currentPage == DisplayPage::home) {
+    display.drawOnce_homePage(); 
+    bootTimer.mark(BootStage::interactive); 
+    for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+      stepperControls[i].disableStepperMotor(); 
+    }
+    currentPage = display.monitorInputs_homePage(); 
+    if(currentPage == DisplayPage::runProgram1) {
+      resetRun(); 
+    }
+  }
+  else if(currentPage == DisplayPage::channels) {
+    currentPage = runChannels(); 
+  }
+  else if(currentPage == DisplayPage::runProgram3) {
+    AlgorithmState state = isPaused ? AlgorithmState::running : algorithm.run(&attemptsCounter);   
+    channelStates[0] = state;   //for the status command (see RemoteControl.h)
+    if(state != AlgorithmState::running) {
+      telemetry.sendRunEnd(0, (uint8_t)state, attemptsCounter); 
+    }
+    if(state == AlgorithmState::complete) {
+      expectedAttempts = algorithm.getExpectedAttempts(); 
+      searchPass = algorithm.getSearchPass(); 
+      currentPage = DisplayPage::results; 
+    }
+    else if(state == AlgorithmState::error) {
+      currentPage = DisplayPage::error; 
+    }
+    else if(state == AlgorithmState::running) {
+      display.drawOnce_runProgramPage3();   //drawn on the first pass, before the dial starts moving
+      if(uiScheduler.isWindowOpen(!algorithm.isDwelling() && !isPaused)) {   //the combination and the progress are redrawn and the touch screen is read while the dial isn't moving
+        display.drawOnce_updatedCombination(firstPosition, secondPosition, thirdPosition);  
+        display.drawOnce_updatedProgress(attemptsCounter, algorithm.getPlannedAttempts(), algorithm.getEstimatedRemainingMs(attemptsCounter)); 
+        currentPage = display.monitorInputs_runProgramPage3();
+      }
+    }
+  }  
+#ifndef HEADLESS   //the pages that are only reached with the touch screen
+  else if(currentPage == DisplayPage::runProgram1) {
+    display.drawOnce_runProgramPage1();
+    currentPage = display.monitorInputs_runProgramPage1(); 
+    if(currentPage == DisplayPage::lockProfile) {      
+      for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+        servoControls[i].moveBottomPosition();    
+      }
+    } 
+  }  
+  else if(currentPage == DisplayPage::lockProfile) {
+    display.drawOnce_lockProfilePage();
+    currentPage = display.monitorInputs_lockProfilePage(); 
+    if(currentPage == DisplayPage::lockId) {      
+      for(unsigned char i = 0; i < NUMBER_OF_CHANNELS; i++) {
+        algorithms[i].loadLockProfile();   //the locks on the rig are assumed to be of the same model
+      }
+    } 
+  }  
+  else if(currentPage == DisplayPage::lockId) {
+    display.drawOnce_lockIdPage();
+    currentPage = display.monitorInputs_lockIdPage(); 
+    if(currentPage == DisplayPage::runProgram2) {      
+      algorithm.loadLockId();   //the lock ID (and the combination cache) is only used for channel 0's lock
+    } 
+  }  
+  else if(currentPage == DisplayPage::runProgram2) {
+    display.drawOnce_runProgramPage2();
+    currentPage = display.monitorInputs_runProgramPage2();  
+    if(currentPage == DisplayPage::runProgram3) {    
+      currentPage = startRun(); 
+    }
+  }  
+  else if(currentPage == DisplayPage::setup1) {
+    display.drawOnce_setupPage1(); 
+    currentPage = display.monitorInputs_setupPage1();
+    if(currentPage == DisplayPage::setup2) {
+      servoControl.reconfig(); 
+      servoControl.moveBottomPosition(); 
+    } 
+  }
+  else if(currentPage == DisplayPage::setup2) {
+    display.drawOnce_setupPage2(); 
+    currentPage = display.monitorInputs_setupPage2(); 
+  }
+  else if(currentPage == DisplayPage::setup3) {
+    display.drawOnce_setupPage3(); 
+    currentPage = display.monitorInputs_setupPage3(); 
+  }  
+  else if(currentPage == DisplayPage::setup4) {
+    display.drawOnce_setupPage4(); 
+    currentPage = display.monitorInputs_setupPage4(); 
+  }
+  else if(currentPage == DisplayPage::setup5) {
+    display.drawOnce_setupPage5(); 
+    currentPage = display.monitorInputs_setupPage5(); 
+  }
+  else if(currentPage == DisplayPage::setup6) {
+    display.drawOnce_setupPage6(); 
+    currentPage = display.monitorInputs_setupPage6(); 
+  }
+  else if(currentPage == DisplayPage::setup7) {
+    display.drawOnce_setupPage7(); 
+    currentPage = display.monitorInputs_setupPage7(); 
+#ifdef INDEX_SENSOR
+    if(currentPage == DisplayPage::setup8) {   //the dial has been turned to zero, which is where the index position is measured from
+      stepperControl.reconfig(); 
+      stepperControl.enableStepperMotor(); 
+      isMeasuringIndex = true; 
+    }
+#endif
+  }
+  else if(currentPage == DisplayPage::setup8) {
+    display.drawOnce_setupPage8(); 
+#ifdef INDEX_SENSOR
+    if(isMeasuringIndex) {   //the buttons are read once the turn is done
+      if(stepperControl.measureIndex() != StepperState::incomplete) {
+        stepperControl.disableStepperMotor(); 
+        isMeasuringIndex = false; 
+      }
+      return; 
+    }
+#endif
+    currentPage = display.monitorInputs_setupPage8(); 
+  }
+#ifdef DIAGNOSTICS_PAGE
+  else if(currentPage == DisplayPage::diagnostics) {
+    display.drawOnce_diagnosticsPage(); 
+    currentPage = display.monitorInputs_diagnosticsPage(); 
+  }
+#endif
+  else if(currentPage == DisplayPage::touchCalibration) {
+    display.drawOnce_touchCalibrationPage(); 
+    currentPage = display.monitorInputs_touchCalibrationPage(); 
+  }
+  else if(currentPage == DisplayPage::stepRate1) {
+    display.drawOnce_stepRatePage1(); 
+    currentPage = display.monitorInputs_stepRatePage1(); 
+    if(currentPage == DisplayPage::stepRate2) {
+      stepperControl.reconfig(); 
+      stepRateTuner.start(); 
+      stepperControl.enableStepperMotor(); 
+    }
+  }
+  else if(currentPage == DisplayPage::stepRate2) {
+    display.drawOnce_stepRatePage2(stepRateTuner.getTrialStepsPerSecond()); 
+    if(stepRateTuner.runTrial() == StepperState::complete) {
+      currentPage = DisplayPage::stepRate3; 
+#ifdef INDEX_SENSOR
+      if(stepRateTuner.isVerifiedByIndex()) {   //the index sensor checks the trial instead of the user
+        currentPage = stepRateTuner.recordResult(stepRateTuner.isTrialPassed()) ? DisplayPage::stepRate2 : DisplayPage::stepRate4; 
+        if(currentPage == DisplayPage::stepRate4) {
+          finishStepRateTuning(); 
+        }
+      }
+#endif
+    }
+  }
+  else if(currentPage == DisplayPage::stepRate3) {
+    display.drawOnce_stepRatePage3(); 
+    currentPage = display.monitorInputs_stepRatePage3(); 
+    if(currentPage != DisplayPage::stepRate3 && !stepRateTuner.recordResult(currentPage == DisplayPage::stepRate2)) {
+      currentPage = DisplayPage::stepRate4;   //a trial failed, or the fastest one passed
+    }
+    if(currentPage == DisplayPage::stepRate4) {
+      finishStepRateTuning(); 
+    }
+  }
+  else if(currentPage == DisplayPage::stepRate4) {
+    display.drawOnce_stepRatePage4(1000000UL / stepperControl.getStepPeriod(), stepRateTuner.isTuned()); 
+    currentPage = display.monitorInputs_stepRatePage4(); 
+  }
+#endif
+  else if(currentPage == DisplayPage::results) {
+    display.drawOnce_resultsPage(firstPosition, secondPosition, thirdPosition, attemptsCounter, startTimeMs, expectedAttempts, searchPass); 
+    currentPage = display.monitorInputs_resultsPage(); 
+  }
+  else if(currentPage == DisplayPage::error) {
+    display.drawOnce_errorPage(); 
+    currentPage = display.monitorInputs_errorPage(); 
+  }
+}
+
+
@@ -0,0 +1,21 @@
+#ifndef ARDUINO_STAND_IN_H
+#define ARDUINO_STAND_IN_H
+
+//the parts of the Arduino core that the libraries tested on the computer use (see the native env in platformio.ini)
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#define LOW 0x0
+#define HIGH 0x1
+
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#endif
@@ -0,0 +1,145 @@
+//unit tests for the dial model (see lib/DialModel/DialModel.h), run on the computer with: pio test -e native
+#include <unity.h>
+#include "DialModel.cpp"
+
+DialModel model;
+
+//sets the model up as if the combination had been dialed with the full sequence
+void dial(DialModel& dialModel, char firstPos, char secondPos, char thirdPos) {
+    dialModel.reset();
+    dialModel.rotateFullSequence(firstPos, secondPos, thirdPos);
+}
+
+//runs a planned maneuver on a copy of the model, and checks that it leaves the wheels where the full sequence would
+void checkManeuver(DialModel& dialModel, char firstPos, char secondPos, char thirdPos, DialManeuver& maneuver) {
+    DialModel maneuvered = dialModel;
+    DialModel reset = dialModel;
+    int fullResetSteps = reset.rotateFullSequence(firstPos, secondPos, thirdPos);
+    for(unsigned char i = 0; i < maneuver.numberOfMoves; i++) {
+        maneuvered.rotate(maneuver.moves[i].direction, maneuver.moves[i].steps);
+    }
+    TEST_ASSERT_TRUE(maneuvered.isSetLike(reset));
+    TEST_ASSERT_LESS_THAN(fullResetSteps, maneuver.totalSteps);
+}
+
+void setUp() {
+    model.reset();
+}
+
+void tearDown() {
+}
+
+void test_unsynchronized_model_plans_nothing() {
+    DialManeuver maneuver;
+    TEST_ASSERT_FALSE(model.isSynchronized());
+    TEST_ASSERT_FALSE(model.planManeuver(10, 20, 30, &maneuver));
+}
+
+void test_full_sequence_synchronizes() {
+    dial(model, 10, 20, 30);
+    TEST_ASSERT_TRUE(model.isSynchronized());
+}
+
+void test_third_position_change_moves_only_the_cam() {
+    DialManeuver maneuver;
+    dial(model, 10, 20, 30);
+    TEST_ASSERT_TRUE(model.planManeuver(10, 20, 35, &maneuver));
+    TEST_ASSERT_EQUAL(1, maneuver.numberOfMoves);
+    TEST_ASSERT_EQUAL(StepperDirection::clockwise, maneuver.moves[0].direction);
+    TEST_ASSERT_EQUAL(DialModel::positionToStep(35) - DialModel::positionToStep(30), maneuver.totalSteps);
+    checkManeuver(model, 10, 20, 35, maneuver);
+}
+
+void test_counterclockwise_cam_move_takes_up_the_backlash() {
+    DialManeuver maneuver;
+    dial(model, 10, 20, 30);
+    TEST_ASSERT_TRUE(model.planManeuver(10, 20, 25, &maneuver));
+    TEST_ASSERT_EQUAL(1, maneuver.numberOfMoves);
+    TEST_ASSERT_EQUAL(StepperDirection::counterclockwise, maneuver.moves[0].direction);
+    TEST_ASSERT_EQUAL(DialModel::positionToStep(30) - DialModel::positionToStep(25) + COUPLING_BACKLASH_STEPS, maneuver.totalSteps);
+    checkManeuver(model, 10, 20, 25, maneuver);
+}
+
+void test_cam_goes_around_instead_of_pushing_the_second_wheel() {
+    DialManeuver maneuver;
+    dial(model, 10, 20, 30);
+    TEST_ASSERT_TRUE(model.planManeuver(10, 20, 15, &maneuver));   //counterclockwise, the cam would push the second wheel off 20
+    TEST_ASSERT_EQUAL(1, maneuver.numberOfMoves);
+    TEST_ASSERT_EQUAL(StepperDirection::clockwise, maneuver.moves[0].direction);
+    checkManeuver(model, 10, 20, 15, maneuver);
+}
+
+void test_second_position_change_repicks_the_wheel() {
+    DialManeuver maneuver;
+    dial(model, 10, 20, 30);
+    TEST_ASSERT_TRUE(model.planManeuver(10, 15, 30, &maneuver));
+    TEST_ASSERT_EQUAL(2, maneuver.numberOfMoves);
+    TEST_ASSERT_EQUAL(StepperDirection::counterclockwise, maneuver.moves[0].direction);
+    checkManeuver(model, 10, 15, 30, maneuver);
+}
+
+void test_clockwise_repick() {
+    DialManeuver maneuver;
+    dial(model, 10, 20, 30);
+    TEST_ASSERT_TRUE(model.planManeuver(10, 25, 35, &maneuver));
+    TEST_ASSERT_EQUAL(StepperDirection::clockwise, maneuver.moves[0].direction);
+    checkManeuver(model, 10, 25, 35, maneuver);
+}
+
+void test_first_position_change_needs_a_reset() {
+    DialManeuver maneuver;
+    dial(model, 10, 20, 30);
+    TEST_ASSERT_FALSE(model.planManeuver(11, 20, 30, &maneuver));
+}
+
+void test_maneuvers_after_maneuvers() {
+    //the slack left behind by a maneuver (not the full sequence) has to be accounted for by the next one
+    DialManeuver maneuver;
+    dial(model, 10, 20, 30);
+    const char secondPositions[] = {15, 25, 22, 40, 18, 21};
+    for(unsigned char i = 0; i < sizeof(secondPositions); i++) {
+        char thirdPos = (secondPositions[i] + 7) % NUMBER_OF_POSITIONS;
+        if(model.planManeuver(10, secondPositions[i], thirdPos, &maneuver)) {
+            checkManeuver(model, 10, secondPositions[i], thirdPos, maneuver);
+            for(unsigned char j = 0; j < maneuver.numberOfMoves; j++) {
+                model.rotate(maneuver.moves[j].direction, maneuver.moves[j].steps);
+            }
+        }
+        else {
+            model.rotateFullSequence(10, secondPositions[i], thirdPos);
+        }
+    }
+}
+
+void test_every_planned_maneuver_matches_the_full_sequence() {
+    DialManeuver maneuver;
+    const char firstPos = 10;
+    for(char secondPos = 0; secondPos < NUMBER_OF_POSITIONS; secondPos += 3) {
+        for(char thirdPos = 0; thirdPos < NUMBER_OF_POSITIONS; thirdPos += 3) {
+            DialModel start;
+            dial(start, firstPos, secondPos, thirdPos);
+            for(char nextSecondPos = 0; nextSecondPos < NUMBER_OF_POSITIONS; nextSecondPos++) {
+                for(char nextThirdPos = 0; nextThirdPos < NUMBER_OF_POSITIONS; nextThirdPos++) {
+                    if(start.planManeuver(firstPos, nextSecondPos, nextThirdPos, &maneuver)) {
+                        checkManeuver(start, firstPos, nextSecondPos, nextThirdPos, maneuver);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_unsynchronized_model_plans_nothing);
+    RUN_TEST(test_full_sequence_synchronizes);
+    RUN_TEST(test_third_position_change_moves_only_the_cam);
+    RUN_TEST(test_counterclockwise_cam_move_takes_up_the_backlash);
+    RUN_TEST(test_cam_goes_around_instead_of_pushing_the_second_wheel);
+    RUN_TEST(test_second_position_change_repicks_the_wheel);
+    RUN_TEST(test_clockwise_repick);
+    RUN_TEST(test_first_position_change_needs_a_reset);
+    RUN_TEST(test_maneuvers_after_maneuvers);
+    RUN_TEST(test_every_planned_maneuver_matches_the_full_sequence);
+    return UNITY_END();
+}
@@ -0,0 +1,144 @@
+"""Pre-renders the digits 0-9 of an Adafruit GFX font into run-length encoded
+1-bpp bitmaps (DigitGlyphs.h), so the live combination readout can be blitted
+with one address window per digit instead of being rasterized pixel by pixel.
+
+Used as a PlatformIO pre-script (extra_scripts = pre:tools/generate_digit_glyphs.py).
+The font header is read from the Adafruit GFX library in the environment's
+libdeps folder, and DigitGlyphs.h is written to <build dir>/generated, which is
+added to the include path.
+
+Can also be run by hand:
+    python tools/generate_digit_glyphs.py path/to/FreeSans18pt7b.h path/to/DigitGlyphs.h
+"""
+
+import os
+import sys
+
+try:
+    Import("env")   # noqa: F821 (provided by PlatformIO/SCons)
+except NameError:
+    env = None
+
+# SCons runs this file with exec(), so __file__ isn't defined there
+sys.path.insert(0, os.path.join(env.subst("$PROJECT_DIR"), "tools") if env is not None else os.path.dirname(os.path.abspath(__file__)))
+from gfxfont import find_font, parse_font, write_if_changed  # noqa: E402
+
+FONT_NAME = "FreeSans18pt7b"
+OUTPUT_NAME = "DigitGlyphs.h"
+MAX_RUN = 255   # runs are stored in one byte, longer runs are split with a zero-length run of the other color
+
+
+def glyph_pixels(bitmaps, glyph):
+    offset, width, height, _, _, _ = glyph
+    pixels = []
+    for i in range(width * height):
+        byte = bitmaps[offset + i // 8]
+        pixels.append((byte >> (7 - i % 8)) & 1)
+    return [pixels[row * width:(row + 1) * width] for row in range(height)]
+
+
+def render_digits(font):
+    digits = [font.glyph(str(d)) for d in range(10)]
+    advance = max(g[3] for g in digits)
+    top = min(g[5] for g in digits)                # most negative yOffset (rows above the baseline)
+    bottom = max(g[5] + g[2] for g in digits)
+    height = bottom - top
+
+    cells = []
+    for glyph in digits:
+        cell = [[0] * advance for _ in range(height)]
+        _, width, glyph_height, _, x_offset, y_offset = glyph
+        for row, line in enumerate(glyph_pixels(font.bitmaps, glyph)):
+            for column, pixel in enumerate(line):
+                x = x_offset + column
+                if pixel and 0 <= x < advance:   # the few pixels outside the advance width would overlap the next digit
+                    cell[y_offset - top + row][x] = 1
+        cells.append(cell)
+    return cells, advance, height, -top
+
+
+def encode_runs(cell):
+    pixels = [p for row in cell for p in row]
+    runs = []
+    color = 0
+    length = 0
+    for pixel in pixels:
+        if pixel != color:
+            runs.append(length)
+            color = pixel
+            length = 0
+        length += 1
+    runs.append(length)
+
+    encoded = []
+    for run in runs:
+        while run > MAX_RUN:
+            encoded += [MAX_RUN, 0]
+            run -= MAX_RUN
+        encoded.append(run)
+    return encoded
+
+
+def decode_runs(encoded, size):
+    pixels = []
+    color = 0
+    for run in encoded:
+        pixels += [color] * run
+        color ^= 1
+    assert len(pixels) == size
+    return pixels
+
+
+def generate(font_path, output_path):
+    cells, width, height, baseline = render_digits(parse_font(font_path))
+
+    runs = []
+    offsets = []
+    for cell in cells:
+        offsets.append(len(runs))
+        encoded = encode_runs(cell)
+        assert decode_runs(encoded, width * height) == [p for row in cell for p in row]
+        runs += encoded
+    offsets.append(len(runs))
+
+    lines = [
+        "//Generated by tools/generate_digit_glyphs.py from %s. Do not edit." % os.path.basename(font_path),
+        "",
+        "#ifndef DIGIT_GLYPHS_H",
+        "#define DIGIT_GLYPHS_H",
+        "",
+        "#include <avr/pgmspace.h>",
+        "",
+        "#define DIGIT_GLYPH_WIDTH %d      //same as the font's x advance, so two digits are drawn side by side" % width,
+        "#define DIGIT_GLYPH_HEIGHT %d" % height,
+        "#define DIGIT_GLYPH_BASELINE %d   //rows above the baseline (the GFX cursor's y coordinate)" % baseline,
+        "",
+        "//run lengths for each digit, row by row, alternating background and foreground (starting with background)",
+        "const uint8_t digitGlyphRuns[] PROGMEM = {",
+    ]
+    for i in range(0, len(runs), 16):
+        lines.append("    " + ", ".join("%d" % r for r in runs[i:i + 16]) + ",")
+    lines += [
+        "};",
+        "",
+        "//index of each digit's first run in digitGlyphRuns (the last entry is the end of digit 9)",
+        "const uint16_t digitGlyphOffsets[11] PROGMEM = {" + ", ".join(str(o) for o in offsets) + "};",
+        "",
+        "#endif",
+        "",
+    ]
+    content = "\n".join(lines)
+
+    if write_if_changed(output_path, content):
+        print("Generated %s (%d bytes of runs)" % (output_path, len(runs)))
+
+
+if env is not None:
+    generated_dir = os.path.join(env.subst("$BUILD_DIR"), "generated")
+    generate(find_font(env.subst("$PROJECT_LIBDEPS_DIR/$PIOENV"), FONT_NAME), os.path.join(generated_dir, OUTPUT_NAME))
+    env.Append(CPPPATH=[generated_dir])
+elif __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    generate(sys.argv[1], sys.argv[2])
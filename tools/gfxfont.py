@@ -0,0 +1,112 @@
+"""Helpers shared by the build scripts that read and write Adafruit GFX font
+headers (the Fonts/*.h files of the Adafruit GFX library).
+"""
+
+import glob
+import os
+import re
+import sys
+
+
+class GfxFont(object):
+    """The contents of one font header: the packed 1-bpp bitmaps, one
+    (bitmapOffset, width, height, xAdvance, xOffset, yOffset) tuple per glyph,
+    and the first/last character and line height of the GFXfont struct."""
+
+    def __init__(self, name, bitmaps, glyphs, first, last, y_advance):
+        self.name = name
+        self.bitmaps = bitmaps
+        self.glyphs = glyphs
+        self.first = first
+        self.last = last
+        self.y_advance = y_advance
+
+    def glyph(self, char):
+        return self.glyphs[ord(char) - self.first]
+
+    def glyph_bytes(self, glyph):
+        return (glyph[1] * glyph[2] + 7) // 8
+
+    def flash_size(self):
+        """Bytes the font takes in flash (bitmaps + 7-byte glyphs + 9-byte GFXfont on the AVR)."""
+        return len(self.bitmaps) + 7 * len(self.glyphs) + 9
+
+
+def parse_font(path):
+    with open(path) as f:
+        text = f.read()
+
+    bitmaps_block = re.search(r"Bitmaps\[\]\s*PROGMEM\s*=\s*\{(.*?)\};", text, re.S)
+    glyphs_block = re.search(r"Glyphs\[\]\s*PROGMEM\s*=\s*\{(.*?)\};", text, re.S)
+    font_block = re.search(r"GFXfont\s+(\w+)\s*PROGMEM\s*=\s*\{(.*?)\};", text, re.S)
+    if not (bitmaps_block and glyphs_block and font_block):
+        raise ValueError("%s doesn't look like an Adafruit GFX font" % path)
+
+    bitmaps = [int(x, 16) for x in re.findall(r"0x[0-9A-Fa-f]+", bitmaps_block.group(1))]
+    glyph_body = re.sub(r"//[^\n]*", "", glyphs_block.group(1))
+    glyphs = [tuple(int(v) for v in g.split(","))
+              for g in re.findall(r"\{\s*(-?\d+\s*(?:,\s*-?\d+\s*){5})\}", glyph_body)]
+    font_numbers = re.findall(r"0x[0-9A-Fa-f]+|\b\d+\b", re.sub(r"\([^)]*\)\s*\w+", "", font_block.group(2)))
+    first, last, y_advance = (int(n, 0) for n in font_numbers[:3])
+    if len(glyphs) != last - first + 1:
+        raise ValueError("%s has %d glyphs for characters 0x%02X to 0x%02X" % (path, len(glyphs), first, last))
+    return GfxFont(font_block.group(1), bitmaps, glyphs, first, last, y_advance)
+
+
+def text_bounds(font, text, x=0, y=0, screen_width=320, screen_height=240):
+    """Same as Adafruit_GFX::getTextBounds() (library version 1.5.3) for a custom font at text size 1,
+    on a screen rotated to landscape. Returns (x1, y1, w, h)."""
+    bounds_x, bounds_y, bounds_w, bounds_h = x, y, 0, 0
+    min_x, min_y = screen_width, screen_height
+    max_x = max_y = -1
+    for char in text:
+        code = ord(char)
+        if char == "\n":
+            x = 0
+            y += font.y_advance
+        elif char != "\r" and font.first <= code <= font.last:
+            _, width, height, x_advance, x_offset, y_offset = font.glyphs[code - font.first]
+            if x + x_offset + width > screen_width:   # text wrapping
+                x = 0
+                y += font.y_advance
+            x1 = x + x_offset
+            y1 = y + y_offset
+            min_x = min(min_x, x1)
+            min_y = min(min_y, y1)
+            max_x = max(max_x, x1 + width - 1)
+            max_y = max(max_y, y1 + height - 1)
+            x += x_advance
+    if max_x >= min_x:
+        bounds_x, bounds_w = min_x, max_x - min_x + 1
+    if max_y >= min_y:
+        bounds_y, bounds_h = min_y, max_y - min_y + 1
+    return bounds_x, bounds_y, bounds_w, bounds_h
+
+
+def parse_string_table(path):
+    """Returns the (id, font name, text) entries of the UI_STRING_LIST in UiStrings.h, in order."""
+    with open(path) as f:
+        text = f.read()
+    literal = r'"(?:[^"\\\n]|\\.)*"'
+    return [(string_id, font, bytes(string[1:-1], "utf-8").decode("unicode_escape"))
+            for string_id, font, string in re.findall(r"X\(\s*(\w+)\s*,\s*(\w+)\s*,\s*(" + literal + r")\s*\)", text)]
+
+
+def find_font(libdeps_dir, font_name):
+    matches = glob.glob(os.path.join(libdeps_dir, "**", "Fonts", font_name + ".h"), recursive=True)
+    if not matches:
+        sys.stderr.write("Error: %s.h not found in %s (is the Adafruit GFX library installed?)\n" % (font_name, libdeps_dir))
+        sys.exit(1)
+    return matches[0]
+
+
+def write_if_changed(path, content):
+    """Returns True if the file was written. An unchanged file is left alone so the sources including it aren't rebuilt."""
+    if os.path.isfile(path):
+        with open(path) as f:
+            if f.read() == content:
+                return False
+    os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+    with open(path, "w") as f:
+        f.write(content)
+    return True
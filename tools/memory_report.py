@@ -0,0 +1,117 @@
+"""Splits the SRAM that the global and static variables use (.data and .bss)
+by module, from the files of a PlatformIO build.
+
+Every object file and library archive in the build directory is listed with
+avr-nm to find which module defines each variable, and the sizes come from
+firmware.elf (avr-nm -S). Build with -D MEMORY_MONITOR to see the totals, the
+stack's high-water mark and the smallest free SRAM on the board itself (see
+lib/MemoryMonitor/MemoryMonitor.h).
+
+    python tools/memory_report.py .pio/build/Custom_Board
+    python tools/memory_report.py .pio/build/Arduino_Mega --symbols
+
+A static variable that has the same name in two modules is listed under
+"(ambiguous)", and the variables of avr-libc and libgcc under "(other)".
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+
+DEFAULT_NM = "avr-nm"
+PLATFORMIO_NM = os.path.join("~", ".platformio", "packages", "toolchain-atmelavr", "bin", "avr-nm")
+SRAM_BYTES = 8192   # ATmega2560
+DATA_TYPES = "dD"
+BSS_TYPES = "bB"
+
+
+def find_nm(nm):
+    if nm != DEFAULT_NM:
+        return nm
+    bundled = os.path.expanduser(PLATFORMIO_NM)
+    for directory in os.environ.get("PATH", "").split(os.pathsep):
+        if os.path.isfile(os.path.join(directory, nm)):
+            return nm
+    return bundled if os.path.isfile(bundled) else nm
+
+
+def run_nm(nm, path, with_sizes=False):
+    """Yields (size, type, name) for each symbol (size is None without -S)."""
+    command = [nm, "-S", path] if with_sizes else [nm, path]
+    output = subprocess.check_output(command, stderr=subprocess.DEVNULL).decode("ascii", "replace")
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) < 2 or line.endswith(":"):   # archives list each member as "name.o:"
+            continue
+        size = int(fields[1], 16) if with_sizes and len(fields) == 4 else None
+        yield size, fields[-2], fields[-1]
+
+
+def module_name(build_dir, path):
+    """The library's folder (or archive) name, src/<file> for the sketch's own files."""
+    relative = os.path.relpath(path, build_dir)
+    parts = relative.split(os.sep)
+    stem = parts[-1].split(".")[0]   # PlatformIO names the objects main.cpp.o
+    if parts[0] == "src":
+        return "src/" + stem
+    if path.endswith(".a"):
+        return stem[3:] if stem.startswith("lib") else stem
+    if "FrameworkArduino" in parts:
+        return "FrameworkArduino"
+    return parts[-2] if len(parts) > 1 else stem
+
+
+def find_owners(nm, build_dir):
+    """Maps each variable's name to the module that defines it."""
+    owners = {}
+    for root, directories, files in os.walk(build_dir):
+        directories.sort()
+        for name in sorted(files):
+            if not name.endswith((".o", ".a")):
+                continue
+            path = os.path.join(root, name)
+            module = module_name(build_dir, path)
+            for _, symbol_type, symbol in run_nm(nm, path):
+                if symbol_type not in DATA_TYPES + BSS_TYPES:
+                    continue
+                owners[symbol] = module if owners.get(symbol, module) == module else "(ambiguous)"
+    return owners
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("build_dir", help="for example .pio/build/Custom_Board")
+    parser.add_argument("--nm", default=DEFAULT_NM, help="avr-nm (the one from PlatformIO's toolchain is used if it isn't on the path)")
+    parser.add_argument("--symbols", action="store_true", help="also list each variable")
+    arguments = parser.parse_args()
+
+    elf = os.path.join(arguments.build_dir, "firmware.elf")
+    if not os.path.isfile(elf):
+        sys.stderr.write("%s not found, build the environment first\n" % elf)
+        return 1
+    nm = find_nm(arguments.nm)
+    owners = find_owners(nm, arguments.build_dir)
+
+    modules = {}   # module -> [data bytes, bss bytes, [(size, name)]]
+    for size, symbol_type, symbol in run_nm(nm, elf, with_sizes=True):
+        if size is None or symbol_type not in DATA_TYPES + BSS_TYPES:
+            continue
+        totals = modules.setdefault(owners.get(symbol, "(other)"), [0, 0, []])
+        totals[0 if symbol_type in DATA_TYPES else 1] += size
+        totals[2].append((size, symbol))
+
+    print("%-24s %7s %7s %7s" % ("module", ".data", ".bss", "total"))
+    for module, (data, bss, symbols) in sorted(modules.items(), key=lambda item: -(item[1][0] + item[1][1])):
+        print("%-24s %7d %7d %7d" % (module, data, bss, data + bss))
+        if arguments.symbols:
+            for size, symbol in sorted(symbols, reverse=True):
+                print("    %-20s %7d" % (symbol, size))
+    data = sum(totals[0] for totals in modules.values())
+    bss = sum(totals[1] for totals in modules.values())
+    print("%-24s %7d %7d %7d  (%d%% of %d bytes)" % ("total", data, bss, data + bss, 100 * (data + bss) // SRAM_BYTES, SRAM_BYTES))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
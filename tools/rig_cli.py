@@ -0,0 +1,105 @@
+"""Sends commands to a board built with -D REMOTE_CONTROL (see
+lib/RemoteControl/RemoteControl.h) and prints the replies.
+
+With a command, it's sent once and the reply is printed (the exit code is 1 if
+the reply is an error, 2 if no reply came):
+    python tools/rig_cli.py /dev/ttyUSB0 start 2 17
+    python tools/rig_cli.py /dev/ttyUSB0 status 1
+    python tools/rig_cli.py /dev/ttyUSB0 profile   # prints the "profile" lines too (see Profiler.h)
+    python tools/rig_cli.py /dev/ttyUSB0 flight    # and the "flight" lines (see FlightRecorder.h)
+    python tools/rig_cli.py /dev/ttyUSB0 memory    # and the "memory" line (see MemoryMonitor.h)
+Without one, the commands are read from stdin, one per line:
+    python tools/rig_cli.py /dev/ttyUSB0
+
+If the board is also built with -D TELEMETRY, the binary frames on the same
+port are skipped (use telemetry_decode.py on a capture to read them). The
+board resets when the port is opened (the Arduino bootloader), so the first
+command can take a couple of seconds to be answered.
+"""
+
+import argparse
+import os
+import re
+import select
+import sys
+import time
+
+from serial_port import open_serial
+
+DEFAULT_BAUD = 115200   # REMOTE_BAUD
+REPLY = re.compile(rb"^(ok|err|status)\b")
+DUMP = re.compile(rb"^(profile|flight|memory)\b")   # sent before the reply to the profile, flight and memory commands
+REPLY_TIMEOUT = 3.0     # seconds, covers the bootloader's delay after the port is opened
+
+
+class Rig(object):
+    def __init__(self, fd):
+        self.fd = fd
+        self.pending = bytearray()
+
+    def read_reply(self, timeout):
+        """Returns the next reply line (without the newline), or None."""
+        deadline = time.time() + timeout
+        while True:
+            end = self.pending.find(b"\n")
+            while end >= 0:
+                line = bytes(self.pending[:end])
+                del self.pending[:end + 1]
+                line = line[line.rfind(b"\0") + 1:].rstrip(b"\r")   # telemetry frames end with a 0 byte, the reply follows the last one
+                if REPLY.match(line):
+                    return line.decode("ascii", "replace")
+                if DUMP.match(line):
+                    print(line.decode("ascii", "replace"))
+                end = self.pending.find(b"\n")
+            remaining = deadline - time.time()
+            if remaining <= 0:
+                return None
+            readable, _, _ = select.select([self.fd], [], [], remaining)
+            if readable:
+                data = os.read(self.fd, 256)
+                if not data:
+                    return None
+                self.pending += data
+
+    def send(self, command, timeout=REPLY_TIMEOUT):
+        os.write(self.fd, command.strip().encode("ascii") + b"\n")
+        return self.read_reply(timeout)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("port")
+    parser.add_argument("command", nargs="*")
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD)
+    parser.add_argument("--timeout", type=float, default=REPLY_TIMEOUT)
+    arguments = parser.parse_args()
+
+    rig = Rig(open_serial(arguments.port, arguments.baud, writable=True))
+    if arguments.command:
+        reply = rig.send(" ".join(arguments.command), arguments.timeout)
+        if reply is None:
+            sys.stderr.write("no reply\n")
+            return 2
+        print(reply)
+        return 1 if reply.startswith("err") else 0
+
+    interactive = sys.stdin.isatty()
+    while True:
+        if interactive:
+            sys.stdout.write("> ")
+            sys.stdout.flush()
+        line = sys.stdin.readline()
+        if not line:
+            return 0
+        if not line.strip():
+            continue
+        reply = rig.send(line, arguments.timeout)
+        print(reply if reply is not None else "(no reply)")
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    try:
+        sys.exit(main())
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,268 @@
+"""Answers the remote control commands (see lib/RemoteControl/RemoteControl.h)
+on a pty, the way the board does, so rig_cli.py (or other scripts) can be
+tried without a rig. It's a model of the protocol, not of the firmware: the
+attempts just count up over time, and the lock opens at a random attempt.
+
+    python tools/rig_simulator.py                 # prints the pty to connect to
+    python tools/rig_cli.py /dev/pts/5 start 1
+
+The "event" lines of the headless build (see HeadlessDisplay.h) are sent too.
+With --telemetry, attempt-start frames (see lib/Telemetry/Telemetry.h) are
+sent between the replies, as on a board built with both flags.
+
+With --lost-steps, the dials lose steps now and then, and channel 0 has an
+index sensor (-D INDEX_SENSOR -D PRINT_INDEX_DRIFT, see StepperControl.h): it
+homes when the run starts, and the drift is corrected each time the dial is
+reset. A lock only opens if its dial is close enough to the combination, so
+the other channels (and drifts too large to be corrected) can miss it.
+
+    python tools/rig_simulator.py --channels 2 --lost-steps 0.05
+"""
+
+import argparse
+import os
+import pty
+import random
+import select
+import struct
+import sys
+import time
+
+from serial_port import set_raw
+from telemetry_decode import CRC_INIT, crc_ccitt_update
+
+LINE_SIZE = 32            # REMOTE_LINE_SIZE
+REPLY_SIZE = 62           # REMOTE_REPLY_SIZE
+NUMBER_OF_LOCK_PROFILES = 4
+MAX_LOCK_ID = 99
+SERVO_BOTTOM_LIMIT = 160
+SERVO_TOP_LIMIT = 80
+DISTANCE_BETWEEN_TOP_AND_BOTTOM_POSITIONS = 40
+NUMBER_OF_STEPS = 200
+MAX_INDEX_DRIFT_STEPS = 20
+ATTEMPTS_PER_DIAL_RESET = 10   # the third position rolls over every 10 zones (1000 planned attempts)
+OPENING_TOLERANCE_STEPS = 7    # SEARCH_PASS_TOLERANCE positions
+
+
+class IndexSensor(object):
+    """Dead reckoning of a channel's dial, and the corrections of the index
+    sensor (StepperControl::homeToIndex() and correctDrift())."""
+
+    def __init__(self, has_sensor, lost_step_chance):
+        self.has_sensor = has_sensor
+        self.lost_step_chance = lost_step_chance
+        self.drift = 0   # the dead-reckoned step minus the dial's step
+        self.corrected_total = 0
+
+    def home(self):
+        """Without a sensor, the dial is assumed to be at zero (and it is)."""
+        self.drift = 0
+
+    def dial(self):
+        """One attempt, each direction change can lose a step."""
+        for direction in (1, -1, 1):
+            if random.random() < self.lost_step_chance:
+                self.drift += direction
+
+    def reset_dial(self):
+        """rotateClockwiseTwice(), returns the line that is printed if the
+        drift is corrected when the flag passes the sensor."""
+        if not self.has_sensor or self.drift == 0 or abs(self.drift) > MAX_INDEX_DRIFT_STEPS:
+            return None
+        drift = self.drift
+        self.drift = 0
+        self.corrected_total += abs(drift)
+        return "index drift (steps): %d, corrected in total: %d" % (drift, self.corrected_total)
+
+    def is_on_combination(self):
+        return abs(self.drift) <= OPENING_TOLERANCE_STEPS
+
+
+class Channel(object):
+    def __init__(self, index_sensor):
+        self.state = "running"
+        self.attempts = 0
+        self.planned = 1000
+        self.opens_at = random.randint(1, self.planned)
+        self.combination = (-1, -1, -1)
+        self.index_sensor = index_sensor
+        self.index_sensor.home()
+
+
+class SimulatedRig(object):
+    def __init__(self, channels, attempts_per_second, telemetry, lost_step_chance):
+        self.channel_count = channels
+        self.lost_step_chance = lost_step_chance
+        self.seconds_per_attempt = 1.0 / attempts_per_second
+        self.telemetry = telemetry
+        self.running = False
+        self.paused = False
+        self.channels = []
+        self.next_attempt_time = 0
+        self.sequence = 0
+        self.start_time = 0
+        self.events = []   # the lines that a headless build prints (see HeadlessDisplay.h)
+
+    def is_running(self):
+        """Same as isRunning() in main.cpp: a lock is still being opened."""
+        return self.running and any(channel.state == "running" for channel in self.channels)
+
+    def step(self, now):
+        """Makes the attempts that are due, returns the telemetry bytes."""
+        frames = b""
+        if not self.running or self.paused:
+            self.next_attempt_time = now + self.seconds_per_attempt
+            return frames
+        while now >= self.next_attempt_time:
+            self.next_attempt_time += self.seconds_per_attempt
+            for number, channel in enumerate(self.channels):
+                if channel.state != "running":
+                    continue
+                channel.combination = tuple(random.randrange(40) for _ in range(3))
+                if self.telemetry:
+                    frames += self.frame(number, struct.pack("<HbbbB", channel.attempts, *(channel.combination + (0,))))
+                if channel.attempts % ATTEMPTS_PER_DIAL_RESET == 0:
+                    line = channel.index_sensor.reset_dial()
+                    if line is not None:
+                        self.events.append(line)
+                channel.index_sensor.dial()
+                channel.attempts += 1
+                if channel.attempts == channel.opens_at and channel.index_sensor.is_on_combination():
+                    self.open(number)
+                elif channel.attempts >= channel.planned:
+                    channel.state = "failed"
+                    self.events.append("event failed ch=%d" % number)
+        return frames
+
+    def open(self, number):
+        channel = self.channels[number]
+        channel.state = "opened"
+        self.events.append("event opened ch=%d attempts=%d combination=%d-%d-%d time=%d" % (
+            (number, channel.attempts) + channel.combination + (time.time() - self.start_time,)))
+
+    def frame(self, channel, fields):
+        payload = struct.pack("<BBBI", self.sequence, 1, channel, int(time.time() * 1e6) & 0xFFFFFFFF) + fields
+        self.sequence = (self.sequence + 1) & 0xFF
+        crc = CRC_INIT
+        for byte in payload:
+            crc = crc_ccitt_update(crc, byte)
+        payload += struct.pack("<H", crc)
+        encoded = bytearray()
+        for block in payload.split(b"\0"):   # COBS, the payload is shorter than 254 bytes
+            encoded.append(len(block) + 1)
+            encoded += block
+        return bytes(encoded) + b"\0"
+
+    def handle(self, line):
+        if len(line) >= LINE_SIZE:
+            return "err line too long"
+        words = line.split()
+        if not words:
+            return None
+        commands = ("start", "stop", "pause", "resume", "seek", "zone", "servo", "status", "profile", "flight", "memory")
+        if words[0] not in commands:
+            return "err unknown command"
+        try:
+            numbers = [int(word) for word in words[1:]]
+        except ValueError:
+            return "err bad argument"
+        if len(numbers) > 2:
+            return "err bad argument"
+        first = numbers[0] if len(numbers) > 0 else 0
+        second = numbers[1] if len(numbers) > 1 else 0
+        command = words[0]
+
+        if command == "start":
+            if self.is_running():
+                return "err busy"
+            if not (0 <= first <= NUMBER_OF_LOCK_PROFILES and 0 <= second <= MAX_LOCK_ID):
+                return "err bad argument"
+            self.channels = [Channel(IndexSensor(number == 0, self.lost_step_chance)) for number in range(self.channel_count)]
+            self.running = True
+            self.paused = False
+            self.start_time = time.time()
+            self.events.append("event running")
+            return "ok"
+        if command == "stop":
+            self.running = False
+            self.paused = False
+            self.events.append("event idle")
+            return "ok"
+        if command in ("pause", "resume"):
+            if not self.is_running():
+                return "err not running"
+            self.paused = (command == "pause")
+            return "ok"
+        if command == "seek":
+            if not self.is_running():
+                return "err not running"
+            if (not numbers or not 0 <= second < self.channel_count or self.channels[second].state != "running"
+                    or not self.channels[second].attempts < first <= self.channels[second].planned):
+                return "err bad argument"
+            channel = self.channels[second]
+            channel.attempts = first - 1
+            if channel.attempts >= channel.opens_at:
+                self.open(second)   # the skipped combinations aren't dialed, so the drift doesn't matter
+            return "ok"
+        if command == "profile":
+            return "err profiler not enabled"   # same as a board built without -D PROFILER_ENABLED
+        if command == "flight":
+            return "err flight recorder not enabled"   # or -D FLIGHT_RECORDER
+        if command == "memory":
+            return "err memory monitor not enabled"   # or -D MEMORY_MONITOR
+        if command in ("zone", "servo"):
+            if self.is_running():
+                return "err busy"
+            valid = (0 <= first <= 5) if command == "zone" else \
+                (first <= SERVO_BOTTOM_LIMIT and first - DISTANCE_BETWEEN_TOP_AND_BOTTOM_POSITIONS >= SERVO_TOP_LIMIT)
+            return "ok" if numbers and valid else "err bad argument"
+        if not 0 <= first < self.channel_count:
+            return "err bad argument"
+        if not self.running:
+            return "status ch=%d idle attempts=0/0 combination=-1--1--1" % first
+        channel = self.channels[first]
+        state = "paused" if self.paused and channel.state == "running" else channel.state
+        return "status ch=%d %s attempts=%d/%d combination=%d-%d-%d" % (
+            (first, state, channel.attempts, channel.planned) + channel.combination)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--channels", type=int, default=1)
+    parser.add_argument("--rate", type=float, default=5.0, help="attempts per second")
+    parser.add_argument("--telemetry", action="store_true")
+    parser.add_argument("--lost-steps", type=float, default=0.0, help="chance that a direction change loses a step")
+    arguments = parser.parse_args()
+
+    master, slave = pty.openpty()
+    set_raw(slave)
+    print(os.ttyname(slave))
+    sys.stdout.flush()
+
+    rig = SimulatedRig(arguments.channels, arguments.rate, arguments.telemetry, arguments.lost_steps)
+    pending = bytearray()
+    while True:
+        readable, _, _ = select.select([master], [], [], 0.05)
+        output = rig.step(time.time())
+        if readable:
+            pending += os.read(master, 256)
+            end = pending.find(b"\n")
+            while end >= 0:
+                line = pending[:end].decode("ascii", "replace").replace("\r", "")
+                del pending[:end + 1]
+                reply = rig.handle(line)
+                if reply is not None:
+                    output += reply[:REPLY_SIZE].encode("ascii") + b"\n"
+                end = pending.find(b"\n")
+        for event in rig.events:
+            output += event.encode("ascii") + b"\n"
+        del rig.events[:]
+        if output:
+            os.write(master, output)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
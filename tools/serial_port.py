@@ -0,0 +1,33 @@
+"""Helpers shared by the tools that talk to the board over its serial port
+(telemetry_decode.py, rig_cli.py, rig_simulator.py).
+"""
+
+import os
+
+
+def set_raw(fd, baud=None):
+    """Puts a tty in raw mode: 8 data bits, no echo, no line buffering and
+    no translation of the bytes, so binary frames get through unchanged.
+    Does nothing if fd isn't a tty (a capture file, a pipe)."""
+    if not os.isatty(fd):
+        return
+    import termios
+    attributes = termios.tcgetattr(fd)
+    attributes[0] = 0                                    # iflag: no input processing
+    attributes[1] = 0                                    # oflag: no output processing ("\n" stays "\n")
+    attributes[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+    attributes[3] = 0                                    # lflag: raw (no echo, no line buffering)
+    if baud is not None:
+        speed = getattr(termios, "B%d" % baud)
+        attributes[4] = speed
+        attributes[5] = speed
+    attributes[6][termios.VMIN] = 1
+    attributes[6][termios.VTIME] = 0
+    termios.tcsetattr(fd, termios.TCSANOW, attributes)
+
+
+def open_serial(path, baud, writable=False):
+    """Opens a serial device, a pty or a file, and returns its descriptor."""
+    fd = os.open(path, (os.O_RDWR if writable else os.O_RDONLY) | os.O_NOCTTY)
+    set_raw(fd, baud)
+    return fd
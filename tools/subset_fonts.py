@@ -0,0 +1,272 @@
+"""Subsets the Adafruit GFX fonts used by the display to the characters the UI
+actually prints, and writes them to SubsetFonts.h with the same names as the
+library fonts (FreeSans9pt7b, FreeSans12pt7b, ...), so Display.cpp only has to
+include SubsetFonts.h instead of the Fonts/*.h headers.
+
+The characters are collected from the string table in lib/Display/UiStrings.h,
+where each string is listed with the font it's drawn in, and from the string
+literals and print() calls left in lib/Display/*.cpp:
+  - each tft.setFont(&<font>) found in the sources adds <font> to the output
+  - a literal belongs to the font set before it in the same function, or to the
+    font a called helper sets itself (drawStandardBlueButton(), ...)
+  - a literal that isn't printed right away (a sprintf() format) belongs to
+    the fonts set after it in the function, if there are any
+  - if no font can be found, the literal belongs to every font
+  - numeric conversions (%d, %02u, ...) and print() calls with a variable
+    add the digits, '-', '.' and ':' (see TextFormat.h)
+  - literals that never reach the display (Serial, F() strings passed to
+    helpers without tft calls) are skipped
+
+The glyph table still covers every character from the lowest to the highest
+one used, so the GFX library indexes it directly (character - first). Glyphs
+that aren't used keep their x advance but no bitmap, so an unexpected
+character prints as a space. Add -D FULL_FONTS to the build flags to go back
+to the library fonts.
+
+Used as a PlatformIO pre-script (extra_scripts = pre:tools/subset_fonts.py).
+The flash used by each font before and after subsetting is printed when building.
+
+Can also be run by hand:
+    python tools/subset_fonts.py path/to/Fonts path/to/SubsetFonts.h path/to/UiStrings.h source.cpp [source.cpp ...]
+"""
+
+import glob
+import os
+import re
+import sys
+
+try:
+    Import("env")   # noqa: F821 (provided by PlatformIO/SCons)
+except NameError:
+    env = None
+
+# SCons runs this file with exec(), so __file__ isn't defined there
+sys.path.insert(0, os.path.join(env.subst("$PROJECT_DIR"), "tools") if env is not None else os.path.dirname(os.path.abspath(__file__)))
+from gfxfont import find_font, parse_font, parse_string_table, write_if_changed  # noqa: E402
+
+OUTPUT_NAME = "SubsetFonts.h"
+SOURCE_PATTERNS = ["lib/Display/*.cpp"]
+STRING_TABLE = "lib/Display/UiStrings.h"
+NUMBER_CHARS = set("0123456789-.:")
+PRINT_CALLS = ("print", "println")
+ALL_FONTS = None   # stands for "every font", resolved once all the fonts are known
+
+LITERAL = r'"(?:[^"\\\n]|\\.)*"'
+COMMENT_OR_LITERAL = re.compile(r"//[^\n]*|/\*.*?\*/|" + LITERAL + r"|'(?:[^'\\\n]|\\.)*'", re.S)
+FORMAT_SPEC = re.compile(r"%[-+ 0#]*\d*(?:\.\d+)?(?:hh|h|ll|l)?([diouxXcsfeEgG%])")
+FUNCTION_HEAD = re.compile(r"^[A-Za-z_][\w\s\*&<>:]*?\b\w+::(\w+)\s*\(([^;{}]*)\)\s*(?:const\s*)?\{", re.M)
+SET_FONT = re.compile(r"setFont\s*\(\s*&\s*(\w+)\s*\)")
+
+
+def strip_comments(text):
+    """Blanks out comments and preprocessor lines, keeping string literals and line lengths."""
+    def blank(match):
+        token = match.group(0)
+        return token if token[0] in "\"'" else re.sub(r"[^\n]", " ", token)
+    text = COMMENT_OR_LITERAL.sub(blank, text)
+    return re.sub(r"^[ \t]*#[^\n]*", lambda m: " " * len(m.group(0)), text, flags=re.M)
+
+
+def unescape(literal):
+    return bytes(literal[1:-1], "utf-8").decode("unicode_escape")
+
+
+def split_functions(text):
+    """Returns {name: (start, end, parameter names)} for each member function body."""
+    functions = {}
+    for head in FUNCTION_HEAD.finditer(text):
+        depth = 0
+        for i in range(head.end() - 1, len(text)):
+            if text[i] == "{":
+                depth += 1
+            elif text[i] == "}":
+                depth -= 1
+                if depth == 0:
+                    break
+        parameters = set(re.findall(r"(\w+)\s*(?:\[\s*\])?\s*(?:=[^,]*)?(?:,|$)", head.group(2)))
+        functions[head.group(1)] = (head.end(), i, parameters)
+    return functions
+
+
+def enclosing_call(text, start, position):
+    """Returns (object, function) for the innermost call around position (skipping F()), or (None, None)."""
+    depth = 0
+    for i in range(position - 1, start - 1, -1):
+        c = text[i]
+        if c == ")":
+            depth += 1
+        elif c == "(":
+            if depth == 0:
+                name = re.search(r"(?:(\w+)\s*(?:\.|->)\s*)?(\w+)\s*$", text[start:i])
+                if name and name.group(2) == "F":
+                    return enclosing_call(text, start, name.start(2) + start)
+                return (name.group(1), name.group(2)) if name else (None, None)
+            depth -= 1
+        elif c in ";{}" and depth == 0:
+            break
+    return None, None
+
+
+def table_chars(path):
+    """Returns {font name: set of characters} for the strings in the string table."""
+    used = {}
+    for _, font, text in parse_string_table(path):
+        used.setdefault(font, set()).update(text)
+    return used
+
+
+def literal_chars(literal):
+    """Characters a literal can put on the screen, with the format conversions replaced by what they print."""
+    chars = set()
+    text = unescape(literal)
+    for spec in FORMAT_SPEC.finditer(text):
+        if spec.group(1) == "%":
+            chars.add("%")
+        elif spec.group(1) not in "cs":
+            chars |= NUMBER_CHARS
+    chars |= set(FORMAT_SPEC.sub("", text))
+    return chars
+
+
+def collect_chars(sources, string_table):
+    """Returns {font name: set of characters} for every font in the string table or set in the sources."""
+    used = table_chars(string_table) if string_table else {}
+
+    def add(fonts, chars):
+        for font in (ALL_FONTS,) if fonts is ALL_FONTS else fonts:
+            used.setdefault(font, set()).update(chars)
+
+    for path in sources:
+        with open(path) as f:
+            text = strip_comments(f.read())
+        functions = split_functions(text)
+        own_fonts = {name: set(SET_FONT.findall(text[start:end])) for name, (start, end, _) in functions.items()}
+        draws = {name: "tft." in text[start:end] for name, (start, end, _) in functions.items()}
+        for font in SET_FONT.findall(text):
+            used.setdefault(font, set())
+
+        for name, (start, end, parameters) in list(functions.items()) + [(None, (0, len(text), None))]:
+            if name is None:
+                # file scope: literals outside every function (tables of labels, ...)
+                inside = [range(s, e) for s, e, _ in functions.values()]
+                literals = [m for m in re.finditer(LITERAL, text) if not any(m.start() in r for r in inside)]
+                for m in literals:
+                    add(ALL_FONTS, literal_chars(m.group(0)))
+                continue
+
+            body = text[start:end]
+            font_changes = [(m.start() + start, m.group(1)) for m in SET_FONT.finditer(body)]
+
+            def current_font(position):
+                fonts = [font for at, font in font_changes if at < position]
+                return {fonts[-1]} if fonts else ALL_FONTS
+
+            def later_fonts(position):
+                return {font for at, font in font_changes if at > position}
+
+            for m in re.finditer(LITERAL, body):
+                position = start + m.start()
+                obj, callee = enclosing_call(text, start, position)
+                if obj == "Serial" or (callee in functions and not draws[callee]):
+                    continue
+                if callee in functions and own_fonts[callee]:
+                    fonts = own_fonts[callee]
+                elif callee in PRINT_CALLS or callee in functions:
+                    fonts = current_font(position)
+                else:
+                    fonts = later_fonts(position) or current_font(position)   # probably formatted into a buffer that is printed further down
+                add(fonts, literal_chars(m.group(0)))
+
+            # numbers and buffers printed at runtime (text passed in as a parameter is covered at the call site)
+            for m in re.finditer(r"(?:(\w+)\s*(?:\.|->)\s*)?(\w+)\s*\(\s*(?!\s*\")([^)]*)\)", body):
+                obj, callee, argument = m.groups()
+                if obj == "Serial" or not argument.strip() or parameters & set(re.findall(r"\w+", argument.split(",")[0])):
+                    continue
+                if callee in PRINT_CALLS or (callee in functions and draws[callee] and "Text" in callee):
+                    add(current_font(start + m.start()), NUMBER_CHARS)
+
+    everything = used.pop(ALL_FONTS, set())
+    for chars in used.values():
+        chars |= everything
+    return used
+
+
+def subset(font, chars):
+    """Returns a copy of font with only the glyphs for chars (the glyph table still covers first..last)."""
+    codes = sorted(ord(c) for c in chars if font.first <= ord(c) <= font.last)
+    first, last = codes[0], codes[-1]
+    bitmaps = []
+    glyphs = []
+    for code in range(first, last + 1):
+        glyph = font.glyphs[code - font.first]
+        if code in codes:
+            size = font.glyph_bytes(glyph)
+            glyphs.append((len(bitmaps),) + glyph[1:])
+            bitmaps += font.bitmaps[glyph[0]:glyph[0] + size]
+        else:
+            glyphs.append((0, 0, 0, glyph[3], 0, 0))
+    return type(font)(font.name, bitmaps, glyphs, first, last, font.y_advance), codes
+
+
+def format_font(font, codes, original):
+    lines = [
+        "//%s: %d of %d glyphs kept, %d bytes instead of %d" % (font.name, len(codes), len(original.glyphs), font.flash_size(), original.flash_size()),
+        "const uint8_t %sBitmaps[] PROGMEM = {" % font.name,
+    ]
+    for i in range(0, len(font.bitmaps), 16):
+        lines.append("    " + ", ".join("0x%02X" % b for b in font.bitmaps[i:i + 16]) + ",")
+    lines += ["};", "", "const GFXglyph %sGlyphs[] PROGMEM = {" % font.name]
+    for code, glyph in zip(range(font.first, font.last + 1), font.glyphs):
+        comment = "0x%02X '%s'" % (code, chr(code)) if code in codes else "0x%02X (not used)" % code
+        lines.append("    { %5d, %3d, %3d, %3d, %4d, %4d },   // %s" % (glyph + (comment,)))
+    lines += [
+        "};",
+        "",
+        "const GFXfont %s PROGMEM = {" % font.name,
+        "    (uint8_t  *)%sBitmaps," % font.name,
+        "    (GFXglyph *)%sGlyphs," % font.name,
+        "    0x%02X, 0x%02X, %d };" % (font.first, font.last, font.y_advance),
+        "",
+    ]
+    return lines
+
+
+def generate(font_paths, sources, string_table, output_path):
+    used = collect_chars(sources, string_table)
+    lines = [
+        "//Generated by tools/subset_fonts.py from the UI strings in %s. Do not edit." % ", ".join([STRING_TABLE] + SOURCE_PATTERNS),
+        "",
+        "#ifndef SUBSET_FONTS_H",
+        "#define SUBSET_FONTS_H",
+        "",
+        "#include <Adafruit_GFX.h>",
+        "",
+    ]
+    before = after = 0
+    for name in sorted(used):
+        original = parse_font(font_paths(name))
+        font, codes = subset(original, used[name])
+        lines += format_font(font, codes, original)
+        before += original.flash_size()
+        after += font.flash_size()
+        print("%s: %d of %d glyphs, %d -> %d bytes of flash" % (name, len(codes), len(original.glyphs), original.flash_size(), font.flash_size()))
+    lines += ["#endif", ""]
+    print("Subset fonts: %d -> %d bytes of flash (%d saved)" % (before, after, before - after))
+
+    if write_if_changed(output_path, "\n".join(lines)):
+        print("Generated %s" % output_path)
+
+
+if env is not None:
+    if "FULL_FONTS" not in env.subst("$BUILD_FLAGS"):
+        project_dir = env.subst("$PROJECT_DIR")
+        libdeps_dir = env.subst("$PROJECT_LIBDEPS_DIR/$PIOENV")
+        sources = sorted(p for pattern in SOURCE_PATTERNS for p in glob.glob(os.path.join(project_dir, pattern)))
+        generated_dir = os.path.join(env.subst("$BUILD_DIR"), "generated")
+        generate(lambda name: find_font(libdeps_dir, name), sources, os.path.join(project_dir, STRING_TABLE), os.path.join(generated_dir, OUTPUT_NAME))
+        env.Append(CPPPATH=[generated_dir])
+elif __name__ == "__main__":
+    if len(sys.argv) < 5:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    generate(lambda name: os.path.join(sys.argv[1], name + ".h"), sys.argv[4:], sys.argv[3], sys.argv[2])
@@ -0,0 +1,144 @@
+"""Decodes the binary telemetry frames that the board sends over the serial
+port when it's built with -D TELEMETRY (see lib/Telemetry/Telemetry.h), and
+prints one line per frame.
+
+Each frame is COBS encoded and ends with a 0 byte. Decoded, it is:
+    sequence (1 byte), type (1), channel (1), timestamp (4, micros()),
+    fields (depending on the type), CRC (2)
+Numbers are little endian. The CRC is avr-libc's _crc_ccitt_update() over
+everything before it, starting at 0xFFFF. Frames with a bad CRC (for example
+text printed by the PRINT_* flags) are skipped, and a gap in the sequence
+numbers means that frames were dropped on the board (its buffer was full).
+
+The input can be a serial device, a pty (for example one end of
+socat -d -d pty,raw,echo=0 pty,raw,echo=0), a capture file, or - for stdin:
+    python tools/telemetry_decode.py /dev/ttyUSB0
+    python tools/telemetry_decode.py /dev/pts/3 115200
+    python tools/telemetry_decode.py capture.bin
+"""
+
+import os
+import struct
+import sys
+
+from serial_port import open_serial
+
+DEFAULT_BAUD = 115200   # TELEMETRY_BAUD
+CRC_INIT = 0xFFFF       # TELEMETRY_CRC_INIT
+HEADER = struct.Struct("<BBBI")
+MAX_ENCODED_FRAME = 20  # TELEMETRY_MAX_PAYLOAD + the COBS code byte, with some room
+
+ATTEMPT_KINDS = {0: "search", 1: "fast-open", 2: "refinement-probe"}   # TelemetryAttemptKind
+ALGORITHM_STATES = {0: "running", 1: "error", 2: "complete"}          # AlgorithmState
+LIMIT_SWITCH_STATES = {0: "released", 1: "activated"}
+
+# type: (name, field layout, formatter), same order as TelemetryFrame
+FRAME_TYPES = {
+    1: ("attempt-start", struct.Struct("<HbbbB"),
+        lambda f: "attempt=%d combination=%s-%s-%s kind=%s" % (
+            f[0], position(f[1]), position(f[2]), position(f[3]), ATTEMPT_KINDS.get(f[4], f[4]))),
+    2: ("dialed", struct.Struct("<HI"),
+        lambda f: "steps=%d travel_us=%d" % f),
+    3: ("attempt-end", struct.Struct("<IB"),
+        lambda f: "dwell_us=%d opened=%s" % (f[0], "yes" if f[1] else "no")),
+    4: ("limit-switch", struct.Struct("<B"),
+        lambda f: "state=%s" % LIMIT_SWITCH_STATES.get(f[0], f[0])),
+    5: ("run-end", struct.Struct("<BH"),
+        lambda f: "state=%s attempts=%d" % (ALGORITHM_STATES.get(f[0], f[0]), f[1])),
+}
+
+
+def position(value):
+    return "--" if value < 0 else "%02d" % value   # NO_POSITION_ASSIGNED is -1
+
+
+def crc_ccitt_update(crc, data):
+    """Same as _crc_ccitt_update() in avr-libc's util/crc16.h."""
+    data ^= crc & 0xFF
+    data = (data ^ (data << 4)) & 0xFF
+    return (((data << 8) | (crc >> 8)) ^ (data >> 4) ^ (data << 3)) & 0xFFFF
+
+
+def cobs_decode(encoded):
+    decoded = bytearray()
+    i = 0
+    while i < len(encoded):
+        code = encoded[i]
+        if code == 0 or i + code > len(encoded):
+            return None
+        decoded += encoded[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(encoded):
+            decoded.append(0)
+    return bytes(decoded)
+
+
+def decode_frame(encoded):
+    """Returns (sequence, text), or None if the frame isn't valid."""
+    payload = cobs_decode(encoded)
+    if payload is None or len(payload) < HEADER.size + 2:
+        return None
+    crc = CRC_INIT
+    for byte in payload[:-2]:
+        crc = crc_ccitt_update(crc, byte)
+    if crc != struct.unpack_from("<H", payload, len(payload) - 2)[0]:
+        return None
+    sequence, frame_type, channel, timestamp = HEADER.unpack_from(payload)
+    fields = payload[HEADER.size:-2]
+    if frame_type not in FRAME_TYPES:
+        return sequence, "%10d ch%d type=%d %s" % (timestamp, channel, frame_type, fields.hex())
+    name, layout, formatter = FRAME_TYPES[frame_type]
+    if len(fields) != layout.size:
+        return None
+    return sequence, "%10d ch%d %-16s %s" % (timestamp, channel, name, formatter(layout.unpack(fields)))
+
+
+def open_input(path, baud):
+    if path == "-":
+        return sys.stdin.buffer.fileno()
+    return open_serial(path, baud)
+
+
+def run(fd, output=sys.stdout):
+    pending = bytearray()
+    expected_sequence = None
+    bad_frames = 0
+    while True:
+        data = os.read(fd, 256)
+        if not data:
+            break
+        pending += data
+        while True:
+            end = pending.find(0)
+            if end < 0:
+                break
+            encoded = bytes(pending[:end])
+            del pending[:end + 1]
+            if not encoded:
+                continue
+            frame = decode_frame(encoded)
+            start = max(1, len(encoded) - MAX_ENCODED_FRAME)
+            while frame is None and start < len(encoded):   # text (or noise) right before a frame ends up in the same segment
+                frame = decode_frame(encoded[start:])
+                start += 1
+            if frame is None:
+                bad_frames += 1
+                continue
+            sequence, text = frame
+            if expected_sequence is not None and sequence != expected_sequence:
+                output.write("(%d frames dropped)\n" % ((sequence - expected_sequence) & 0xFF))
+            expected_sequence = (sequence + 1) & 0xFF
+            output.write(text + "\n")
+            output.flush()
+    if bad_frames:
+        output.write("(%d frames skipped, bad CRC or length)\n" % bad_frames)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    try:
+        run(open_input(sys.argv[1], int(sys.argv[2]) if len(sys.argv) == 3 else DEFAULT_BAUD))
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,69 @@
+"""Measures every string of the string table (lib/Display/UiStrings.h) in the
+font it's drawn in, and writes the sizes to UiStringMetrics.h, so the display
+can center labels without calling tft.getTextBounds() (which walks the glyph
+table for every character) each time a button or title is drawn.
+
+The width and height are the same as the w and h that getTextBounds() returns
+(Adafruit GFX 1.5.3, text size 1). Build with -D CHECK_TEXT_METRICS to compare
+them with getTextBounds() on the board.
+
+Used as a PlatformIO pre-script (extra_scripts = pre:tools/text_metrics.py).
+UiStringMetrics.h is written to <build dir>/generated, which is added to the
+include path.
+
+Can also be run by hand:
+    python tools/text_metrics.py path/to/Fonts path/to/UiStrings.h path/to/UiStringMetrics.h
+"""
+
+import os
+import sys
+
+try:
+    Import("env")   # noqa: F821 (provided by PlatformIO/SCons)
+except NameError:
+    env = None
+
+# SCons runs this file with exec(), so __file__ isn't defined there
+sys.path.insert(0, os.path.join(env.subst("$PROJECT_DIR"), "tools") if env is not None else os.path.dirname(os.path.abspath(__file__)))
+from gfxfont import find_font, parse_font, parse_string_table, text_bounds, write_if_changed  # noqa: E402
+
+OUTPUT_NAME = "UiStringMetrics.h"
+STRING_TABLE = "lib/Display/UiStrings.h"
+SCREEN_WIDTH = 320   # the display is used in landscape (tft.setRotation(1))
+
+
+def generate(font_paths, string_table, output_path):
+    fonts = {}
+    lines = [
+        "//Generated by tools/text_metrics.py from %s. Do not edit." % STRING_TABLE,
+        "",
+        "#ifndef UI_STRING_METRICS_H",
+        "#define UI_STRING_METRICS_H",
+        "",
+        "//size of each string's bounding box in its font (the w and h from tft.getTextBounds())",
+    ]
+    for string_id, font_name, text in parse_string_table(string_table):
+        if font_name not in fonts:
+            fonts[font_name] = parse_font(font_paths(font_name))
+        _, _, width, height = text_bounds(fonts[font_name], text)
+        if width > SCREEN_WIDTH:
+            sys.stderr.write("Error: \"%s\" (%s) is %d pixels wide, the display is %d\n" % (text, string_id, width, SCREEN_WIDTH))
+            sys.exit(1)
+        lines.append("#define UI_STRING_WIDTH_%s %d" % (string_id, width))
+        lines.append("#define UI_STRING_HEIGHT_%s %d" % (string_id, height))
+    lines += ["", "#endif", ""]
+
+    if write_if_changed(output_path, "\n".join(lines)):
+        print("Generated %s" % output_path)
+
+
+if env is not None:
+    libdeps_dir = env.subst("$PROJECT_LIBDEPS_DIR/$PIOENV")
+    generated_dir = os.path.join(env.subst("$BUILD_DIR"), "generated")
+    generate(lambda name: find_font(libdeps_dir, name), os.path.join(env.subst("$PROJECT_DIR"), STRING_TABLE), os.path.join(generated_dir, OUTPUT_NAME))
+    env.Append(CPPPATH=[generated_dir])
+elif __name__ == "__main__":
+    if len(sys.argv) != 4:
+        sys.stderr.write(__doc__)
+        sys.exit(2)
+    generate(lambda name: os.path.join(sys.argv[1], name + ".h"), sys.argv[2], sys.argv[3])